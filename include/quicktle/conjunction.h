@@ -0,0 +1,129 @@
+/*-----------------------------------------------------------------------------+
+ | QuickTle                                                                    |
+ | Copyright 2011-2015 Sergei Fundaev                                          |
+ +-----------------------------------------------------------------------------+
+ | This file is part of QuickTle library.                                      |
+ |                                                                             |
+ | QuickTle is free software: you can redistribute it and/or modify            |
+ | it under the terms of the GNU Lesser General Public License as published by |
+ | the Free Software Foundation, either version 3 of the License, or           |
+ | (at your option) any later version.                                         |
+ |                                                                             |
+ | QuickTle is distributed in the hope that it will be useful,                 |
+ | but WITHOUT ANY WARRANTY; without even the implied warranty of              |
+ | MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               |
+ | GNU Lesser General Public License for more details.                         |
+ |                                                                             |
+ | You should have received a copy of the GNU Lesser General Public License    |
+ | along with QuickTle. If not, see <http://www.gnu.org/licenses/>.            |
+ +----------------------------------------------------------------------------*/
+/*!
+    \file conjunction.h
+    \brief File contains the definition of quicktle::ConjunctionScreener class.
+*/
+
+#ifndef TLECONJUNCTION_H
+#define TLECONJUNCTION_H
+
+#include <cstddef>
+#include <vector>
+#include <quicktle/node.h>
+#include <quicktle/propagator.h>
+
+namespace quicktle
+{
+
+/*!
+    \brief Close approach of two objects of the catalog.
+*/
+struct Conjunction
+{
+    std::size_t primary;   //!< Index of the first object
+    std::size_t secondary; //!< Index of the second object (> primary)
+    double tca;            //!< Time of closest approach [s from Jan 1, 1970]
+    double distance;       //!< Miss distance [m]
+    double relativeSpeed;  //!< Relative speed at the closest approach [m/s]
+};
+
+/*!
+    \brief All-vs-all screening of the catalog for close approaches.
+
+    The objects, which perigee-apogee shells (widened by the screening
+    distance) do not overlap with any other shell, are excluded at once;
+    the same test is applied to each candidate pair. The remaining
+    objects are propagated on the uniform time grid, and at each step
+    the positions are hashed into the cubic cells, so only the objects
+    in the neighbouring cells are compared. The time of closest approach
+    is refined for the candidate pairs only, as the root of the range
+    rate. The time interval is split into slices, which are processed
+    in parallel.
+*/
+class ConjunctionScreener
+{
+public:
+    ConjunctionScreener(); //!< Default constructor.
+    /*!
+        \brief Constructor
+        \param catalog - the objects for screening
+    */
+    explicit ConjunctionScreener(const std::vector<Node> &catalog);
+    //! Set the objects for screening
+    void setCatalog(const std::vector<Node> &catalog);
+    //! Get the screening distance [m]
+    double threshold() const;
+    //! Set the screening distance [m]
+    void setThreshold(double threshold);
+    //! Get the step of time grid [s]
+    double step() const;
+    //! Set the step of time grid [s]
+    void setStep(double step);
+    //! Get the time tolerance of the closest approach refinement [s]
+    double tolerance() const;
+    //! Set the time tolerance of the closest approach refinement [s]
+    void setTolerance(double tolerance);
+    //! Get the number of threads (0 - number of available cores)
+    unsigned threads() const;
+    //! Set the number of threads (0 - number of available cores)
+    void setThreads(unsigned threads);
+    /*!
+        \brief Find all approaches closer than the screening distance.
+        \param start - start of the time interval [s from Jan 1, 1970]
+        \param stop - end of the time interval [s from Jan 1, 1970]
+        \return Conjunctions, ordered by miss distance.
+    */
+    std::vector<Conjunction> screen(double start, double stop) const;
+
+private:
+    //! Orbit parameters, used by the screening
+    struct Shell
+    {
+        double perigee;  //!< Perigee radius [m]
+        double apogee;   //!< Apogee radius [m]
+        double maxSpeed; //!< Speed at perigee [m/s]
+    };
+
+    void screenSlice(const std::vector<std::size_t> &objects,
+                     double start, double stop, std::size_t first,
+                     std::size_t last, std::vector<double> &buffer,
+                     std::vector<Conjunction> &result) const;
+    /*!
+        Find the closest approach of the objects on [a, b] as the root of
+        the range rate. Without the root the approach at \a a (\a b) is
+        found only, if \a startEdge (\a stopEdge) marks it as the end
+        of the screening interval.
+    */
+    bool refine(std::size_t primary, std::size_t secondary,
+                double a, double b, bool startEdge, bool stopEdge,
+                Conjunction &conjunction) const;
+
+    std::vector<Propagator> m_propagators;
+    std::vector<Shell> m_shells;
+    double m_threshold;
+    double m_step;
+    double m_tolerance;
+    unsigned m_threads;
+};
+
+} // namespace quicktle
+
+#endif // TLECONJUNCTION_H
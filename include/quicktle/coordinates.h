@@ -0,0 +1,196 @@
+/*-----------------------------------------------------------------------------+
+ | QuickTle                                                                    |
+ | Copyright 2011-2015 Sergei Fundaev                                          |
+ +-----------------------------------------------------------------------------+
+ | This file is part of QuickTle library.                                      |
+ |                                                                             |
+ | QuickTle is free software: you can redistribute it and/or modify            |
+ | it under the terms of the GNU Lesser General Public License as published by |
+ | the Free Software Foundation, either version 3 of the License, or           |
+ | (at your option) any later version.                                         |
+ |                                                                             |
+ | QuickTle is distributed in the hope that it will be useful,                 |
+ | but WITHOUT ANY WARRANTY; without even the implied warranty of              |
+ | MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               |
+ | GNU Lesser General Public License for more details.                         |
+ |                                                                             |
+ | You should have received a copy of the GNU Lesser General Public License    |
+ | along with QuickTle. If not, see <http://www.gnu.org/licenses/>.            |
+ +----------------------------------------------------------------------------*/
+/*!
+    \file coordinates.h
+    \brief File contains the definition of quicktle::EarthRotation class
+           and the functions for batch conversion between the geocentric
+           inertial, Earth-fixed and geodetic coordinates.
+
+    Geodetic coordinates are referred to the WGS-84 ellipsoid. Latitude
+    and longitude are in radians, altitude and Cartesian coordinates are
+    in meters. Time is the number of seconds from Jan 1, 1970 (as in
+    Node::preciseEpoch()); the difference between UTC and UT1 is ignored.
+*/
+
+#ifndef TLECOORDINATES_H
+#define TLECOORDINATES_H
+
+#include <cstddef>
+
+namespace quicktle
+{
+
+/*!
+    \brief Convert the time into Julian date
+    \param t - number of seconds from Jan 1, 1970
+    \return Julian date [days]
+*/
+double julianDate(double t);
+
+/*!
+    \brief Greenwich mean sidereal time (IAU-82 model)
+    \param t - number of seconds from Jan 1, 1970
+    \return Sidereal angle [0, 2 * M_PI) [Radians]
+*/
+double gmst(double t);
+
+/*!
+    \brief Rotation of the Earth at some time moment.
+
+    The sidereal angle and its sine and cosine are computed once in
+    the constructor, so the object may be shared by all the satellites,
+    converted at the same time.
+*/
+class EarthRotation
+{
+public:
+    EarthRotation(); //!< Default constructor: rotation at Jan 1, 1970
+    /*!
+        \brief Constructor
+        \param t - number of seconds from Jan 1, 1970
+    */
+    explicit EarthRotation(double t);
+    //! Compute the rotation at the given time
+    void assign(double t);
+    //! Get the time of rotation - number of seconds from Jan 1, 1970
+    double time() const;
+    //! Get Greenwich mean sidereal time [Radians]
+    double gmst() const;
+    /*!
+        \brief Convert the geocentric inertial coordinates
+               into Earth-fixed ones.
+        \param eci - 3 geocentric inertial coordinates
+        \param ecef - buffer for 3 Earth-fixed coordinates
+    */
+    void eci2ecef(const double *eci, double *ecef) const;
+    /*!
+        \brief Convert the arrays of geocentric inertial coordinates into
+               Earth-fixed ones; input and output arrays may coincide.
+        \param count - number of points
+        \param x, y, z - geocentric inertial coordinates
+        \param xe, ye, ze - buffers for Earth-fixed coordinates
+    */
+    void eci2ecef(std::size_t count,
+                  const double *x, const double *y, const double *z,
+                  double *xe, double *ye, double *ze) const;
+    //! Single precision version of eci2ecef()
+    void eci2ecef(std::size_t count,
+                  const float *x, const float *y, const float *z,
+                  float *xe, float *ye, float *ze) const;
+    /*!
+        \brief Convert the arrays of geocentric inertial coordinates into
+               the geodetic ones.
+        \param count - number of points
+        \param x, y, z - geocentric inertial coordinates
+        \param latitude, longitude, altitude - buffers for the result
+    */
+    void eci2geodetic(std::size_t count,
+                      const double *x, const double *y, const double *z,
+                      double *latitude, double *longitude,
+                      double *altitude) const;
+    //! Single precision version of eci2geodetic()
+    void eci2geodetic(std::size_t count,
+                      const float *x, const float *y, const float *z,
+                      float *latitude, float *longitude,
+                      float *altitude) const;
+
+private:
+    double m_t;
+    double m_gmst;
+    double m_cos;
+    double m_sin;
+};
+
+/*!
+    \brief Convert the geodetic coordinates into Earth-fixed ones
+    \param latitude - geodetic latitude [Radians]
+    \param longitude - longitude [Radians]
+    \param altitude - altitude above the ellipsoid [m]
+    \param ecef - buffer for 3 Earth-fixed coordinates
+*/
+void geodetic2ecef(double latitude, double longitude, double altitude,
+                   double *ecef);
+
+/*!
+    \brief Convert the arrays of Earth-fixed coordinates into geodetic ones.
+           The closed-form Bowring's approximation is refined by the fixed
+           number of iterations, so the error is less than 1 mm for the
+           altitudes up to the geostationary orbit.
+    \param count - number of points
+    \param x, y, z - Earth-fixed coordinates
+    \param latitude, longitude, altitude - buffers for the result
+*/
+void ecef2geodetic(std::size_t count,
+                   const double *x, const double *y, const double *z,
+                   double *latitude, double *longitude, double *altitude);
+
+/*!
+    \brief Single precision version of ecef2geodetic(). The rounding of
+           float limits the error to about 1e-6 rad in the angles and
+           5e-7 of the geocentric distance in the altitude (20 m for
+           the geostationary orbit).
+*/
+void ecef2geodetic(std::size_t count,
+                   const float *x, const float *y, const float *z,
+                   float *latitude, float *longitude, float *altitude);
+
+/*!
+    \brief Convert the geocentric inertial coordinates of one object,
+           sampled on the uniform time grid, into Earth-fixed ones. The
+           sidereal angle is computed once and then advanced by the
+           Earth rotation rate; input and output arrays may coincide.
+    \param start - time of the first sample [s from Jan 1, 1970]
+    \param step - time step [s]
+    \param count - number of samples
+    \param x, y, z - geocentric inertial coordinates
+    \param xe, ye, ze - buffers for Earth-fixed coordinates
+*/
+void eci2ecef(double start, double step, std::size_t count,
+              const double *x, const double *y, const double *z,
+              double *xe, double *ye, double *ze);
+
+//! Single precision version of eci2ecef() on the uniform time grid
+void eci2ecef(double start, double step, std::size_t count,
+              const float *x, const float *y, const float *z,
+              float *xe, float *ye, float *ze);
+
+/*!
+    \brief Convert the geocentric inertial coordinates of one object,
+           sampled on the uniform time grid, into geodetic ones. The
+           sidereal angle is computed once and then advanced by the
+           Earth rotation rate.
+    \param start - time of the first sample [s from Jan 1, 1970]
+    \param step - time step [s]
+    \param count - number of samples
+    \param x, y, z - geocentric inertial coordinates
+    \param latitude, longitude, altitude - buffers for the result
+*/
+void eci2geodetic(double start, double step, std::size_t count,
+                  const double *x, const double *y, const double *z,
+                  double *latitude, double *longitude, double *altitude);
+
+//! Single precision version of eci2geodetic() on the uniform time grid
+void eci2geodetic(double start, double step, std::size_t count,
+                  const float *x, const float *y, const float *z,
+                  float *latitude, float *longitude, float *altitude);
+
+} // namespace quicktle
+
+#endif // TLECOORDINATES_H
@@ -0,0 +1,136 @@
+/*-----------------------------------------------------------------------------+
+ | QuickTle                                                                    |
+ | Copyright 2011-2015 Sergei Fundaev                                          |
+ +-----------------------------------------------------------------------------+
+ | This file is part of QuickTle library.                                      |
+ |                                                                             |
+ | QuickTle is free software: you can redistribute it and/or modify            |
+ | it under the terms of the GNU Lesser General Public License as published by |
+ | the Free Software Foundation, either version 3 of the License, or           |
+ | (at your option) any later version.                                         |
+ |                                                                             |
+ | QuickTle is distributed in the hope that it will be useful,                 |
+ | but WITHOUT ANY WARRANTY; without even the implied warranty of              |
+ | MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               |
+ | GNU Lesser General Public License for more details.                         |
+ |                                                                             |
+ | You should have received a copy of the GNU Lesser General Public License    |
+ | along with QuickTle. If not, see <http://www.gnu.org/licenses/>.            |
+ +----------------------------------------------------------------------------*/
+/*!
+    \file coverage.h
+    \brief File contains the definition of quicktle::CoverageGrid class.
+*/
+
+#ifndef TLECOVERAGE_H
+#define TLECOVERAGE_H
+
+#include <cstddef>
+#include <vector>
+#include <quicktle/node.h>
+#include <quicktle/propagator.h>
+
+namespace quicktle
+{
+
+/*!
+    \brief Coverage of the latitude-longitude grid by the constellation.
+
+    The satellites are propagated on the uniform time grid. At each sample
+    the visibility footprint of each satellite (the spherical cap, where
+    its elevation is above the minimal one; the Earth is a sphere of the
+    mean radius) is rasterized row by row: the longitude span of the cap
+    is computed once per row, so only the covered cells are touched. The
+    grid is split into the bands of rows, which are processed in parallel.
+    The cell is covered, when its center is inside the footprint; each
+    sample accounts for the time step (the last one - for the rest of
+    the interval).
+
+    The cells are stored by rows from the south pole: the cell of the row
+    r and the column c is at index r * columns() + c.
+*/
+class CoverageGrid
+{
+public:
+    CoverageGrid(); //!< Default constructor: 1 degree cells.
+    /*!
+        \brief Constructor
+        \param resolution - size of the cell [Radians]
+    */
+    explicit CoverageGrid(double resolution);
+    //! Get the size of the cell [Radians]
+    double resolution() const;
+    //! Set the size of the cell [Radians]; it is adjusted to fit the globe.
+    void setResolution(double resolution);
+    //! Get the number of rows (latitudes)
+    std::size_t rows() const;
+    //! Get the number of columns (longitudes)
+    std::size_t columns() const;
+    //! Get the latitude of the center of the row [Radians]
+    double latitude(std::size_t row) const;
+    //! Get the longitude of the center of the column [Radians]
+    double longitude(std::size_t column) const;
+    //! Set the satellites
+    void setSatellites(const std::vector<Node> &satellites);
+    //! Get the minimal elevation of visible satellite [Radians]
+    double minElevation() const;
+    //! Set the minimal elevation of visible satellite [Radians]
+    void setMinElevation(double minElevation);
+    //! Get the step of time grid [s]
+    double step() const;
+    //! Set the step of time grid [s]
+    void setStep(double step);
+    //! Get the number of threads (0 - number of available cores)
+    unsigned threads() const;
+    //! Set the number of threads (0 - number of available cores)
+    void setThreads(unsigned threads);
+    /*!
+        \brief Compute the coverage over the time interval
+        \param start - beginning of the interval [s from Jan 1, 1970]
+        \param stop - end of the interval [s from Jan 1, 1970]
+    */
+    void compute(double start, double stop);
+    //! Get the time, when at least one satellite is visible, per cell [s]
+    const double* coverageTime() const;
+    //! Get the time-averaged number of visible satellites per cell
+    const double* meanVisible() const;
+    //! Get the maximal number of simultaneously visible satellites per cell
+    const unsigned* maxVisible() const;
+
+private:
+    //! Visibility footprint of the satellite at one sample
+    struct Footprint
+    {
+        double latitude;    //!< Geocentric latitude of sub-satellite point
+        double longitude;   //!< Longitude of sub-satellite point
+        double radius;      //!< Angular radius of the cap [Radians]
+        int firstRow;       //!< First covered row
+        int lastRow;        //!< Last covered row (< firstRow - none)
+    };
+
+    //! Compute the footprints of the satellite on the block of samples
+    void footprints(double start, std::size_t first, std::size_t count,
+                    std::size_t satellite,
+                    std::vector<Footprint> &result) const;
+    //! Add the footprints of the block of samples to the rows [first, last)
+    void rasterize(const std::vector<Footprint> &footprints,
+                   std::size_t samples, const double *weights,
+                   std::size_t firstRow, std::size_t lastRow,
+                   std::size_t sample, std::vector<std::size_t> &stamps,
+                   std::vector<unsigned> &counts);
+
+    std::vector<Propagator> m_propagators;
+    double m_resolution;
+    std::size_t m_rows;
+    std::size_t m_columns;
+    double m_minElevation;
+    double m_step;
+    unsigned m_threads;
+    std::vector<double> m_coverageTime;
+    std::vector<double> m_meanVisible;
+    std::vector<unsigned> m_maxVisible;
+};
+
+} // namespace quicktle
+
+#endif // TLECOVERAGE_H
@@ -25,8 +25,10 @@
 #ifndef TLEDATASET_H
 #define TLEDATASET_H
 
+#include <cstddef>
 #include <vector>
 #include <quicktle/node.h>
+#include <quicktle/propagator.h>
 
 namespace quicktle
 {
@@ -35,6 +37,19 @@ class DataSet
 {
 public:
     typedef std::vector<Node>::size_type IndexType;
+
+    //! Method of the state computation between the node epochs
+    enum Interpolation
+    {
+        NearestNode = 0, //!< Orbit of the node with the nearest epoch
+        /*!
+            Orbits of two neighbouring nodes, blended with the cubic
+            Hermite weight, so the position and velocity are continuous
+        */
+        HermiteBlend
+    };
+
+    DataSet(); //!< Default constructor.
     /*!
         \brief Append new node to data set
         \param node - TLE-node
@@ -70,11 +85,95 @@ public:
         \return Copy of the nearest node
     */
     const Node& nearestNode(const time_t &t) const;
+    //! Get the method of the state computation between the node epochs
+    Interpolation interpolation() const;
+    //! Set the method of the state computation between the node epochs
+    void setInterpolation(Interpolation interpolation);
+    /*!
+        \brief Orbits of the nodes, used by the last query of a caller.
+               The consecutive queries through one cursor, governed by
+               the same nodes, cost only one (two for the blending) Kepler
+               equation solve. A cursor is used by one thread at a time;
+               it is reset by the query, when the data set has been
+               changed since the last one.
+    */
+    class Cursor
+    {
+    public:
+        Cursor(); //!< Default constructor.
+
+    private:
+        friend class DataSet;
+
+        unsigned long long m_revision;  //!< revision of the data set
+
+        // Propagator of the last used node and the time interval,
+        // where this node is the nearest one
+        Propagator m_propagator;
+        bool m_propagatorValid;
+        double m_governedBegin;
+        double m_governedEnd;
+
+        // Propagators of the nodes around the last used time in
+        // DataSet::HermiteBlend mode
+        Propagator m_left;
+        Propagator m_right;
+        bool m_bracketValid;
+        IndexType m_bracket;   //!< Index of the left node
+    };
+
+    /*!
+        \brief Compute the geocentric position and velocity at the given
+               time by the orbit of the node with the nearest epoch or,
+               in DataSet::HermiteBlend mode, by the blended orbits of
+               the nodes before and after \a t.
+        \param t - number of seconds from Jan 1, 1970
+        \param position - buffer of 3 values for X, Y, Z coordinates [m]
+        \param velocity - buffer of 3 values for X, Y, Z coordinates of
+                          velocity [m/s]; may be null.
+        \return False if the data set is empty.
+    */
+    bool stateAt(double t, double *position, double *velocity = 0) const;
+    /*!
+        \brief Compute the state at the given time, reusing the orbits
+               of the previous query through the cursor.
+        \see DataSet::stateAt()
+        \param cursor - cursor of the caller
+        \param t - number of seconds from Jan 1, 1970
+        \param position - buffer of 3 values for X, Y, Z coordinates [m]
+        \param velocity - buffer of 3 values for X, Y, Z coordinates of
+                          velocity [m/s]; may be null.
+        \return False if the data set is empty.
+    */
+    bool stateAt(Cursor &cursor, double t, double *position,
+                 double *velocity = 0) const;
+    /*!
+        \brief Compute the states at the given times.
+        \see DataSet::stateAt()
+        \param count - number of times
+        \param times - times [s from Jan 1, 1970]; the sorted times are
+                       processed faster
+        \param positions - buffer of 3 * count values: X, Y, Z of the time k
+                           are at positions[3 * k]
+        \param velocities - buffer of velocities in the same layout;
+                            may be null.
+        \return False if the data set is empty.
+    */
+    bool statesAt(std::size_t count, const double *times,
+                  double *positions, double *velocities = 0) const;
 
 private:
     IndexType nearestNotLess(const time_t &t, bool &found) const;
+    IndexType nearestIndex(double t) const;
+    const Propagator& propagatorAt(Cursor &cursor, double t) const;
+    void blendedState(Cursor &cursor, double t, double *position,
+                      double *velocity) const;
+    //! Mark the data set as changed
+    void touch();
 
 	std::vector<Node> m_data;
+    Interpolation m_interpolation;
+    unsigned long long m_revision;  //!< unique for each content of m_data
 };
 
 } // namespace quicktle
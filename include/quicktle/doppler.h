@@ -0,0 +1,99 @@
+/*-----------------------------------------------------------------------------+
+ | QuickTle                                                                    |
+ | Copyright 2011-2015 Sergei Fundaev                                          |
+ +-----------------------------------------------------------------------------+
+ | This file is part of QuickTle library.                                      |
+ |                                                                             |
+ | QuickTle is free software: you can redistribute it and/or modify            |
+ | it under the terms of the GNU Lesser General Public License as published by |
+ | the Free Software Foundation, either version 3 of the License, or           |
+ | (at your option) any later version.                                         |
+ |                                                                             |
+ | QuickTle is distributed in the hope that it will be useful,                 |
+ | but WITHOUT ANY WARRANTY; without even the implied warranty of              |
+ | MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               |
+ | GNU Lesser General Public License for more details.                         |
+ |                                                                             |
+ | You should have received a copy of the GNU Lesser General Public License    |
+ | along with QuickTle. If not, see <http://www.gnu.org/licenses/>.            |
+ +----------------------------------------------------------------------------*/
+/*!
+    \file doppler.h
+    \brief File contains the functions for the range-rate and Doppler
+           profiles of the satellites over the ground stations.
+*/
+
+#ifndef TLEDOPPLER_H
+#define TLEDOPPLER_H
+
+#include <cstddef>
+#include <vector>
+#include <quicktle/node.h>
+#include <quicktle/station.h>
+#include <quicktle/passes.h>
+#include <quicktle/threadpool.h>
+
+namespace quicktle
+{
+
+/*!
+    \brief Compute the range and range rate of the satellite from the
+           station on the uniform time grid. The positions and velocities
+           are propagated together in blocks, and the sidereal angle is
+           advanced by the Earth rotation rate from the first sample.
+    \param station - ground station
+    \param satellite - satellite
+    \param start - time of the first sample [s from Jan 1, 1970]
+    \param step - time step [s]
+    \param count - number of samples
+    \param range - buffer for \a count ranges [m]; may be null
+    \param rangeRate - buffer for \a count range rates [m/s]; positive,
+                       when the satellite recedes
+*/
+void rangeRateProfile(const Station &station, const Node &satellite,
+                      double start, double step, std::size_t count,
+                      double *range, double *rangeRate);
+
+/*!
+    \brief Convert the range rates into the Doppler shifts of the frequency
+           (first order approximation); input and output may coincide.
+    \param count - number of values
+    \param rangeRate - range rates [m/s]
+    \param frequency - transmitted frequency [Hz]
+    \param shift - buffer for \a count shifts [Hz]
+*/
+void dopplerShift(std::size_t count, const double *rangeRate,
+                  double frequency, double *shift);
+
+/*!
+    \brief Compute the positions of the pass profiles in the common buffer.
+           The profile of the pass is sampled at rise, rise + step, ...,
+           up to the set time.
+    \param passes - passes
+    \param step - time step [s]
+    \param offsets - output: index of the first sample of each pass
+    \return Total number of samples.
+*/
+std::size_t passProfileOffsets(const std::vector<Pass> &passes, double step,
+                               std::vector<std::size_t> &offsets);
+
+/*!
+    \brief Compute the range and range-rate profiles of the passes in
+           parallel.
+    \param stations - ground stations, referenced by the passes
+    \param satellites - satellites, referenced by the passes
+    \param passes - passes
+    \param step - time step [s]
+    \param range - buffer for the ranges of all passes [m], laid out
+                   by passProfileOffsets(); may be null
+    \param rangeRate - buffer for the range rates of all passes [m/s]
+    \param threads - number of threads (0 - number of available cores)
+*/
+void passProfiles(const std::vector<Station> &stations,
+                  const std::vector<Node> &satellites,
+                  const std::vector<Pass> &passes, double step,
+                  double *range, double *rangeRate, unsigned threads = 0);
+
+} // namespace quicktle
+
+#endif // TLEDOPPLER_H
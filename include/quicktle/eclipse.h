@@ -0,0 +1,157 @@
+/*-----------------------------------------------------------------------------+
+ | QuickTle                                                                    |
+ | Copyright 2011-2015 Sergei Fundaev                                          |
+ +-----------------------------------------------------------------------------+
+ | This file is part of QuickTle library.                                      |
+ |                                                                             |
+ | QuickTle is free software: you can redistribute it and/or modify            |
+ | it under the terms of the GNU Lesser General Public License as published by |
+ | the Free Software Foundation, either version 3 of the License, or           |
+ | (at your option) any later version.                                         |
+ |                                                                             |
+ | QuickTle is distributed in the hope that it will be useful,                 |
+ | but WITHOUT ANY WARRANTY; without even the implied warranty of              |
+ | MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               |
+ | GNU Lesser General Public License for more details.                         |
+ |                                                                             |
+ | You should have received a copy of the GNU Lesser General Public License    |
+ | along with QuickTle. If not, see <http://www.gnu.org/licenses/>.            |
+ +----------------------------------------------------------------------------*/
+/*!
+    \file eclipse.h
+    \brief File contains the solar ephemeris, the shadow tests and the
+           definition of quicktle::EclipsePredictor class.
+*/
+
+#ifndef TLEECLIPSE_H
+#define TLEECLIPSE_H
+
+#include <cstddef>
+#include <vector>
+#include <quicktle/node.h>
+#include <quicktle/propagator.h>
+
+namespace quicktle
+{
+
+//! Illumination of the satellite
+enum Shadow
+{
+    Sunlight = 0, //!< The Sun is not obscured
+    Penumbra,     //!< The Sun is partially obscured by the Earth
+    Umbra         //!< The Sun is totally obscured by the Earth
+};
+
+//! Model of the Earth shadow
+enum ShadowModel
+{
+    CylindricalShadow = 0, //!< Cylinder of the Earth radius, no penumbra
+    ConicalShadow          //!< Umbra and penumbra cones
+};
+
+/*!
+    \brief Compute the geocentric position of the Sun by the low precision
+           analytic theory (the error is about 0.01 degree for the years
+           1950-2050).
+    \param t - number of seconds from Jan 1, 1970
+    \param position - buffer of 3 geocentric inertial coordinates [m]
+*/
+void sunPosition(double t, double *position);
+
+/*!
+    \brief Determine the illumination of the satellite
+    \param position - 3 geocentric inertial coordinates of the satellite [m]
+    \param sun - 3 geocentric inertial coordinates of the Sun [m]
+    \param model - shadow model
+*/
+Shadow shadow(const double *position, const double *sun,
+              ShadowModel model = ConicalShadow);
+
+/*!
+    \brief Compute the beta angles (the elevations of the Sun over the
+           orbit planes) of the satellites.
+    \param catalog - satellites
+    \param t - number of seconds from Jan 1, 1970
+    \param beta - buffer for catalog.size() angles [-M_PI_2, M_PI_2]
+                  [Radians]
+*/
+void betaAngles(const std::vector<Node> &catalog, double t, double *beta);
+
+/*!
+    \brief Passage of the satellite through the Earth shadow.
+*/
+struct Eclipse
+{
+    std::size_t satellite; //!< Index of the satellite
+    double penumbraEntry;  //!< Time of entry into the penumbra
+    double umbraEntry;     //!< Time of entry into the umbra (if umbra)
+    double umbraExit;      //!< Time of exit from the umbra (if umbra)
+    double penumbraExit;   //!< Time of exit from the penumbra
+    bool umbra;            //!< Whether the satellite enters the umbra
+};
+
+/*!
+    \brief Predictor of the eclipses of the satellites.
+
+    The positions of the Sun are computed once on the uniform time grid
+    and shared by all the satellites. Each satellite is propagated on
+    the grid; the shadow boundaries between the samples of different
+    illumination are refined by bisection of the continuous shadow
+    functions. The eclipses, shorter than the step, may be missed.
+    Satellites are processed in parallel.
+
+    All times are the numbers of seconds from Jan 1, 1970. The eclipses
+    in progress at the beginning or at the end of the time interval are
+    truncated by it. In the cylindrical model the penumbra times are
+    equal to the umbra ones.
+*/
+class EclipsePredictor
+{
+public:
+    EclipsePredictor(); //!< Default constructor.
+    /*!
+        \brief Constructor
+        \param satellites - satellites
+    */
+    explicit EclipsePredictor(const std::vector<Node> &satellites);
+    //! Set the satellites
+    void setSatellites(const std::vector<Node> &satellites);
+    //! Get the shadow model
+    ShadowModel model() const;
+    //! Set the shadow model
+    void setModel(ShadowModel model);
+    //! Get the step of time grid [s]
+    double step() const;
+    //! Set the step of time grid [s]
+    void setStep(double step);
+    //! Get the time tolerance of the boundary refinement [s]
+    double tolerance() const;
+    //! Set the time tolerance of the boundary refinement [s]
+    void setTolerance(double tolerance);
+    //! Get the number of threads (0 - number of available cores)
+    unsigned threads() const;
+    //! Set the number of threads (0 - number of available cores)
+    void setThreads(unsigned threads);
+    /*!
+        \brief Find the eclipses within the time interval
+        \param start - beginning of the interval
+        \param stop - end of the interval
+        \return Eclipses, ordered by satellite, then by time.
+    */
+    std::vector<Eclipse> predict(double start, double stop) const;
+
+private:
+    void predictSatellite(std::size_t satellite, double start, double stop,
+                          const std::vector<double> &sun,
+                          std::vector<Eclipse> &result) const;
+
+    std::vector<Propagator> m_propagators;
+    ShadowModel m_model;
+    double m_step;
+    double m_tolerance;
+    unsigned m_threads;
+};
+
+} // namespace quicktle
+
+#endif // TLEECLIPSE_H
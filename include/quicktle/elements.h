@@ -0,0 +1,81 @@
+/*-----------------------------------------------------------------------------+
+ | QuickTle                                                                    |
+ | Copyright 2011-2015 Sergei Fundaev                                          |
+ +-----------------------------------------------------------------------------+
+ | This file is part of QuickTle library.                                      |
+ |                                                                             |
+ | QuickTle is free software: you can redistribute it and/or modify            |
+ | it under the terms of the GNU Lesser General Public License as published by |
+ | the Free Software Foundation, either version 3 of the License, or           |
+ | (at your option) any later version.                                         |
+ |                                                                             |
+ | QuickTle is distributed in the hope that it will be useful,                 |
+ | but WITHOUT ANY WARRANTY; without even the implied warranty of              |
+ | MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               |
+ | GNU Lesser General Public License for more details.                         |
+ |                                                                             |
+ | You should have received a copy of the GNU Lesser General Public License    |
+ | along with QuickTle. If not, see <http://www.gnu.org/licenses/>.            |
+ +----------------------------------------------------------------------------*/
+/*!
+    \file elements.h
+    \brief File contains the functions for conversion of the state vectors
+           into the orbital elements.
+
+    The elements are the ones of quicktle::Node: mean motion [radians per
+    second], eccentricity, inclination, right ascension of the ascending
+    node, argument of perigee and mean anomaly [Radians]. For the
+    equatorial orbits the ascending node is placed on X axis, for the
+    circular ones the perigee is placed at the ascending node. The
+    non-elliptic states (parabolic and hyperbolic) give zero mean motion.
+*/
+
+#ifndef TLEELEMENTS_H
+#define TLEELEMENTS_H
+
+#include <cstddef>
+#include <quicktle/node.h>
+
+namespace quicktle
+{
+
+/*!
+    \brief Convert the geocentric state vectors into the orbital elements.
+    \param count - number of states
+    \param positions - 3 * count coordinates [m]: X, Y, Z of the state k
+                       are at positions[3 * k]
+    \param velocities - 3 * count coordinates of velocity [m/s] in the same
+                        layout
+    \param n, e, i, Omega, omega, M - buffers of count values for the
+                                      elements; any of them may be null
+*/
+void rv2coe(std::size_t count,
+            const double *positions, const double *velocities,
+            double *n, double *e, double *i,
+            double *Omega, double *omega, double *M);
+
+/*!
+    \brief Set the orbital elements and epoch of the node by the state vector.
+    \param t - time of the state - number of seconds from Jan 1, 1970
+    \param position - 3 coordinates [m]
+    \param velocity - 3 coordinates of velocity [m/s]
+    \param node - the node to fill; other fields are not changed
+*/
+void rv2coe(double t, const double *position, const double *velocity,
+            Node &node);
+
+/*!
+    \brief Set the orbital elements and epochs of the nodes by the state
+           vectors.
+    \param count - number of states
+    \param times - times of the states [s from Jan 1, 1970]
+    \param positions - 3 * count coordinates [m]
+    \param velocities - 3 * count coordinates of velocity [m/s]
+    \param nodes - array of count nodes to fill
+*/
+void rv2coe(std::size_t count, const double *times,
+            const double *positions, const double *velocities, Node *nodes);
+
+} // namespace quicktle
+
+#endif // TLEELEMENTS_H
@@ -0,0 +1,155 @@
+/*-----------------------------------------------------------------------------+
+ | QuickTle                                                                    |
+ | Copyright 2011-2015 Sergei Fundaev                                          |
+ +-----------------------------------------------------------------------------+
+ | This file is part of QuickTle library.                                      |
+ |                                                                             |
+ | QuickTle is free software: you can redistribute it and/or modify            |
+ | it under the terms of the GNU Lesser General Public License as published by |
+ | the Free Software Foundation, either version 3 of the License, or           |
+ | (at your option) any later version.                                         |
+ |                                                                             |
+ | QuickTle is distributed in the hope that it will be useful,                 |
+ | but WITHOUT ANY WARRANTY; without even the implied warranty of              |
+ | MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               |
+ | GNU Lesser General Public License for more details.                         |
+ |                                                                             |
+ | You should have received a copy of the GNU Lesser General Public License    |
+ | along with QuickTle. If not, see <http://www.gnu.org/licenses/>.            |
+ +----------------------------------------------------------------------------*/
+/*!
+    \file ephemeriscache.h
+    \brief File contains the definition of quicktle::EphemerisCache class.
+*/
+
+#ifndef TLEEPHEMERISCACHE_H
+#define TLEEPHEMERISCACHE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include <quicktle/node.h>
+#include <quicktle/propagator.h>
+
+namespace quicktle
+{
+
+/*!
+    \brief Cache of the piecewise Chebyshev approximation of the orbits.
+
+    The time axis of each satellite is split into the segments of equal
+    length. On the first query inside a segment the orbit is propagated
+    at the Chebyshev nodes of the segment and the polynomial coefficients
+    are fitted; the next queries inside the segment cost only the
+    evaluation of the polynomials. The segment length of each satellite
+    is first chosen so that the fit around the perigee (usually the worst
+    case) is within the tolerance. When the fit of a segment is still out
+    of the tolerance, the segment length of the satellite is halved, its
+    segments are removed and the segment is fitted again. The least
+    recently used segments are evicted, when the memory budget is
+    exceeded.
+
+    The queries modify the cache, so an object should not be shared by
+    several threads without synchronization.
+*/
+class EphemerisCache
+{
+public:
+    EphemerisCache(); //!< Default constructor.
+    /*!
+        \brief Constructor
+        \param catalog - satellites
+    */
+    explicit EphemerisCache(const std::vector<Node> &catalog);
+    //! Set the satellites; the cached segments are removed.
+    void setCatalog(const std::vector<Node> &catalog);
+    //! Get the number of satellites
+    std::size_t size() const;
+    //! Get the position tolerance of the fit [m]
+    double tolerance() const;
+    //! Set the position tolerance of the fit [m]; the cache is cleared.
+    void setTolerance(double tolerance);
+    //! Get the memory budget [bytes]
+    std::size_t memoryBudget() const;
+    //! Set the memory budget [bytes]; the excess segments are evicted.
+    void setMemoryBudget(std::size_t bytes);
+    //! Get the memory, used by the cached segments [bytes]
+    std::size_t memoryUsage() const;
+    //! Get the number of the cached segments
+    std::size_t segments() const;
+    //! Get the length of the segments of the given satellite [s]
+    double segmentLength(std::size_t satellite) const;
+    //! Remove all cached segments.
+    void clear();
+    /*!
+        \brief Compute the geocentric position and velocity of the satellite
+        \param satellite - index of the satellite in the catalog
+        \param t - number of seconds from Jan 1, 1970
+        \param position - buffer of 3 values for X, Y, Z coordinates [m]
+        \param velocity - buffer of 3 values for X, Y, Z coordinates of
+                          velocity [m/s]; may be null. The velocity is the
+                          derivative of the fit, so its relative error is
+                          larger than the one of the position.
+        \return Error bound of the position [m]: maximal deviation of
+                the fit from the propagated orbit, measured at the points
+                between the Chebyshev nodes of the segment and at its
+                ends, plus the magnitude of the two last coefficients,
+                which bounds the deviation between these points. It is not
+                above the tolerance, unless the segment length has reached
+                its lower limit.
+    */
+    double state(std::size_t satellite, double t,
+                 double *position, double *velocity = 0);
+
+private:
+    EphemerisCache(const EphemerisCache&);            //!< Copying is unavailable.
+    EphemerisCache& operator=(const EphemerisCache&); //!< Copying is unavailable.
+
+    struct Satellite
+    {
+        Propagator propagator;
+        double period;
+        double span;     //!< Length of the segments
+        int halvings;    //!< Number of halvings of the span
+    };
+    //! Number of Chebyshev coefficients per coordinate
+    enum { Order = 12 };
+    struct Segment
+    {
+        std::size_t satellite;
+        long long index;    //!< Number of the segment from the node epoch
+        double middle;      //!< Time of the segment middle
+        double scale;       //!< 2 / segment length
+        double error;       //!< Error bound of the position
+        double coefficients[3][Order];
+    };
+    typedef std::list<Segment> Segments;
+    //! Satellite and number of the segment
+    typedef std::pair<std::size_t, long long> SegmentKey;
+    struct SegmentHash
+    {
+        std::size_t operator()(const SegmentKey &key) const;
+    };
+
+    double fit(const Satellite &satellite, double start, Segment &segment) const;
+    //! Find or fit the segment of the satellite, which contains t
+    Segments::iterator segmentAt(std::size_t satellite, double t);
+    //! Remove the cached segments of the satellite
+    void removeSegments(std::size_t satellite);
+    void chooseSpans();
+    void evict(std::size_t bytes);
+
+    std::vector<Satellite> m_satellites;
+    Segments m_segments;        //!< The most recently used are at the front
+    std::unordered_map<SegmentKey, Segments::iterator, SegmentHash> m_index;
+    std::vector<Segments::iterator> m_last; //!< Last used segment of satellite
+    double m_tolerance;
+    std::size_t m_memoryBudget;
+};
+
+} // namespace quicktle
+
+#endif // TLEEPHEMERISCACHE_H
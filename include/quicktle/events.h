@@ -0,0 +1,144 @@
+/*-----------------------------------------------------------------------------+
+ | QuickTle                                                                    |
+ | Copyright 2011-2015 Sergei Fundaev                                          |
+ +-----------------------------------------------------------------------------+
+ | This file is part of QuickTle library.                                      |
+ |                                                                             |
+ | QuickTle is free software: you can redistribute it and/or modify            |
+ | it under the terms of the GNU Lesser General Public License as published by |
+ | the Free Software Foundation, either version 3 of the License, or           |
+ | (at your option) any later version.                                         |
+ |                                                                             |
+ | QuickTle is distributed in the hope that it will be useful,                 |
+ | but WITHOUT ANY WARRANTY; without even the implied warranty of              |
+ | MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               |
+ | GNU Lesser General Public License for more details.                         |
+ |                                                                             |
+ | You should have received a copy of the GNU Lesser General Public License    |
+ | along with QuickTle. If not, see <http://www.gnu.org/licenses/>.            |
+ +----------------------------------------------------------------------------*/
+/*!
+    \file events.h
+    \brief File contains the definition of quicktle::EventFinder class.
+*/
+
+#ifndef TLEEVENTS_H
+#define TLEEVENTS_H
+
+#include <cstddef>
+#include <vector>
+#include <quicktle/node.h>
+#include <quicktle/propagator.h>
+
+namespace quicktle
+{
+
+//! Type of the orbital event
+enum OrbitEventType
+{
+    AscendingNode = 0,  //!< Crossing of the equator to the north
+    DescendingNode,     //!< Crossing of the equator to the south
+    Perigee,            //!< Passage of the perigee
+    Apogee,             //!< Passage of the apogee
+    NorthwardLatitude,  //!< Crossing of the given latitude to the north
+    SouthwardLatitude   //!< Crossing of the given latitude to the south
+};
+
+/*!
+    \brief Orbital event of the satellite.
+*/
+struct OrbitEvent
+{
+    std::size_t satellite; //!< Index of the satellite
+    OrbitEventType type;   //!< Type of the event
+    double t;              //!< Time of the event
+    double latitude;       //!< Crossed latitude (0 for the apsides)
+};
+
+/*!
+    \brief Finder of the node crossings, apsides passages and latitude
+           crossings of the satellites.
+
+    The events are not searched on the time grid. The time of each event
+    is predicted from the elements: the target argument of latitude is
+    converted into the true, eccentric and mean anomalies, and the mean
+    anomaly into the time. The prediction is refined by Newton's method
+    on the propagated state (z for the nodes, z / r for the latitudes),
+    so in quicktle::J2Secular mode the drift of the perigee during the
+    revolution is accounted for; in the two-body mode the prediction is
+    exact and one step confirms it. The apsides are at the constant mean
+    anomalies and need no refinement. Satellites are processed in
+    parallel.
+
+    The latitudes are geocentric. All times are the numbers of seconds
+    from Jan 1, 1970.
+*/
+class EventFinder
+{
+public:
+    EventFinder(); //!< Default constructor.
+    /*!
+        \brief Constructor
+        \param satellites - satellites
+    */
+    explicit EventFinder(const std::vector<Node> &satellites);
+    //! Set the satellites
+    void setSatellites(const std::vector<Node> &satellites);
+    //! Get the force model of the propagation
+    OrbitModel orbitModel() const;
+    //! Set the force model of the propagation
+    void setOrbitModel(OrbitModel model);
+    //! Check whether the node crossings are found
+    bool nodeCrossings() const;
+    //! Set whether the node crossings are found
+    void setNodeCrossings(bool enabled);
+    //! Check whether the apsides passages are found
+    bool apsides() const;
+    //! Set whether the apsides passages are found
+    void setApsides(bool enabled);
+    //! Get the latitudes, which crossings are found [Radians]
+    const std::vector<double>& latitudes() const;
+    //! Set the latitudes, which crossings are found [Radians]
+    void setLatitudes(const std::vector<double> &latitudes);
+    //! Get the time tolerance of the refinement [s]
+    double tolerance() const;
+    //! Set the time tolerance of the refinement [s]
+    void setTolerance(double tolerance);
+    //! Get the number of threads (0 - number of available cores)
+    unsigned threads() const;
+    //! Set the number of threads (0 - number of available cores)
+    void setThreads(unsigned threads);
+    /*!
+        \brief Find the events within the time interval
+        \param start - beginning of the interval
+        \param stop - end of the interval
+        \return Events, ordered by satellite, then by time.
+    */
+    std::vector<OrbitEvent> find(double start, double stop) const;
+
+private:
+    //! Elements of the orbit, which define the event anomalies
+    struct Orbit
+    {
+        double e;
+        double omega;  //!< Argument of perigee at the epoch
+        double sini;
+        double epoch;
+    };
+
+    void findSatellite(std::size_t satellite, double start, double stop,
+                       std::vector<OrbitEvent> &result) const;
+
+    std::vector<Propagator> m_propagators;
+    std::vector<Orbit> m_orbits;
+    std::vector<double> m_latitudes;
+    OrbitModel m_model;
+    double m_tolerance;
+    unsigned m_threads;
+    bool m_nodeCrossings;
+    bool m_apsides;
+};
+
+} // namespace quicktle
+
+#endif // TLEEVENTS_H
@@ -0,0 +1,114 @@
+/*-----------------------------------------------------------------------------+
+ | QuickTle                                                                    |
+ | Copyright 2011-2015 Sergei Fundaev                                          |
+ +-----------------------------------------------------------------------------+
+ | This file is part of QuickTle library.                                      |
+ |                                                                             |
+ | QuickTle is free software: you can redistribute it and/or modify            |
+ | it under the terms of the GNU Lesser General Public License as published by |
+ | the Free Software Foundation, either version 3 of the License, or           |
+ | (at your option) any later version.                                         |
+ |                                                                             |
+ | QuickTle is distributed in the hope that it will be useful,                 |
+ | but WITHOUT ANY WARRANTY; without even the implied warranty of              |
+ | MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               |
+ | GNU Lesser General Public License for more details.                         |
+ |                                                                             |
+ | You should have received a copy of the GNU Lesser General Public License    |
+ | along with QuickTle. If not, see <http://www.gnu.org/licenses/>.            |
+ +----------------------------------------------------------------------------*/
+/*!
+    \file fastmath.h
+    \brief File contains the approximate elementary functions of the fast
+           math tier, used by the propagation kernels in quicktle::FastMath
+           mode.
+
+    The functions use the range reduction and the truncated series instead
+    of the library calls. The maximal absolute errors for double arguments
+    (checked by the tests) are 2e-9 for fastSin(), fastCos() and
+    fastSinCos() with |x| < 1e4.
+    For the orbit radius of 7000 km they give the position error of several
+    centimeters. For float arguments the error is limited by the rounding of
+    float itself.
+*/
+
+#ifndef TLEFASTMATH_H
+#define TLEFASTMATH_H
+
+#include <cmath>
+
+namespace quicktle
+{
+
+//! Accuracy of the elementary functions in the propagation kernels
+enum MathMode
+{
+    AccurateMath = 0,  //!< Functions of the standard library
+    FastMath           //!< Polynomial approximations of fastmath.h
+};
+
+/*!
+    \brief Compute sine and cosine with one range reduction.
+    \param x - angle [Radians]
+    \param sine, cosine - buffers for the result
+*/
+template <typename Real>
+inline void fastSinCos(Real x, Real &sine, Real &cosine)
+{
+    // x = q * pi / 2 + r, |r| <= pi / 4; pi / 2 is split into two parts,
+    // so the reduction is exact for the moderate q
+    const double PIO2_HI = 1.5707963267341256;
+    const double PIO2_LO = 6.077100506506192e-11;
+    double q = std::floor(x * (2 / M_PI) + 0.5);
+    double r = (x - q * PIO2_HI) - q * PIO2_LO;
+    double r2 = r * r;
+
+    // Taylor series up to r^9 and r^10: the truncation error is less than
+    // 2e-9 and 7e-11 for |r| <= pi / 4
+    double s = r * (1 + r2 * (-1. / 6 + r2 * (1. / 120 + r2 * (-1. / 5040
+                    + r2 * (1. / 362880)))));
+    double c = 1 + r2 * (-0.5 + r2 * (1. / 24 + r2 * (-1. / 720
+                    + r2 * (1. / 40320 + r2 * (-1. / 3628800)))));
+
+    switch (static_cast<long>(q) & 3)
+    {
+    case 0:
+        sine = static_cast<Real>(s);
+        cosine = static_cast<Real>(c);
+        break;
+    case 1:
+        sine = static_cast<Real>(c);
+        cosine = static_cast<Real>(-s);
+        break;
+    case 2:
+        sine = static_cast<Real>(-s);
+        cosine = static_cast<Real>(-c);
+        break;
+    default:
+        sine = static_cast<Real>(-c);
+        cosine = static_cast<Real>(s);
+        break;
+    }
+}
+
+//! Approximate sine
+template <typename Real>
+inline Real fastSin(Real x)
+{
+    Real s, c;
+    fastSinCos(x, s, c);
+    return s;
+}
+
+//! Approximate cosine
+template <typename Real>
+inline Real fastCos(Real x)
+{
+    Real s, c;
+    fastSinCos(x, s, c);
+    return c;
+}
+
+} // namespace quicktle
+
+#endif // TLEFASTMATH_H
@@ -0,0 +1,171 @@
+/*-----------------------------------------------------------------------------+
+ | QuickTle                                                                    |
+ | Copyright 2011-2015 Sergei Fundaev                                          |
+ +-----------------------------------------------------------------------------+
+ | This file is part of QuickTle library.                                      |
+ |                                                                             |
+ | QuickTle is free software: you can redistribute it and/or modify            |
+ | it under the terms of the GNU Lesser General Public License as published by |
+ | the Free Software Foundation, either version 3 of the License, or           |
+ | (at your option) any later version.                                         |
+ |                                                                             |
+ | QuickTle is distributed in the hope that it will be useful,                 |
+ | but WITHOUT ANY WARRANTY; without even the implied warranty of              |
+ | MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               |
+ | GNU Lesser General Public License for more details.                         |
+ |                                                                             |
+ | You should have received a copy of the GNU Lesser General Public License    |
+ | along with QuickTle. If not, see <http://www.gnu.org/licenses/>.            |
+ +----------------------------------------------------------------------------*/
+/*!
+    \file frames.h
+    \brief File contains the definition of quicktle::EarthOrientation and
+           quicktle::FrameConverter classes for the conversion of TEME
+           states into GCRF and ITRF.
+*/
+
+#ifndef TLEFRAMES_H
+#define TLEFRAMES_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace quicktle
+{
+
+/*!
+    \brief Earth orientation parameters: polar motion and UT1-UTC.
+
+    The parameters are loaded from the local file in IERS "finals" format
+    (finals.all, finals2000A.all, ...), which is mapped into the memory.
+    The values between the days are interpolated linearly (UT1-UTC -
+    with respect to the leap seconds); outside of the table the values
+    of the nearest day are used.
+*/
+class EarthOrientation
+{
+public:
+    EarthOrientation(); //!< Default constructor: zero parameters.
+    /*!
+        \brief Load the parameters from the file.
+        \param fileName - name of the file in IERS "finals" format
+        \return Whether the file is read and contains at least one day.
+    */
+    bool load(const std::string &fileName);
+    /*!
+        \brief Append the parameters of one day; the days should be
+               appended in ascending order.
+        \param mjd - modified Julian date of the day (UTC)
+        \param xp - X coordinate of the pole [Radians]
+        \param yp - Y coordinate of the pole [Radians]
+        \param dut1 - UT1-UTC [s]
+    */
+    void append(double mjd, double xp, double yp, double dut1);
+    //! Remove all days
+    void clear();
+    //! Get the number of days
+    std::size_t size() const;
+    /*!
+        \brief Get the parameters at the given time
+        \param t - number of seconds from Jan 1, 1970 (UTC)
+        \param xp - X coordinate of the pole [Radians]
+        \param yp - Y coordinate of the pole [Radians]
+        \param dut1 - UT1-UTC [s]
+    */
+    void parameters(double t, double &xp, double &yp, double &dut1) const;
+
+private:
+    std::vector<double> m_mjd;
+    std::vector<double> m_xp;
+    std::vector<double> m_yp;
+    std::vector<double> m_dut1;
+};
+
+/*!
+    \brief Conversion of the states from TEME frame (the frame of TLE
+           propagation) into GCRF and ITRF.
+
+    GCRF is approximated by the mean equator and equinox of J2000 (IAU-76
+    precession, IAU-80 nutation, truncated to the largest terms; the frame
+    bias and the celestial pole offsets are ignored, so the error is below
+    0.05 arcsec). ITRF is obtained by the rotation of the sidereal angle
+    of UT1 and the polar motion.
+
+    On the time grids the precession-nutation matrix and the polar motion
+    are computed once per node of the coarse grid with the given interval
+    and interpolated linearly between the nodes; only UT1-UTC (which may
+    jump by a leap second between the nodes) and the sidereal angle are
+    computed for each sample.
+
+    All times are the numbers of seconds from Jan 1, 1970 (UTC).
+*/
+class FrameConverter
+{
+public:
+    FrameConverter(); //!< Default constructor: no Earth orientation data.
+    /*!
+        \brief Constructor
+        \param eop - Earth orientation parameters (not owned; may be null)
+    */
+    explicit FrameConverter(const EarthOrientation *eop);
+    //! Get the Earth orientation parameters
+    const EarthOrientation* earthOrientation() const;
+    //! Set the Earth orientation parameters (not owned; may be null)
+    void setEarthOrientation(const EarthOrientation *eop);
+    //! Get the interval between the interpolation nodes [s]
+    double interval() const;
+    //! Set the interval between the interpolation nodes [s]
+    void setInterval(double interval);
+    /*!
+        \brief Compute the rotation matrices at the given time
+        \param t - number of seconds from Jan 1, 1970
+        \param gcrf - buffer for 9 values of row-major TEME to GCRF matrix;
+                      may be null
+        \param itrf - buffer for 9 values of row-major TEME to ITRF matrix;
+                      may be null
+    */
+    void rotations(double t, double *gcrf, double *itrf) const;
+    /*!
+        \brief Convert TEME positions (and velocities) on the uniform time
+               grid into GCRF in place.
+        \param start - time of the first sample
+        \param step - time step [s]
+        \param count - number of samples
+        \param x, y, z - coordinates [m]
+        \param vx, vy, vz - velocity [m/s]; may be null
+    */
+    void toGcrf(double start, double step, std::size_t count,
+                double *x, double *y, double *z,
+                double *vx = 0, double *vy = 0, double *vz = 0) const;
+    /*!
+        \brief Convert TEME positions (and velocities) on the uniform time
+               grid into ITRF in place. The velocity is relative to
+               the rotating Earth.
+        \see FrameConverter::toGcrf()
+    */
+    void toItrf(double start, double step, std::size_t count,
+                double *x, double *y, double *z,
+                double *vx = 0, double *vy = 0, double *vz = 0) const;
+
+private:
+    //! Slowly changing parameters at the interpolation node
+    struct Orientation
+    {
+        double precessionNutation[9]; //!< TEME to GCRF
+        double polarMotion[9];        //!< Pseudo Earth-fixed to ITRF
+        double dut1;                  //!< UT1-UTC [s]
+    };
+
+    void orientation(double t, Orientation &result) const;
+    template <typename Apply>
+    void forEachSample(double start, double step, std::size_t count,
+                       Apply apply) const;
+
+    const EarthOrientation *m_eop;
+    double m_interval;
+};
+
+} // namespace quicktle
+
+#endif // TLEFRAMES_H
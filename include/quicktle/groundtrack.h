@@ -0,0 +1,119 @@
+/*-----------------------------------------------------------------------------+
+ | QuickTle                                                                    |
+ | Copyright 2011-2015 Sergei Fundaev                                          |
+ +-----------------------------------------------------------------------------+
+ | This file is part of QuickTle library.                                      |
+ |                                                                             |
+ | QuickTle is free software: you can redistribute it and/or modify            |
+ | it under the terms of the GNU Lesser General Public License as published by |
+ | the Free Software Foundation, either version 3 of the License, or           |
+ | (at your option) any later version.                                         |
+ |                                                                             |
+ | QuickTle is distributed in the hope that it will be useful,                 |
+ | but WITHOUT ANY WARRANTY; without even the implied warranty of              |
+ | MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               |
+ | GNU Lesser General Public License for more details.                         |
+ |                                                                             |
+ | You should have received a copy of the GNU Lesser General Public License    |
+ | along with QuickTle. If not, see <http://www.gnu.org/licenses/>.            |
+ +----------------------------------------------------------------------------*/
+/*!
+    \file groundtrack.h
+    \brief File contains the definition of quicktle::GroundTrack class.
+*/
+
+#ifndef TLEGROUNDTRACK_H
+#define TLEGROUNDTRACK_H
+
+#include <cstddef>
+#include <vector>
+#include <quicktle/node.h>
+#include <quicktle/propagator.h>
+#include <quicktle/threadpool.h>
+
+namespace quicktle
+{
+
+/*!
+    \brief Point of the ground track.
+*/
+struct TrackPoint
+{
+    double t;         //!< Time [s from Jan 1, 1970]
+    double latitude;  //!< Geodetic latitude [Radians]
+    double longitude; //!< Longitude [-M_PI, M_PI] [Radians]
+};
+
+//! Polyline of the ground track, which does not cross the antimeridian
+typedef std::vector<TrackPoint> Polyline;
+
+/*!
+    \brief Generator of the ground track (sub-satellite points) of one
+           satellite.
+
+    The track is sampled adaptively: each interval of the coarse time grid
+    is halved while its middle point deviates from the chord by more than
+    half of the tolerance, so the points are dense only where the track
+    bends. Then the samples are simplified by Douglas-Peucker algorithm
+    with the other half of the tolerance, and the result is split into
+    polylines at the antimeridian. The deviations are measured in the
+    equirectangular projection (latitude and longitude in radians).
+*/
+class GroundTrack
+{
+public:
+    GroundTrack(); //!< Default constructor.
+    /*!
+        \brief Constructor
+        \param node - the satellite
+        \param tolerance - maximal deviation of the polylines from the track
+                           [Radians]
+    */
+    explicit GroundTrack(const Node &node, double tolerance = 1e-3);
+    //! Set the satellite
+    void assign(const Node &node);
+    //! Get the maximal deviation of the polylines from the track [Radians]
+    double tolerance() const;
+    //! Set the maximal deviation of the polylines from the track [Radians]
+    void setTolerance(double tolerance);
+    /*!
+        \brief Compute the ground track over the time interval
+        \param start - beginning of the interval [s from Jan 1, 1970]
+        \param stop - end of the interval [s from Jan 1, 1970]
+        \param polylines - output: polylines in the order of time; the
+                           polylines, split at the antimeridian, end and
+                           begin at the longitudes of M_PI and -M_PI.
+        \return Total number of points.
+    */
+    std::size_t compute(double start, double stop,
+                        std::vector<Polyline> &polylines) const;
+
+private:
+    //! Sub-satellite point with the longitude, unwrapped near \a longitude
+    TrackPoint point(double t, double longitude) const;
+    //! Append the samples of (a, b], adaptively refined, to \a samples
+    void refine(const TrackPoint &a, const TrackPoint &b, int depth,
+                std::vector<TrackPoint> &samples) const;
+
+    Propagator m_propagator;
+    double m_period;
+    double m_tolerance;
+};
+
+/*!
+    \brief Compute the ground tracks of the catalog in parallel.
+    \param catalog - satellites
+    \param start - beginning of the interval [s from Jan 1, 1970]
+    \param stop - end of the interval [s from Jan 1, 1970]
+    \param tolerance - maximal deviation of the polylines from the tracks
+                       [Radians]
+    \param tracks - output: polylines of satellite k are in tracks[k]
+    \param threads - number of threads (0 - number of available cores)
+*/
+void groundTracks(const std::vector<Node> &catalog, double start, double stop,
+                  double tolerance, std::vector< std::vector<Polyline> > &tracks,
+                  unsigned threads = 0);
+
+} // namespace quicktle
+
+#endif // TLEGROUNDTRACK_H
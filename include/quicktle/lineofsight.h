@@ -0,0 +1,141 @@
+/*-----------------------------------------------------------------------------+
+ | QuickTle                                                                    |
+ | Copyright 2011-2015 Sergei Fundaev                                          |
+ +-----------------------------------------------------------------------------+
+ | This file is part of QuickTle library.                                      |
+ |                                                                             |
+ | QuickTle is free software: you can redistribute it and/or modify            |
+ | it under the terms of the GNU Lesser General Public License as published by |
+ | the Free Software Foundation, either version 3 of the License, or           |
+ | (at your option) any later version.                                         |
+ |                                                                             |
+ | QuickTle is distributed in the hope that it will be useful,                 |
+ | but WITHOUT ANY WARRANTY; without even the implied warranty of              |
+ | MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               |
+ | GNU Lesser General Public License for more details.                         |
+ |                                                                             |
+ | You should have received a copy of the GNU Lesser General Public License    |
+ | along with QuickTle. If not, see <http://www.gnu.org/licenses/>.            |
+ +----------------------------------------------------------------------------*/
+/*!
+    \file lineofsight.h
+    \brief File contains the definition of quicktle::LineOfSightMatrix
+           class.
+*/
+
+#ifndef TLELINEOFSIGHT_H
+#define TLELINEOFSIGHT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+#include <quicktle/node.h>
+#include <quicktle/propagator.h>
+
+namespace quicktle
+{
+
+class CellTable;
+
+/*!
+    \brief Sparse matrix of the inter-satellite lines of sight at some
+           time moment.
+
+    The line between two satellites is unobstructed, if it does not cross
+    the sphere of the Earth radius plus the grazing margin, which accounts
+    for the atmosphere. The satellites are propagated in parallel and
+    sorted by the cells of the grid, which edge is the maximal range of
+    the link (or the longest possible unobstructed line, if the range is
+    not limited), so only the satellites in the neighbouring cells are
+    tested. The coordinates of the satellites of one cell are contiguous,
+    and the segment/sphere test runs over them without branches, so the
+    compiler vectorizes it. Each satellite is tested against all its
+    candidates, so the adjacency lists are written by the rows in
+    parallel without merging.
+
+    The result is stored as the adjacency lists: the neighbours of the
+    satellite k are neighbours()[offsets()[k]], ...,
+    neighbours()[offsets()[k + 1] - 1] in no particular order, and the
+    ranges to them are at the same indices of ranges(). Each link appears
+    in the lists of both satellites.
+*/
+class LineOfSightMatrix
+{
+public:
+    LineOfSightMatrix(); //!< Default constructor.
+    /*!
+        \brief Constructor
+        \param satellites - satellites
+    */
+    explicit LineOfSightMatrix(const std::vector<Node> &satellites);
+    //! Destructor.
+    ~LineOfSightMatrix();
+    //! Set the satellites
+    void setSatellites(const std::vector<Node> &satellites);
+    //! Get the number of satellites
+    std::size_t size() const;
+    //! Get the grazing margin above the equatorial radius of the Earth [m]
+    double margin() const;
+    //! Set the grazing margin above the equatorial radius of the Earth [m]
+    void setMargin(double margin);
+    //! Get the maximal range of the link [m] (0 - not limited)
+    double maxRange() const;
+    //! Set the maximal range of the link [m] (0 - not limited)
+    void setMaxRange(double maxRange);
+    //! Get the number of threads (0 - number of available cores)
+    unsigned threads() const;
+    //! Set the number of threads (0 - number of available cores)
+    void setThreads(unsigned threads);
+    /*!
+        \brief Compute the lines of sight at the given time
+        \param t - number of seconds from Jan 1, 1970
+        \return Number of links (pairs of satellites).
+    */
+    std::size_t compute(double t);
+    //! Get the time of the last computation
+    double time() const;
+    //! Get the number of links
+    std::size_t links() const;
+    //! Get size() + 1 offsets of the adjacency lists
+    const std::size_t* offsets() const;
+    //! Get the neighbours of all satellites; 0 if there are no links.
+    const std::size_t* neighbours() const;
+    //! Get the ranges to the neighbours [m]; 0 if there are no links.
+    const double* ranges() const;
+    //! Get 3 geocentric coordinates of the satellite k at time() [m]
+    const double* position(std::size_t k) const;
+
+private:
+    LineOfSightMatrix(const LineOfSightMatrix&);            //!< Copying is unavailable.
+    LineOfSightMatrix& operator=(const LineOfSightMatrix&); //!< Copying is unavailable.
+
+    /*!
+        Test the satellites [first, last) against their candidates, write
+        the lengths of their adjacency lists into m_offsets and append the
+        lists to the buffers.
+    */
+    void testRows(std::size_t first, std::size_t last, double cellSize,
+                  std::vector<std::size_t> &neighbours,
+                  std::vector<double> &ranges);
+
+    std::vector<Propagator> m_propagators;
+    std::vector<double> m_positions;
+    //! Coordinates of the satellites in the order of m_entries
+    std::vector<double> m_sorted[3];
+    //! Pairs of cell key and satellite index, sorted by key
+    std::vector< std::pair<std::uint64_t, std::uint32_t> > m_entries;
+    std::unique_ptr<CellTable> m_table;
+    std::vector<std::size_t> m_offsets;
+    std::vector<std::size_t> m_neighbours;
+    std::vector<double> m_ranges;
+    double m_t;
+    double m_margin;
+    double m_maxRange;
+    unsigned m_threads;
+};
+
+} // namespace quicktle
+
+#endif // TLELINEOFSIGHT_H
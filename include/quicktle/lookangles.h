@@ -0,0 +1,112 @@
+/*-----------------------------------------------------------------------------+
+ | QuickTle                                                                    |
+ | Copyright 2011-2015 Sergei Fundaev                                          |
+ +-----------------------------------------------------------------------------+
+ | This file is part of QuickTle library.                                      |
+ |                                                                             |
+ | QuickTle is free software: you can redistribute it and/or modify            |
+ | it under the terms of the GNU Lesser General Public License as published by |
+ | the Free Software Foundation, either version 3 of the License, or           |
+ | (at your option) any later version.                                         |
+ |                                                                             |
+ | QuickTle is distributed in the hope that it will be useful,                 |
+ | but WITHOUT ANY WARRANTY; without even the implied warranty of              |
+ | MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               |
+ | GNU Lesser General Public License for more details.                         |
+ |                                                                             |
+ | You should have received a copy of the GNU Lesser General Public License    |
+ | along with QuickTle. If not, see <http://www.gnu.org/licenses/>.            |
+ +----------------------------------------------------------------------------*/
+/*!
+    \file lookangles.h
+    \brief File contains the definition of quicktle::LookAngleMatrix class.
+*/
+
+#ifndef TLELOOKANGLES_H
+#define TLELOOKANGLES_H
+
+#include <cstddef>
+#include <vector>
+#include <quicktle/node.h>
+#include <quicktle/dataset.h>
+#include <quicktle/station.h>
+#include <quicktle/propagator.h>
+
+namespace quicktle
+{
+
+/*!
+    \brief Look angles, ranges and range rates of all satellites from all
+           ground stations at some time moment.
+
+    The Earth-fixed positions and local bases of the stations are computed
+    once, when the stations are set. At each time moment each satellite
+    is propagated and converted into the Earth-fixed frame once; then the
+    chunk of satellites is processed station by station, so the matrices
+    are filled by contiguous rows. Satellites are processed in parallel.
+
+    The matrices are stored by rows: the value for the station s and the
+    satellite k is at index s * satellites() + k.
+*/
+class LookAngleMatrix
+{
+public:
+    LookAngleMatrix(); //!< Default constructor.
+    /*!
+        \brief Constructor
+        \param stations - ground stations
+        \param satellites - satellites
+    */
+    LookAngleMatrix(const std::vector<Station> &stations,
+                    const std::vector<Node> &satellites);
+    //! Set the ground stations
+    void setStations(const std::vector<Station> &stations);
+    //! Set the satellites, specified by one node each
+    void setSatellites(const std::vector<Node> &satellites);
+    /*!
+        \brief Set the satellites, specified by the histories of nodes.
+               The state is computed by DataSet::stateAt().
+    */
+    void setSatellites(const std::vector<DataSet> &satellites);
+    //! Get the number of stations
+    std::size_t stations() const;
+    //! Get the number of satellites
+    std::size_t satellites() const;
+    //! Get the number of threads (0 - number of available cores)
+    unsigned threads() const;
+    //! Set the number of threads (0 - number of available cores)
+    void setThreads(unsigned threads);
+    /*!
+        \brief Compute the matrices at the given time
+        \param t - number of seconds from Jan 1, 1970
+    */
+    void compute(double t);
+    //! Get the time of the last computation
+    double time() const;
+    //! Get the azimuths [0, 2 * M_PI), measured from the north to the east
+    const double* azimuth() const;
+    //! Get the elevations [Radians]
+    const double* elevation() const;
+    //! Get the ranges [m]
+    const double* range() const;
+    //! Get the range rates [m/s]; positive, when the satellite recedes
+    const double* rangeRate() const;
+
+private:
+    void computeChunk(double t, std::size_t first, std::size_t last);
+
+    std::vector<Station> m_stations;
+    std::vector<Propagator> m_propagators;
+    std::vector<DataSet> m_dataSets;
+    std::vector<DataSet::Cursor> m_cursors;  //!< one per data set
+    double m_t;
+    unsigned m_threads;
+    std::vector<double> m_azimuth;
+    std::vector<double> m_elevation;
+    std::vector<double> m_range;
+    std::vector<double> m_rangeRate;
+};
+
+} // namespace quicktle
+
+#endif // TLELOOKANGLES_H
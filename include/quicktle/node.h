@@ -46,6 +46,13 @@ enum FileType
 /*!
     \brief Main object of TLELib library. It represents the data, specified
            in the one measurement in TLE file.
+
+    The orbit elements are parsed, and the values derived from them
+    (a(), p(), E(), nu(), orientation()) are computed, on assignment and
+    in the setters, so these getters only read the object. The other
+    fields and the invalid elements are parsed by their getters, unless
+    the lines are assigned with forceParsing; a Node, which is read from
+    several threads at once, should be assigned with forceParsing.
 */
 class Node
 {
@@ -190,6 +197,18 @@ public:
     void set_e(double e);
     double getEccentricity();
     void setEccentricity(double e);
+    /*!
+        \brief Set the orbital elements at once; the derived values are
+               computed once for all of them.
+        \param n - Mean Motion [radians per second]
+        \param e - Eccentricity
+        \param i - Inclination [radians]
+        \param Omega - Right Ascension of the Ascending Node [radians]
+        \param omega - Argument of Perigee [radians]
+        \param M - Mean Anomaly [radians]
+    */
+    void setElements(double n, double e, double i, double Omega,
+                     double omega, double M);
     
     /*!
         Get the Classification
@@ -251,6 +270,13 @@ public:
     double vy() const;
     //! Get Z-coordinate of velocity
     double vz() const;
+    /*!
+        \brief Get the orientation matrix of the orbit.
+        \return Pointer to 9 values of 3x3 matrix (row-major), which
+                converts the perifocal coordinates (X to the perigee,
+                Z along the angular momentum) into the geocentric ones.
+    */
+    const double* orientation() const;
     //! Convert this object to the first string of TLE format.
     std::string firstString() const;
     //! Convert this object to the second string of TLE format.
@@ -292,6 +318,13 @@ protected:
     void parseAll();
     //! Check whether the line checksum is valid
     ErrorCode checkLine(const std::string &str) const;
+    /*!
+        Compute the orbit constants (semi-major axis, focal parameter,
+        velocity scale and orientation matrix) from the orbit elements.
+    */
+    void updateOrbitConstants();
+    //! Compute eccentric and true anomalies from the orbit elements.
+    void updateAnomalies();
 
 private:
     enum Field
@@ -340,6 +373,15 @@ private:
     FileType m_fileType;
     mutable ErrorCode m_lastError;
     mutable std::bitset<FieldsCount> m_initList;
+
+    // Values, derived from the orbit elements. They are recomputed by
+    // assign() and by the setters of the corresponding elements.
+    double m_a;
+    double m_p;
+    double m_v0;               //!< sqrt(GM / p)
+    double m_orientation[9];
+    double m_E;
+    double m_nu;
 };
 
 } // namespace quicktle
@@ -0,0 +1,119 @@
+/*-----------------------------------------------------------------------------+
+ | QuickTle                                                                    |
+ | Copyright 2011-2015 Sergei Fundaev                                          |
+ +-----------------------------------------------------------------------------+
+ | This file is part of QuickTle library.                                      |
+ |                                                                             |
+ | QuickTle is free software: you can redistribute it and/or modify            |
+ | it under the terms of the GNU Lesser General Public License as published by |
+ | the Free Software Foundation, either version 3 of the License, or           |
+ | (at your option) any later version.                                         |
+ |                                                                             |
+ | QuickTle is distributed in the hope that it will be useful,                 |
+ | but WITHOUT ANY WARRANTY; without even the implied warranty of              |
+ | MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               |
+ | GNU Lesser General Public License for more details.                         |
+ |                                                                             |
+ | You should have received a copy of the GNU Lesser General Public License    |
+ | along with QuickTle. If not, see <http://www.gnu.org/licenses/>.            |
+ +----------------------------------------------------------------------------*/
+/*!
+    \file passes.h
+    \brief File contains the definition of quicktle::PassPredictor class.
+*/
+
+#ifndef TLEPASSES_H
+#define TLEPASSES_H
+
+#include <cstddef>
+#include <vector>
+#include <quicktle/node.h>
+#include <quicktle/station.h>
+#include <quicktle/propagator.h>
+
+namespace quicktle
+{
+
+/*!
+    \brief Pass of the satellite over the ground station.
+*/
+struct Pass
+{
+    std::size_t station;   //!< Index of the station
+    std::size_t satellite; //!< Index of the satellite
+    double rise;           //!< Time of acquisition of signal (AOS)
+    double culmination;    //!< Time of maximal elevation
+    double set;            //!< Time of loss of signal (LOS)
+    double maxElevation;   //!< Maximal elevation [Radians]
+};
+
+/*!
+    \brief Predictor of the satellite passes over the ground stations.
+
+    The position of each satellite is propagated once on the coarse time
+    grid and shared by all the stations. Stations, which can not see the
+    orbit (by its inclination and apogee), are skipped at once; for other
+    stations the grid is scanned with the step, adapted to the angular
+    distance between the station and the sub-satellite point. The times
+    of rise, set and culmination are refined by bisection and golden
+    section search. Satellites are processed in parallel.
+
+    All times are the numbers of seconds from Jan 1, 1970.
+*/
+class PassPredictor
+{
+public:
+    PassPredictor(); //!< Default constructor.
+    /*!
+        \brief Constructor
+        \param stations - ground stations
+        \param satellites - satellites
+    */
+    PassPredictor(const std::vector<Station> &stations,
+                  const std::vector<Node> &satellites);
+    //! Set the ground stations
+    void setStations(const std::vector<Station> &stations);
+    //! Set the satellites
+    void setSatellites(const std::vector<Node> &satellites);
+    //! Get the time tolerance of the event refinement [s]
+    double tolerance() const;
+    //! Set the time tolerance of the event refinement [s]
+    void setTolerance(double tolerance);
+    //! Get the number of threads (0 - number of available cores)
+    unsigned threads() const;
+    //! Set the number of threads (0 - number of available cores)
+    void setThreads(unsigned threads);
+    /*!
+        \brief Predict the passes of all satellites over all stations.
+        \param start - start of the time interval
+        \param stop - end of the time interval
+        \return Passes, ordered by the rise time, station and satellite.
+                The passes, which are in progress at \a start or \a stop,
+                are cut off by the interval.
+    */
+    std::vector<Pass> predict(double start, double stop) const;
+
+private:
+    //! Orbit parameters, which bound the visibility
+    struct Orbit
+    {
+        double apogee;      //!< Apogee radius [m]
+        double inclination; //!< Inclination, reduced to [0, M_PI / 2]
+        double maxRate;     //!< Bound of the angular rate in Earth-fixed frame
+        double period;      //!< Period [s]
+    };
+
+    void predictSatellite(std::size_t satellite, double start, double stop,
+                          std::vector<double> &buffer,
+                          std::vector<Pass> &passes) const;
+
+    std::vector<Station> m_stations;
+    std::vector<Propagator> m_propagators;
+    std::vector<Orbit> m_orbits;
+    double m_tolerance;
+    unsigned m_threads;
+};
+
+} // namespace quicktle
+
+#endif // TLEPASSES_H
@@ -0,0 +1,225 @@
+/*-----------------------------------------------------------------------------+
+ | QuickTle                                                                    |
+ | Copyright 2011-2015 Sergei Fundaev                                          |
+ +-----------------------------------------------------------------------------+
+ | This file is part of QuickTle library.                                      |
+ |                                                                             |
+ | QuickTle is free software: you can redistribute it and/or modify            |
+ | it under the terms of the GNU Lesser General Public License as published by |
+ | the Free Software Foundation, either version 3 of the License, or           |
+ | (at your option) any later version.                                         |
+ |                                                                             |
+ | QuickTle is distributed in the hope that it will be useful,                 |
+ | but WITHOUT ANY WARRANTY; without even the implied warranty of              |
+ | MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               |
+ | GNU Lesser General Public License for more details.                         |
+ |                                                                             |
+ | You should have received a copy of the GNU Lesser General Public License    |
+ | along with QuickTle. If not, see <http://www.gnu.org/licenses/>.            |
+ +----------------------------------------------------------------------------*/
+/*!
+    \file propagator.h
+    \brief File contains the definition of quicktle::BasicPropagator class
+           and the functions for dense ephemeris generation.
+*/
+
+#ifndef TLEPROPAGATOR_H
+#define TLEPROPAGATOR_H
+
+#include <cstddef>
+#include <quicktle/node.h>
+#include <quicktle/fastmath.h>
+
+namespace quicktle
+{
+
+class DataSet;
+
+//! Force model of quicktle::BasicPropagator
+enum OrbitModel
+{
+    TwoBody = 0,  //!< Keplerian orbit with the fixed orientation
+    J2Secular     //!< Secular drift of Omega, omega and M due to J2
+};
+
+/*!
+    \brief Two-body or J2-secular propagator of the orbit, specified by a
+           Node object.
+
+    All the per-orbit constants (semi-major axis, focal parameter,
+    orientation of the orbit plane) are computed once when the node is
+    assigned, so the state at an arbitrary time costs only one Kepler
+    equation solve and one rotation.
+
+    The class is instantiated for double (quicktle::Propagator) and float
+    (quicktle::FloatPropagator) scalars. The time and the mean anomaly are
+    always reduced in double precision, the Kepler equation, the rotation
+    and the output use the scalar type. The float instantiation halves the
+    memory traffic of the output arrays. Its error against the double one
+    is dominated by the rounding of the anomalies: the position error is
+    less than 1e-6 of the apogee radius (about 4 m for the low orbits and
+    25 m for the geostationary one), the velocity error is less than 3e-6
+    of the maximal (perigee) velocity.
+
+    In quicktle::FastMath mode the sine and cosine in the Kepler solve are
+    replaced by the polynomial approximations of fastmath.h; the position
+    error against quicktle::AccurateMath mode is less than 1e-8 of the
+    apogee radius.
+
+    In quicktle::J2Secular mode the right ascension of the ascending node,
+    the argument of perigee and the mean anomaly drift with the constant
+    first-order J2 rates, computed from n(), e() and i() of the node when
+    it is assigned. The shape of the orbit and the inclination are fixed,
+    so a sample costs the same Kepler solve plus the sine and cosine of
+    the two drifted angles; the velocity includes the rotation of the
+    orbit plane and is the exact derivative of the position. The mode
+    reproduces the nodal regression and the apsidal rotation of SGP4
+    without its periodic and drag terms.
+*/
+template <typename Real>
+class BasicPropagator
+{
+public:
+    BasicPropagator(); //!< Default constructor.
+    /*!
+        \brief Constructor
+        \param node - the Node object, which orbit should be propagated
+        \param mode - accuracy of the elementary functions
+        \param model - force model
+    */
+    explicit BasicPropagator(const Node &node, MathMode mode = AccurateMath,
+                             OrbitModel model = TwoBody);
+    /*!
+        \brief Compute the orbit constants of the given node.
+        \param node - the Node object, which orbit should be propagated
+    */
+    void assign(const Node &node);
+    //! Get the epoch of the assigned node - number of seconds from Jan 1, 1970
+    double epoch() const;
+    //! Get the accuracy of the elementary functions
+    MathMode mathMode() const;
+    //! Set the accuracy of the elementary functions
+    void setMathMode(MathMode mode);
+    //! Get the force model
+    OrbitModel orbitModel() const;
+    //! Set the force model; it is applied to the assigned node immediately
+    void setOrbitModel(OrbitModel model);
+    //! Get the rate of the right ascension of the ascending node [rad/s]
+    double OmegaRate() const;
+    //! Get the rate of the argument of perigee [rad/s]
+    double omegaRate() const;
+    //! Get the rate of the mean anomaly [rad/s]
+    double meanAnomalyRate() const;
+    /*!
+        \brief Get the mean anomaly at the given time
+        \param t - number of seconds from Jan 1, 1970
+        \return Mean anomaly [0, 2 * M_PI) [Radians]
+    */
+    double meanAnomaly(double t) const;
+    /*!
+        \brief Compute the geocentric position and velocity at the given time
+        \param t - number of seconds from Jan 1, 1970
+        \param position - buffer of 3 values for X, Y, Z coordinates [m]
+        \param velocity - buffer of 3 values for X, Y, Z coordinates of
+                          velocity [m/s]; may be null.
+    */
+    void state(double t, Real *position, Real *velocity = 0) const;
+    /*!
+        \brief Compute the state with the given accuracy of the elementary
+               functions instead of the one of this object.
+        \see BasicPropagator::state()
+    */
+    void state(double t, Real *position, Real *velocity, MathMode mode) const;
+    /*!
+        \brief Fill the caller-provided arrays with positions and velocities
+               on the uniform time grid start, start + step, ..., stop.
+        \param start - time of the first sample [s from Jan 1, 1970]
+        \param stop - time of the last sample [s from Jan 1, 1970]
+        \param step - time step [s]
+        \param x, y, z - arrays for the coordinates [m]; each of them should
+                         hold at least samples(start, stop, step) values
+        \param vx, vy, vz - arrays for the velocity [m/s]; may be null
+        \return Number of written samples.
+    */
+    std::size_t ephemeris(double start, double stop, double step,
+                          Real *x, Real *y, Real *z,
+                          Real *vx = 0, Real *vy = 0, Real *vz = 0) const;
+    /*!
+        \brief Fill the caller-provided arrays with \a count samples of
+               positions and velocities, beginning at \a start with
+               the given \a step.
+        \see BasicPropagator::ephemeris()
+    */
+    void propagate(double start, double step, std::size_t count,
+                   Real *x, Real *y, Real *z,
+                   Real *vx = 0, Real *vy = 0, Real *vz = 0) const;
+    /*!
+        \brief Number of samples on the grid start, start + step, ..., stop
+        \return Number of samples or 0 if the grid is empty.
+    */
+    static std::size_t samples(double start, double stop, double step);
+
+private:
+    template <typename SinCos>
+    void computeState(double t, Real *position, Real *velocity) const;
+    template <typename SinCos>
+    void computeGrid(double start, double step, std::size_t count,
+                     Real *x, Real *y, Real *z,
+                     Real *vx, Real *vy, Real *vz) const;
+    //! Apply the force model to the rates and the velocity scales
+    void updateModel();
+    //! Compute the orientation of the orbit, rotated by the drift in dt
+    template <typename SinCos>
+    void driftedAxes(double dt, Real *P, Real *Q) const;
+
+    MathMode m_mathMode;
+    OrbitModel m_model;
+    double m_epoch;
+    double m_M0;
+    double m_n;       //!< rate of the mean anomaly of the force model
+    double m_n0;      //!< two-body mean motion
+    double m_dM;      //!< J2 correction of the mean anomaly rate
+    double m_dOmega;  //!< J2 rate of the ascending node
+    double m_domega;  //!< J2 rate of the argument of perigee
+    double m_Omega0;
+    double m_omega0;
+    double m_sini;
+    double m_cosi;
+    Real m_e;
+    Real m_an;    //!< a * n - velocity scale along the major axis
+    Real m_bn;    //!< b * n - velocity scale along the minor axis
+    Real m_a;     //!< semi-major axis
+    Real m_b;     //!< semi-minor axis
+    Real m_P[3];  //!< unit vector to the perigee
+    Real m_Q[3];  //!< unit vector in the orbit plane, normal to m_P
+};
+
+//! Propagator in double precision
+typedef BasicPropagator<double> Propagator;
+//! Propagator in single precision
+typedef BasicPropagator<float> FloatPropagator;
+
+/*!
+    \brief Fill the caller-provided arrays with positions and velocities
+           on the uniform time grid start, start + step, ..., stop. Each
+           sample is computed by DataSet::stateAt() through one cursor,
+           so the interpolation method of the data set is used, and the
+           orbit constants are recomputed only when the governing nodes
+           change.
+    \see Propagator::ephemeris()
+    \return Number of written samples.
+*/
+std::size_t ephemeris(const DataSet &dataSet,
+                      double start, double stop, double step,
+                      double *x, double *y, double *z,
+                      double *vx = 0, double *vy = 0, double *vz = 0);
+
+//! Single precision version of ephemeris() for a DataSet
+std::size_t ephemeris(const DataSet &dataSet,
+                      double start, double stop, double step,
+                      float *x, float *y, float *z,
+                      float *vx = 0, float *vy = 0, float *vz = 0);
+
+} // namespace quicktle
+
+#endif // TLEPROPAGATOR_H
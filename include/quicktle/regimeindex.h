@@ -0,0 +1,154 @@
+/*-----------------------------------------------------------------------------+
+ | QuickTle                                                                    |
+ | Copyright 2011-2015 Sergei Fundaev                                          |
+ +-----------------------------------------------------------------------------+
+ | This file is part of QuickTle library.                                      |
+ |                                                                             |
+ | QuickTle is free software: you can redistribute it and/or modify            |
+ | it under the terms of the GNU Lesser General Public License as published by |
+ | the Free Software Foundation, either version 3 of the License, or           |
+ | (at your option) any later version.                                         |
+ |                                                                             |
+ | QuickTle is distributed in the hope that it will be useful,                 |
+ | but WITHOUT ANY WARRANTY; without even the implied warranty of              |
+ | MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               |
+ | GNU Lesser General Public License for more details.                         |
+ |                                                                             |
+ | You should have received a copy of the GNU Lesser General Public License    |
+ | along with QuickTle. If not, see <http://www.gnu.org/licenses/>.            |
+ +----------------------------------------------------------------------------*/
+/*!
+    \file regimeindex.h
+    \brief File contains the definition of quicktle::RegimeIndex class.
+*/
+
+#ifndef TLEREGIMEINDEX_H
+#define TLEREGIMEINDEX_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <quicktle/node.h>
+
+namespace quicktle
+{
+
+/*!
+    \brief Index of the altitude bands [perigee, apogee] and inclinations
+           of the catalog.
+
+    The perigee and apogee altitudes (above the equatorial radius of the
+    Earth) and the inclinations are computed once, when the catalog is
+    set. The bands are sorted by the perigee altitude and form the
+    implicit interval tree: the middle band of each range of the sorted
+    array keeps the maximal apogee of the range. The overlap and stabbing
+    queries skip the ranges, which are entirely below the query or above
+    it, so they cost O(log(n) + m) for m found satellites.
+
+    The update of the element set, which keeps the order of the perigees,
+    costs O(log(n)); otherwise the band is moved in the sorted array,
+    which costs O(n) of memory moves.
+
+    The query results are the indices of the satellites in the catalog,
+    in no particular order.
+*/
+class RegimeIndex
+{
+public:
+    RegimeIndex(); //!< Default constructor.
+    /*!
+        \brief Constructor
+        \param catalog - satellites
+    */
+    explicit RegimeIndex(const std::vector<Node> &catalog);
+    //! Set the satellites and build the index
+    void setCatalog(const std::vector<Node> &catalog);
+    /*!
+        \brief Update the element set of the satellite
+        \param k - index of the satellite in the catalog
+        \param node - new element set
+    */
+    void update(std::size_t k, const Node &node);
+    //! Get the number of satellites
+    std::size_t size() const;
+    //! Get the perigee altitude of the satellite k [m]
+    double perigee(std::size_t k) const;
+    //! Get the apogee altitude of the satellite k [m]
+    double apogee(std::size_t k) const;
+    //! Get the inclination of the satellite k [Radians]
+    double inclination(std::size_t k) const;
+    /*!
+        \brief Find the satellites, which altitude bands overlap the given
+               one
+        \param lower - lower altitude [m]
+        \param upper - upper altitude [m]
+        \param result - output: indices of the satellites
+    */
+    void overlapping(double lower, double upper,
+                     std::vector<std::size_t> &result) const;
+    /*!
+        \brief Find the satellites, which altitude bands overlap the given
+               one and which inclinations are within the given range
+        \param lower - lower altitude [m]
+        \param upper - upper altitude [m]
+        \param minInclination - minimal inclination [Radians]
+        \param maxInclination - maximal inclination [Radians]
+        \param result - output: indices of the satellites
+    */
+    void overlapping(double lower, double upper, double minInclination,
+                     double maxInclination,
+                     std::vector<std::size_t> &result) const;
+    /*!
+        \brief Find the satellites, which altitude bands contain the given
+               altitude
+        \param altitude - altitude [m]
+        \param result - output: indices of the satellites
+    */
+    void containing(double altitude, std::vector<std::size_t> &result) const;
+    /*!
+        \brief Find the satellites, which altitude bands contain the given
+               altitude and which inclinations are within the given range
+        \see RegimeIndex::overlapping()
+    */
+    void containing(double altitude, double minInclination,
+                    double maxInclination,
+                    std::vector<std::size_t> &result) const;
+
+private:
+    //! Altitude band of the satellite
+    struct Band
+    {
+        double perigee;
+        double apogee;
+        double inclination;
+        std::uint32_t satellite;
+
+        bool operator<(const Band &band) const
+        {
+            if (perigee != band.perigee)
+                return perigee < band.perigee;
+            return satellite < band.satellite;
+        }
+    };
+
+    static Band band(std::size_t k, const Node &node);
+    //! Compute the maximal apogees of the range [first, last)
+    double buildMax(std::size_t first, std::size_t last);
+    //! Recompute the maximal apogees of the ranges, containing the band
+    void refreshMax(std::size_t first, std::size_t last,
+                    std::size_t position);
+    //! Maximal apogee of the range [first, last)
+    double rangeMax(std::size_t first, std::size_t last) const;
+    //! Call the function for the bands of [first, last), overlapping the query
+    template <typename Function>
+    void query(std::size_t first, std::size_t last, double lower,
+               double upper, Function &function) const;
+
+    std::vector<Band> m_bands;              //!< sorted by perigee
+    std::vector<double> m_max;              //!< maximal apogees of ranges
+    std::vector<std::size_t> m_positions;   //!< satellite -> sorted index
+};
+
+} // namespace quicktle
+
+#endif // TLEREGIMEINDEX_H
@@ -0,0 +1,65 @@
+/*-----------------------------------------------------------------------------+
+ | QuickTle                                                                    |
+ | Copyright 2011-2015 Sergei Fundaev                                          |
+ +-----------------------------------------------------------------------------+
+ | This file is part of QuickTle library.                                      |
+ |                                                                             |
+ | QuickTle is free software: you can redistribute it and/or modify            |
+ | it under the terms of the GNU Lesser General Public License as published by |
+ | the Free Software Foundation, either version 3 of the License, or           |
+ | (at your option) any later version.                                         |
+ |                                                                             |
+ | QuickTle is distributed in the hope that it will be useful,                 |
+ | but WITHOUT ANY WARRANTY; without even the implied warranty of              |
+ | MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               |
+ | GNU Lesser General Public License for more details.                         |
+ |                                                                             |
+ | You should have received a copy of the GNU Lesser General Public License    |
+ | along with QuickTle. If not, see <http://www.gnu.org/licenses/>.            |
+ +----------------------------------------------------------------------------*/
+/*!
+    \file relativemotion.h
+    \brief File contains the functions for the relative motion of
+           the satellites in the orbital frame of the primary one.
+*/
+
+#ifndef TLERELATIVEMOTION_H
+#define TLERELATIVEMOTION_H
+
+#include <cstddef>
+#include <vector>
+#include <quicktle/node.h>
+#include <quicktle/threadpool.h>
+
+namespace quicktle
+{
+
+/*!
+    \brief Compute the positions (and velocities) of the secondary
+           satellites relative to the primary one in its radial,
+           in-track, cross-track (RIC) frame on the uniform time grid.
+
+    The R axis is directed along the position of the primary, C - along
+    its angular momentum, I completes the right-handed frame. The frame
+    of the primary is computed once per sample and shared by all
+    secondaries; the secondaries are propagated in blocks of samples in
+    parallel. The relative velocity is measured in the rotating frame.
+    \param primary - primary satellite
+    \param secondaries - secondary satellites
+    \param start - time of the first sample [s from Jan 1, 1970]
+    \param step - time step [s]
+    \param count - number of samples
+    \param positions - output: R, I, C of secondary k at sample j are at
+                       positions[3 * (k * count + j)] [m]
+    \param velocities - output of velocities in the same layout [m/s];
+                        may be null
+    \param threads - number of threads (0 - number of available cores)
+*/
+void relativeMotion(const Node &primary, const std::vector<Node> &secondaries,
+                    double start, double step, std::size_t count,
+                    double *positions, double *velocities = 0,
+                    unsigned threads = 0);
+
+} // namespace quicktle
+
+#endif // TLERELATIVEMOTION_H
@@ -0,0 +1,142 @@
+/*-----------------------------------------------------------------------------+
+ | QuickTle                                                                    |
+ | Copyright 2011-2015 Sergei Fundaev                                          |
+ +-----------------------------------------------------------------------------+
+ | This file is part of QuickTle library.                                      |
+ |                                                                             |
+ | QuickTle is free software: you can redistribute it and/or modify            |
+ | it under the terms of the GNU Lesser General Public License as published by |
+ | the Free Software Foundation, either version 3 of the License, or           |
+ | (at your option) any later version.                                         |
+ |                                                                             |
+ | QuickTle is distributed in the hope that it will be useful,                 |
+ | but WITHOUT ANY WARRANTY; without even the implied warranty of              |
+ | MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               |
+ | GNU Lesser General Public License for more details.                         |
+ |                                                                             |
+ | You should have received a copy of the GNU Lesser General Public License    |
+ | along with QuickTle. If not, see <http://www.gnu.org/licenses/>.            |
+ +----------------------------------------------------------------------------*/
+/*!
+    \file snapshotindex.h
+    \brief File contains the definition of quicktle::SnapshotIndex class.
+*/
+
+#ifndef TLESNAPSHOTINDEX_H
+#define TLESNAPSHOTINDEX_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+#include <quicktle/node.h>
+#include <quicktle/propagator.h>
+
+namespace quicktle
+{
+
+class CellTable;
+
+/*!
+    \brief Spatial index of the catalog positions at one time moment.
+
+    The catalog is propagated to the time of snapshot in parallel, and
+    the positions are hashed into the uniform grid of cubic cells. The
+    queries visit only the cells, overlapping the bounding box of the
+    query region, and test the exact condition for the satellites in
+    them. The update to the next time moment re-sorts only the
+    satellites, which have moved into other cells.
+
+    The positions and the queries are in the geocentric inertial frame.
+    The query results are the indices of the satellites in the catalog,
+    in no particular order.
+*/
+class SnapshotIndex
+{
+public:
+    SnapshotIndex(); //!< Default constructor.
+    /*!
+        \brief Constructor
+        \param catalog - satellites
+    */
+    explicit SnapshotIndex(const std::vector<Node> &catalog);
+    //! Destructor.
+    ~SnapshotIndex();
+    //! Set the satellites; the index becomes empty until update().
+    void setCatalog(const std::vector<Node> &catalog);
+    //! Get the number of satellites
+    std::size_t size() const;
+    //! Get the edge of the grid cell [m]
+    double cellSize() const;
+    //! Set the edge of the grid cell [m]; the index is rebuilt.
+    void setCellSize(double cellSize);
+    //! Get the number of threads (0 - number of available cores)
+    unsigned threads() const;
+    //! Set the number of threads (0 - number of available cores)
+    void setThreads(unsigned threads);
+    /*!
+        \brief Propagate the catalog to the given time and update the index
+        \param t - number of seconds from Jan 1, 1970
+    */
+    void update(double t);
+    //! Get the time of the snapshot
+    double time() const;
+    //! Get 3 coordinates of the satellite k at the time of snapshot [m]
+    const double* position(std::size_t k) const;
+    /*!
+        \brief Find the satellites within the sphere
+        \param center - 3 coordinates of the center [m]
+        \param radius - radius of the sphere [m]
+        \param result - output: indices of the satellites
+    */
+    void radius(const double *center, double radius,
+                std::vector<std::size_t> &result) const;
+    /*!
+        \brief Find the satellites within the cone of the sensor
+        \param apex - 3 coordinates of the apex [m]
+        \param axis - 3 coordinates of the direction of the axis
+        \param halfAngle - half of the aperture [0, M_PI] [Radians]
+        \param range - maximal distance from the apex [m]
+        \param result - output: indices of the satellites
+    */
+    void cone(const double *apex, const double *axis, double halfAngle,
+              double range, std::vector<std::size_t> &result) const;
+    /*!
+        \brief Find the satellites within the axis-aligned box
+        \param lower - 3 minimal coordinates of the box [m]
+        \param upper - 3 maximal coordinates of the box [m]
+        \param result - output: indices of the satellites
+    */
+    void box(const double *lower, const double *upper,
+             std::vector<std::size_t> &result) const;
+
+private:
+    SnapshotIndex(const SnapshotIndex&);            //!< Copying is unavailable.
+    SnapshotIndex& operator=(const SnapshotIndex&); //!< Copying is unavailable.
+
+    std::uint64_t key(const double *position) const;
+    void rebuild();
+    /*!
+        Call the function for the satellites in the cells, overlapping
+        the box [lower, upper].
+    */
+    template <typename Function>
+    void forEachCandidate(const double *lower, const double *upper,
+                          Function function) const;
+
+    std::vector<Propagator> m_propagators;
+    std::vector<double> m_positions;
+    std::vector<std::uint64_t> m_keys;
+    //! Pairs of cell key and satellite index, sorted by key
+    std::vector< std::pair<std::uint64_t, std::uint32_t> > m_entries;
+    std::unique_ptr<CellTable> m_table;
+    double m_t;
+    double m_cellSize;
+    unsigned m_threads;
+    bool m_valid;
+};
+
+} // namespace quicktle
+
+#endif // TLESNAPSHOTINDEX_H
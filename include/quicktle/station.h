@@ -0,0 +1,99 @@
+/*-----------------------------------------------------------------------------+
+ | QuickTle                                                                    |
+ | Copyright 2011-2015 Sergei Fundaev                                          |
+ +-----------------------------------------------------------------------------+
+ | This file is part of QuickTle library.                                      |
+ |                                                                             |
+ | QuickTle is free software: you can redistribute it and/or modify            |
+ | it under the terms of the GNU Lesser General Public License as published by |
+ | the Free Software Foundation, either version 3 of the License, or           |
+ | (at your option) any later version.                                         |
+ |                                                                             |
+ | QuickTle is distributed in the hope that it will be useful,                 |
+ | but WITHOUT ANY WARRANTY; without even the implied warranty of              |
+ | MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               |
+ | GNU Lesser General Public License for more details.                         |
+ |                                                                             |
+ | You should have received a copy of the GNU Lesser General Public License    |
+ | along with QuickTle. If not, see <http://www.gnu.org/licenses/>.            |
+ +----------------------------------------------------------------------------*/
+/*!
+    \file station.h
+    \brief File contains the definition of quicktle::Station class.
+*/
+
+#ifndef TLESTATION_H
+#define TLESTATION_H
+
+namespace quicktle
+{
+
+/*!
+    \brief Ground station, specified by its geodetic coordinates.
+
+    The Earth-fixed position and the local East-North-Up basis are
+    computed once in the constructor, so the look angles to any number
+    of satellites cost only a few multiply-adds each.
+*/
+class Station
+{
+public:
+    Station(); //!< Default constructor: station at zero latitude and longitude
+    /*!
+        \brief Constructor
+        \param latitude - geodetic latitude [Radians]
+        \param longitude - longitude [Radians]
+        \param altitude - altitude above WGS-84 ellipsoid [m]
+        \param minElevation - minimal elevation of visible satellite [Radians]
+    */
+    Station(double latitude, double longitude, double altitude = 0,
+            double minElevation = 0);
+    //! Get geodetic latitude [Radians]
+    double latitude() const;
+    //! Get longitude [Radians]
+    double longitude() const;
+    //! Get altitude above WGS-84 ellipsoid [m]
+    double altitude() const;
+    //! Get minimal elevation of visible satellite [Radians]
+    double minElevation() const;
+    //! Get 3 Earth-fixed coordinates of the station [m]
+    const double* position() const;
+    //! Get the unit vector to the local zenith (Earth-fixed)
+    const double* up() const;
+    //! Get the unit vector to the local east (Earth-fixed)
+    const double* east() const;
+    //! Get the unit vector to the local north (Earth-fixed)
+    const double* north() const;
+    /*!
+        \brief Get the elevation of the point
+        \param ecef - 3 Earth-fixed coordinates of the point [m]
+        \return Elevation [-M_PI / 2, M_PI / 2] [Radians]
+    */
+    double elevation(const double *ecef) const;
+    /*!
+        \brief Get the look angles and the range to the point
+        \param ecef - 3 Earth-fixed coordinates of the point [m]
+        \param azimuth - buffer for azimuth [0, 2 * M_PI), measured from
+                         the north to the east [Radians]
+        \param elevation - buffer for elevation [Radians]
+        \param range - buffer for range [m]
+    */
+    void lookAngles(const double *ecef, double &azimuth, double &elevation,
+                    double &range) const;
+
+private:
+    void init();
+
+    double m_latitude;
+    double m_longitude;
+    double m_altitude;
+    double m_minElevation;
+    double m_position[3];
+    double m_up[3];
+    double m_east[3];
+    double m_north[3];
+};
+
+} // namespace quicktle
+
+#endif // TLESTATION_H
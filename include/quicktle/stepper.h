@@ -0,0 +1,173 @@
+/*-----------------------------------------------------------------------------+
+ | QuickTle                                                                    |
+ | Copyright 2011-2015 Sergei Fundaev                                          |
+ +-----------------------------------------------------------------------------+
+ | This file is part of QuickTle library.                                      |
+ |                                                                             |
+ | QuickTle is free software: you can redistribute it and/or modify            |
+ | it under the terms of the GNU Lesser General Public License as published by |
+ | the Free Software Foundation, either version 3 of the License, or           |
+ | (at your option) any later version.                                         |
+ |                                                                             |
+ | QuickTle is distributed in the hope that it will be useful,                 |
+ | but WITHOUT ANY WARRANTY; without even the implied warranty of              |
+ | MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               |
+ | GNU Lesser General Public License for more details.                         |
+ |                                                                             |
+ | You should have received a copy of the GNU Lesser General Public License    |
+ | along with QuickTle. If not, see <http://www.gnu.org/licenses/>.            |
+ +----------------------------------------------------------------------------*/
+/*!
+    \file stepper.h
+    \brief File contains the definition of quicktle::CatalogStepper class.
+*/
+
+#ifndef TLESTEPPER_H
+#define TLESTEPPER_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <vector>
+#include <quicktle/node.h>
+#include <quicktle/fastmath.h>
+
+namespace quicktle
+{
+
+/*!
+    \brief Fixed-step two-body propagation of the whole catalog.
+
+    The propagation state of the satellites (mean and eccentric anomalies
+    and the orbit constants) is kept in the separate arrays and advanced
+    in place by one step per tick: the mean anomaly is incremented by
+    n * step, and the Kepler equation is solved by Newton's method,
+    started from the previous eccentric anomaly plus its last increment.
+    Usually one or two iterations are enough, so the tick cost is close
+    to the cost of reading the state and writing the positions. The
+    satellites are processed in chunks in parallel.
+
+    The positions of each tick are written into a free buffer, which is
+    published when the tick is completed. A reader takes the published
+    buffer with snapshot() and holds it until release(): the held buffers
+    are never written, and the ticks go on into the other ones, so the
+    readers in other threads need neither locking nor retries, however
+    slow they are. A new buffer is allocated only when all of them are
+    held. advance() and the setters should be called from one thread at
+    a time, and the snapshots are released before setCatalog().
+
+    The rounding error of the incremented mean anomaly grows as the
+    number of ticks times 4e-16 radians, i.e. less than 1 m after 1e8
+    ticks for the low orbits.
+*/
+class CatalogStepper
+{
+public:
+    //! Published positions of one tick
+    struct Snapshot
+    {
+        std::uint64_t tick;  //!< number of the tick (0 - initial state)
+        double t;            //!< time [s from Jan 1, 1970]
+        const double *x;     //!< X coordinates of the satellites [m]
+        const double *y;     //!< Y coordinates of the satellites [m]
+        const double *z;     //!< Z coordinates of the satellites [m]
+        const void *buffer;  //!< buffer, held until release()
+    };
+
+    CatalogStepper(); //!< Default constructor.
+    /*!
+        \brief Constructor
+        \param catalog - satellites
+        \param start - time of the initial state [s from Jan 1, 1970]
+        \param step - time step of one tick [s]
+    */
+    CatalogStepper(const std::vector<Node> &catalog, double start,
+                   double step);
+    /*!
+        \brief Set the satellites and compute their initial state; it is
+               published as tick 0.
+        \param catalog - satellites
+        \param start - time of the initial state [s from Jan 1, 1970]
+    */
+    void setCatalog(const std::vector<Node> &catalog, double start);
+    //! Get the number of satellites
+    std::size_t size() const;
+    //! Get the time step of one tick [s]
+    double step() const;
+    //! Set the time step of one tick [s]; it applies from the next tick.
+    void setStep(double step);
+    //! Get the accuracy of the elementary functions
+    MathMode mathMode() const;
+    //! Set the accuracy of the elementary functions
+    void setMathMode(MathMode mode);
+    //! Get the number of threads (0 - number of available cores)
+    unsigned threads() const;
+    //! Set the number of threads (0 - number of available cores)
+    void setThreads(unsigned threads);
+    //! Advance all the satellites by one step and publish the positions
+    void advance();
+    //! Get the number of the last published tick
+    std::uint64_t tick() const;
+    //! Get the time of the last published tick [s from Jan 1, 1970]
+    double time() const;
+    /*!
+        \brief Get the positions of the last published tick. Their buffer
+               is not overwritten until the snapshot is released.
+    */
+    Snapshot snapshot() const;
+    //! Release the buffer of the snapshot
+    void release(const Snapshot &snapshot) const;
+
+private:
+    CatalogStepper(const CatalogStepper&);            //!< Copying is unavailable.
+    CatalogStepper& operator=(const CatalogStepper&); //!< Copying is unavailable.
+
+    //! Positions of one tick
+    struct Buffer
+    {
+        Buffer();
+        std::uint64_t tick;
+        double t;
+        std::vector<double> x;
+        std::vector<double> y;
+        std::vector<double> z;
+        mutable std::atomic<unsigned> readers;  //!< holding snapshots
+    };
+
+    //! Advance the satellites [first, last) into the given buffer
+    template <typename SinCos>
+    void advanceChunk(std::size_t first, std::size_t last, bool initial,
+                      Buffer &buffer);
+    //! Compute the given buffer on the pool
+    void compute(bool initial, Buffer &buffer);
+    //! Get the published buffer and hold it
+    Buffer& acquire() const;
+    //! Get a buffer, which is neither published nor held
+    Buffer& freeBuffer();
+
+    // State of the satellites
+    std::vector<double> m_M;   //!< mean anomaly [0, 2 * M_PI)
+    std::vector<double> m_E;   //!< eccentric anomaly
+    std::vector<double> m_dE;  //!< increment of E at the last tick
+    std::vector<double> m_n;   //!< mean motion [rad/s]
+    std::vector<double> m_e;
+    std::vector<double> m_a;   //!< semi-major axis
+    std::vector<double> m_b;   //!< semi-minor axis
+    std::vector<double> m_P[3];  //!< unit vector to the perigee
+    std::vector<double> m_Q[3];  //!< unit vector normal to m_P in the plane
+
+    // Output; the buffers are added by advance() only
+    std::deque<Buffer> m_buffers;
+    std::atomic<Buffer*> m_published;  //!< buffer of the last completed tick
+
+    double m_start;    //!< time of m_startTick
+    double m_step;
+    std::uint64_t m_startTick;  //!< tick of the last change of the step
+    MathMode m_mathMode;
+    unsigned m_threads;
+};
+
+} // namespace quicktle
+
+#endif // TLESTEPPER_H
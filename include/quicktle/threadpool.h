@@ -0,0 +1,145 @@
+/*-----------------------------------------------------------------------------+
+ | QuickTle                                                                    |
+ | Copyright 2011-2015 Sergei Fundaev                                          |
+ +-----------------------------------------------------------------------------+
+ | This file is part of QuickTle library.                                      |
+ |                                                                             |
+ | QuickTle is free software: you can redistribute it and/or modify            |
+ | it under the terms of the GNU Lesser General Public License as published by |
+ | the Free Software Foundation, either version 3 of the License, or           |
+ | (at your option) any later version.                                         |
+ |                                                                             |
+ | QuickTle is distributed in the hope that it will be useful,                 |
+ | but WITHOUT ANY WARRANTY; without even the implied warranty of              |
+ | MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               |
+ | GNU Lesser General Public License for more details.                         |
+ |                                                                             |
+ | You should have received a copy of the GNU Lesser General Public License    |
+ | along with QuickTle. If not, see <http://www.gnu.org/licenses/>.            |
+ +----------------------------------------------------------------------------*/
+/*!
+    \file threadpool.h
+    \brief File contains the definition of quicktle::ThreadPool class
+           and the functions for parallel processing of satellite catalogs.
+*/
+
+#ifndef TLETHREADPOOL_H
+#define TLETHREADPOOL_H
+
+#include <cstddef>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <quicktle/node.h>
+
+namespace quicktle
+{
+
+/*!
+    \brief Work-stealing pool of threads.
+
+    Each thread has its own queue of chunks. The chunks of a job are
+    distributed over the queues in contiguous blocks; a thread takes the
+    chunks from the front of its own queue and, when it is empty, steals
+    from the back of the other queues, so the uneven cost of the chunks
+    is balanced. Each chunk covers its own range of indices, so the
+    result does not depend on the order of execution.
+
+    A job, limited to fewer threads than the pool has, is queued as that
+    number of workers, which take the chunks of the job in turn. So the
+    users of the library share one pool and do not oversubscribe the
+    cores, whatever number of threads each of them asks for.
+*/
+class ThreadPool
+{
+public:
+    //! Task, processing the range [first, last) of indices
+    typedef std::function<void (std::size_t first, std::size_t last)> Task;
+
+    /*!
+        \brief Constructor
+        \param threads - number of threads (0 - number of available cores)
+    */
+    explicit ThreadPool(unsigned threads = 0);
+    //! Destructor: waits for the threads to finish.
+    ~ThreadPool();
+    //! Get the number of threads
+    unsigned size() const;
+    /*!
+        \brief Run the task over [0, count), split into the chunks,
+               and wait for completion. The call from a thread of the
+               same pool runs the task in the calling thread.
+        \param count - number of indices
+        \param grain - maximal number of indices in one chunk
+        \param task - the task
+        \param workers - maximal number of threads, running the task at
+                         once (0 - all threads of the pool)
+    */
+    void parallelFor(std::size_t count, std::size_t grain, const Task &task,
+                     unsigned workers = 0);
+    //! Get the pool, shared by the library; it uses all available cores.
+    static ThreadPool& instance();
+
+private:
+    ThreadPool(const ThreadPool&);            //!< Copying is unavailable.
+    ThreadPool& operator=(const ThreadPool&); //!< Copying is unavailable.
+
+    struct Job;
+    struct Chunk
+    {
+        Job *job;
+        std::size_t first;
+        std::size_t last;   //!< first == last: worker of a limited job
+    };
+    struct Queue
+    {
+        std::mutex mutex;
+        std::deque<Chunk> chunks;
+    };
+
+    bool take(unsigned index, Chunk &chunk);
+    void execute(const Chunk &chunk);
+    void run(unsigned index);
+
+    std::vector<std::thread> m_threads;
+    std::vector< std::unique_ptr<Queue> > m_queues;
+    std::mutex m_mutex;
+    std::condition_variable m_wakeup;
+    std::size_t m_pending;   //!< Number of queued chunks
+    bool m_stop;
+};
+
+/*!
+    \brief Call the function for each satellite of the catalog in parallel.
+    \param catalog - satellites
+    \param function - function(index, node)
+    \param threads - number of threads (0 - number of available cores)
+*/
+void forEachSatellite(const std::vector<Node> &catalog,
+                      const std::function<void (std::size_t,
+                                                const Node&)> &function,
+                      unsigned threads = 0);
+
+/*!
+    \brief Compute the positions (and velocities) of all satellites of the
+           catalog at the given times in parallel. The satellites are split
+           into the chunks, which output fits into the processor cache.
+    \param catalog - satellites
+    \param times - times [s from Jan 1, 1970]
+    \param positions - output: X, Y, Z of satellite k at time j are at
+                       positions[3 * (k * times.size() + j)]
+    \param velocities - output of velocities in the same layout; may be null
+    \param threads - number of threads (0 - number of available cores)
+*/
+void propagateAll(const std::vector<Node> &catalog,
+                  const std::vector<double> &times,
+                  std::vector<double> &positions,
+                  std::vector<double> *velocities = 0, unsigned threads = 0);
+
+} // namespace quicktle
+
+#endif // TLETHREADPOOL_H
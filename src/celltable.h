@@ -0,0 +1,121 @@
+/*-----------------------------------------------------------------------------+
+ | QuickTle                                                                    |
+ | Copyright 2011-2015 Sergei Fundaev                                          |
+ +-----------------------------------------------------------------------------+
+ | This file is part of QuickTle library.                                      |
+ |                                                                             |
+ | QuickTle is free software: you can redistribute it and/or modify            |
+ | it under the terms of the GNU Lesser General Public License as published by |
+ | the Free Software Foundation, either version 3 of the License, or           |
+ | (at your option) any later version.                                         |
+ |                                                                             |
+ | QuickTle is distributed in the hope that it will be useful,                 |
+ | but WITHOUT ANY WARRANTY; without even the implied warranty of              |
+ | MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               |
+ | GNU Lesser General Public License for more details.                         |
+ |                                                                             |
+ | You should have received a copy of the GNU Lesser General Public License    |
+ | along with QuickTle. If not, see <http://www.gnu.org/licenses/>.            |
+ +----------------------------------------------------------------------------*/
+/*!
+    \file celltable.h
+    \brief File contains the hash table of cubic cells, shared by the
+           spatial searches of the library. It is not installed.
+*/
+
+#ifndef TLECELLTABLE_H
+#define TLECELLTABLE_H
+
+#define CELL_OFFSET (1 << 20)      //!< Shift of cell index to make it positive
+#define CELL_MASK ((1 << 21) - 1)
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace quicktle
+{
+
+//! Packed cell key and index of the object
+typedef std::pair<std::uint64_t, std::uint32_t> CellEntry;
+
+//! Key of empty slot of the hash table; it never matches the packed cell key
+const std::uint64_t EMPTY_CELL = ~static_cast<std::uint64_t>(0);
+
+//! Open addressing hash table: cell key -> range of sorted entries
+class CellTable
+{
+public:
+    void build(const std::vector<CellEntry> &entries)
+    {
+        std::size_t capacity = 16;
+        m_bits = 4;
+        while (capacity < 2 * entries.size())
+        {
+            capacity *= 2;
+            ++m_bits;
+        }
+        m_keys.assign(capacity, EMPTY_CELL);
+        m_begin.resize(capacity);
+        m_end.resize(capacity);
+
+        for (std::size_t k = 0; k < entries.size(); )
+        {
+            std::size_t j = k;
+            while (j < entries.size() && entries[j].first == entries[k].first)
+                ++j;
+            std::size_t slot = hash(entries[k].first);
+            while (m_keys[slot] != EMPTY_CELL)
+                slot = (slot + 1) & (capacity - 1);
+            m_keys[slot] = entries[k].first;
+            m_begin[slot] = static_cast<std::uint32_t>(k);
+            m_end[slot] = static_cast<std::uint32_t>(j);
+            k = j;
+        }
+    }
+    bool find(std::uint64_t key, std::uint32_t &begin,
+              std::uint32_t &end) const
+    {
+        if (m_keys.empty())
+            return false;
+        std::size_t slot = hash(key);
+        while (m_keys[slot] != EMPTY_CELL)
+        {
+            if (m_keys[slot] == key)
+            {
+                begin = m_begin[slot];
+                end = m_end[slot];
+                return true;
+            }
+            slot = (slot + 1) & (m_keys.size() - 1);
+        }
+        return false;
+    }
+
+private:
+    std::size_t hash(std::uint64_t key) const
+    {
+        return static_cast<std::size_t>(
+                    (key * 0x9E3779B97F4A7C15ULL) >> (64 - m_bits));
+    }
+
+    std::vector<std::uint64_t> m_keys;
+    std::vector<std::uint32_t> m_begin;
+    std::vector<std::uint32_t> m_end;
+    int m_bits;
+};
+//------------------------------------------------------------------------------
+
+//! Pack three cell indices into one key
+inline std::uint64_t cellKey(std::int64_t ix, std::int64_t iy, std::int64_t iz)
+{
+    return (static_cast<std::uint64_t>((ix + CELL_OFFSET) & CELL_MASK) << 42)
+         | (static_cast<std::uint64_t>((iy + CELL_OFFSET) & CELL_MASK) << 21)
+         | static_cast<std::uint64_t>((iz + CELL_OFFSET) & CELL_MASK);
+}
+//------------------------------------------------------------------------------
+
+} // namespace quicktle
+
+#endif // TLECELLTABLE_H
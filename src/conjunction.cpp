@@ -0,0 +1,434 @@
+/*-----------------------------------------------------------------------------+
+ | QuickTle                                                                    |
+ | Copyright 2011-2015 Sergei Fundaev                                          |
+ +-----------------------------------------------------------------------------+
+ | This file is part of QuickTle library.                                      |
+ |                                                                             |
+ | QuickTle is free software: you can redistribute it and/or modify            |
+ | it under the terms of the GNU Lesser General Public License as published by |
+ | the Free Software Foundation, either version 3 of the License, or           |
+ | (at your option) any later version.                                         |
+ |                                                                             |
+ | QuickTle is distributed in the hope that it will be useful,                 |
+ | but WITHOUT ANY WARRANTY; without even the implied warranty of              |
+ | MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               |
+ | GNU Lesser General Public License for more details.                         |
+ |                                                                             |
+ | You should have received a copy of the GNU Lesser General Public License    |
+ | along with QuickTle. If not, see <http://www.gnu.org/licenses/>.            |
+ +----------------------------------------------------------------------------*/
+/*!
+    \file conjunction.cpp
+    \brief File contains the realization of methods of
+           quicktle::ConjunctionScreener class.
+*/
+
+#define GM 3.986004418e14
+#define DEFAULT_THRESHOLD 10e3
+#define DEFAULT_STEP 30.
+#define DEFAULT_TOLERANCE 1e-3
+#define SLICE_SAMPLES 16           //!< Number of time steps in one task
+#define MAX_REFINE_ITERATIONS 100
+
+#include <cmath>
+#include <cstdint>
+#include <algorithm>
+#include <utility>
+#include <quicktle/conjunction.h>
+#include <quicktle/threadpool.h>
+#include "celltable.h"
+
+namespace quicktle
+{
+
+namespace
+{
+
+//! Half of the neighbouring cells: each pair of cells is visited once
+const int HALF_NEIGHBOURS[13][3] = {
+    {1, -1, -1}, {1, -1, 0}, {1, -1, 1}, {1, 0, -1}, {1, 0, 0}, {1, 0, 1},
+    {1, 1, -1}, {1, 1, 0}, {1, 1, 1}, {0, 1, -1}, {0, 1, 0}, {0, 1, 1},
+    {0, 0, 1}
+};
+//------------------------------------------------------------------------------
+
+//! Order of conjunctions: by pair of objects, then by time
+bool earlierPair(const Conjunction &c1, const Conjunction &c2)
+{
+    if (c1.primary != c2.primary)
+        return c1.primary < c2.primary;
+    if (c1.secondary != c2.secondary)
+        return c1.secondary < c2.secondary;
+    return c1.tca < c2.tca;
+}
+//------------------------------------------------------------------------------
+
+//! Order of conjunctions: by miss distance
+bool closerConjunction(const Conjunction &c1, const Conjunction &c2)
+{
+    if (c1.distance != c2.distance)
+        return c1.distance < c2.distance;
+    return earlierPair(c1, c2);
+}
+//------------------------------------------------------------------------------
+
+} // namespace
+
+ConjunctionScreener::ConjunctionScreener()
+    : m_threshold(DEFAULT_THRESHOLD), m_step(DEFAULT_STEP),
+      m_tolerance(DEFAULT_TOLERANCE), m_threads(0)
+{
+}
+//------------------------------------------------------------------------------
+
+ConjunctionScreener::ConjunctionScreener(const std::vector<Node> &catalog)
+    : m_threshold(DEFAULT_THRESHOLD), m_step(DEFAULT_STEP),
+      m_tolerance(DEFAULT_TOLERANCE), m_threads(0)
+{
+    setCatalog(catalog);
+}
+//------------------------------------------------------------------------------
+
+void ConjunctionScreener::setCatalog(const std::vector<Node> &catalog)
+{
+    m_propagators.resize(catalog.size());
+    m_shells.resize(catalog.size());
+    for (std::size_t k = 0; k < catalog.size(); ++k)
+    {
+        const Node &node = catalog[k];
+        m_propagators[k].assign(node);
+
+        double a = node.a();
+        double e = node.e();
+        m_shells[k].perigee = a * (1 - e);
+        m_shells[k].apogee = a * (1 + e);
+        m_shells[k].maxSpeed = sqrt(GM / a * (1 + e) / (1 - e));
+    }
+}
+//------------------------------------------------------------------------------
+
+double ConjunctionScreener::threshold() const
+{
+    return m_threshold;
+}
+//------------------------------------------------------------------------------
+
+void ConjunctionScreener::setThreshold(double threshold)
+{
+    m_threshold = threshold;
+}
+//------------------------------------------------------------------------------
+
+double ConjunctionScreener::step() const
+{
+    return m_step;
+}
+//------------------------------------------------------------------------------
+
+void ConjunctionScreener::setStep(double step)
+{
+    m_step = step;
+}
+//------------------------------------------------------------------------------
+
+double ConjunctionScreener::tolerance() const
+{
+    return m_tolerance;
+}
+//------------------------------------------------------------------------------
+
+void ConjunctionScreener::setTolerance(double tolerance)
+{
+    m_tolerance = tolerance;
+}
+//------------------------------------------------------------------------------
+
+unsigned ConjunctionScreener::threads() const
+{
+    return m_threads;
+}
+//------------------------------------------------------------------------------
+
+void ConjunctionScreener::setThreads(unsigned threads)
+{
+    m_threads = threads;
+}
+//------------------------------------------------------------------------------
+
+std::vector<Conjunction> ConjunctionScreener::screen(double start,
+                                                     double stop) const
+{
+    std::vector<Conjunction> conjunctions;
+    const std::size_t count = Propagator::samples(start, stop, m_step);
+    if (!count || m_shells.size() < 2)
+        return conjunctions;
+
+    // Prefilter: keep the objects, which shell overlaps with any other shell
+    std::vector<std::size_t> order(m_shells.size());
+    for (std::size_t k = 0; k < order.size(); ++k)
+        order[k] = k;
+    std::sort(order.begin(), order.end(),
+              [this](std::size_t k1, std::size_t k2)
+              {
+                  return m_shells[k1].perigee < m_shells[k2].perigee;
+              });
+    std::vector<std::size_t> objects;
+    double maxApogee = -1;
+    for (std::size_t k = 0; k < order.size(); ++k)
+    {
+        const Shell &shell = m_shells[order[k]];
+        bool overlaps = shell.perigee - m_threshold <= maxApogee;
+        if (k + 1 < order.size())
+        {
+            overlaps = overlaps || m_shells[order[k + 1]].perigee
+                                   - m_threshold <= shell.apogee;
+        }
+        if (overlaps)
+            objects.push_back(order[k]);
+        maxApogee = std::max(maxApogee, shell.apogee);
+    }
+    std::sort(objects.begin(), objects.end());
+    if (objects.size() < 2)
+        return conjunctions;
+
+    // Parallel processing of time slices
+    const std::size_t slices = (count + SLICE_SAMPLES - 1) / SLICE_SAMPLES;
+    std::vector< std::vector<Conjunction> > results(slices);
+    ThreadPool &pool = ThreadPool::instance();
+    pool.parallelFor(slices, 1, [&](std::size_t firstSlice,
+                                    std::size_t lastSlice)
+    {
+        std::vector<double> buffer;
+        for (std::size_t s = firstSlice; s < lastSlice; ++s)
+        {
+            std::size_t first = s * SLICE_SAMPLES;
+            std::size_t last = std::min(first + SLICE_SAMPLES, count);
+            screenSlice(objects, start, stop, first, last, buffer,
+                        results[s]);
+        }
+    }, m_threads);
+
+    for (std::size_t k = 0; k < slices; ++k)
+    {
+        conjunctions.insert(conjunctions.end(), results[k].begin(),
+                            results[k].end());
+    }
+
+    // The same approach may be found from the neighbouring samples
+    std::sort(conjunctions.begin(), conjunctions.end(), earlierPair);
+    std::size_t unique = 0;
+    for (std::size_t k = 0; k < conjunctions.size(); ++k)
+    {
+        if (unique
+            && conjunctions[unique - 1].primary == conjunctions[k].primary
+            && conjunctions[unique - 1].secondary == conjunctions[k].secondary
+            && conjunctions[k].tca - conjunctions[unique - 1].tca < m_step)
+        {
+            continue;
+        }
+        conjunctions[unique++] = conjunctions[k];
+    }
+    conjunctions.resize(unique);
+    std::sort(conjunctions.begin(), conjunctions.end(), closerConjunction);
+
+    return conjunctions;
+}
+//------------------------------------------------------------------------------
+
+void ConjunctionScreener::screenSlice(const std::vector<std::size_t> &objects,
+                                      double start, double stop,
+                                      std::size_t first, std::size_t last,
+                                      std::vector<double> &buffer,
+                                      std::vector<Conjunction> &result) const
+{
+    const std::size_t n = objects.size();
+    const std::size_t samples = last - first;
+
+    // Positions of each object on the slice: x[samples], y[samples], ...
+    buffer.resize(3 * n * samples);
+    double maxSpeed = 0;
+    for (std::size_t k = 0; k < n; ++k)
+    {
+        double *x = &buffer[3 * k * samples];
+        m_propagators[objects[k]].propagate(start + first * m_step, m_step,
+                                            samples, x, x + samples,
+                                            x + 2 * samples);
+        maxSpeed = std::max(maxSpeed, m_shells[objects[k]].maxSpeed);
+    }
+
+    // Any pair of objects, which may come closer than the threshold within
+    // half of step from the sample, is in the neighbouring cells
+    const double cell = m_threshold + maxSpeed * m_step;
+    std::vector<CellEntry> entries(n);
+    CellTable table;
+
+    for (std::size_t j = 0; j < samples; ++j)
+    {
+        const double t = start + (first + j) * m_step;
+        for (std::size_t k = 0; k < n; ++k)
+        {
+            const double *x = &buffer[3 * k * samples + j];
+            entries[k].first = cellKey(
+                        static_cast<std::int64_t>(floor(x[0] / cell)),
+                        static_cast<std::int64_t>(floor(x[samples] / cell)),
+                        static_cast<std::int64_t>(floor(x[2 * samples] / cell)));
+            entries[k].second = static_cast<std::uint32_t>(k);
+        }
+        std::sort(entries.begin(), entries.end());
+        table.build(entries);
+
+        // Compare the objects k1 and k2 (indices in the objects list)
+        auto check = [&](std::uint32_t k1, std::uint32_t k2)
+        {
+            std::size_t object1 = objects[std::min(k1, k2)];
+            std::size_t object2 = objects[std::max(k1, k2)];
+            const Shell &shell1 = m_shells[object1];
+            const Shell &shell2 = m_shells[object2];
+            if (shell1.perigee - m_threshold > shell2.apogee
+                || shell2.perigee - m_threshold > shell1.apogee)
+            {
+                return;
+            }
+
+            const double *p1 = &buffer[3 * k1 * samples + j];
+            const double *p2 = &buffer[3 * k2 * samples + j];
+            double dx = p1[0] - p2[0];
+            double dy = p1[samples] - p2[samples];
+            double dz = p1[2 * samples] - p2[2 * samples];
+            double bound = m_threshold
+                         + (shell1.maxSpeed + shell2.maxSpeed) * m_step / 2;
+            if (dx * dx + dy * dy + dz * dz > bound * bound)
+                return;
+
+            Conjunction conjunction;
+            const double a = std::max(start, t - m_step);
+            const double b = std::min(stop, t + m_step);
+            if (refine(object1, object2, a, b, a == start, b == stop,
+                       conjunction)
+                && conjunction.distance <= m_threshold)
+            {
+                result.push_back(conjunction);
+            }
+        };
+
+        for (std::size_t k = 0; k < n; )
+        {
+            std::size_t end = k;
+            while (end < n && entries[end].first == entries[k].first)
+                ++end;
+
+            // Pairs in the same cell
+            for (std::size_t k1 = k; k1 < end; ++k1)
+            {
+                for (std::size_t k2 = k1 + 1; k2 < end; ++k2)
+                    check(entries[k1].second, entries[k2].second);
+            }
+
+            // Pairs in the neighbouring cells
+            std::uint64_t key = entries[k].first;
+            std::int64_t ix = static_cast<std::int64_t>((key >> 42) & CELL_MASK);
+            std::int64_t iy = static_cast<std::int64_t>((key >> 21) & CELL_MASK);
+            std::int64_t iz = static_cast<std::int64_t>(key & CELL_MASK);
+            for (int d = 0; d < 13; ++d)
+            {
+                std::uint32_t begin2, end2;
+                if (!table.find(cellKey(ix + HALF_NEIGHBOURS[d][0] - CELL_OFFSET,
+                                        iy + HALF_NEIGHBOURS[d][1] - CELL_OFFSET,
+                                        iz + HALF_NEIGHBOURS[d][2] - CELL_OFFSET),
+                                begin2, end2))
+                {
+                    continue;
+                }
+                for (std::size_t k1 = k; k1 < end; ++k1)
+                {
+                    for (std::size_t k2 = begin2; k2 < end2; ++k2)
+                        check(entries[k1].second, entries[k2].second);
+                }
+            }
+
+            k = end;
+        }
+    }
+}
+//------------------------------------------------------------------------------
+
+bool ConjunctionScreener::refine(std::size_t primary, std::size_t secondary,
+                                 double a, double b, bool startEdge,
+                                 bool stopEdge, Conjunction &conjunction) const
+{
+    const Propagator &propagator1 = m_propagators[primary];
+    const Propagator &propagator2 = m_propagators[secondary];
+
+    // Range rate (multiplied by the range) and its root
+    double dr[3], dv[3];
+    auto rangeRate = [&](double t)
+    {
+        double r1[3], v1[3], r2[3], v2[3];
+        propagator1.state(t, r1, v1);
+        propagator2.state(t, r2, v2);
+        for (int k = 0; k < 3; ++k)
+        {
+            dr[k] = r1[k] - r2[k];
+            dv[k] = v1[k] - v2[k];
+        }
+        return dr[0] * dv[0] + dr[1] * dv[1] + dr[2] * dv[2];
+    };
+
+    double fa = rangeRate(a);
+    const double rangeA = dr[0] * dr[0] + dr[1] * dr[1] + dr[2] * dr[2];
+    double fb = rangeRate(b);
+    const double rangeB = dr[0] * dr[0] + dr[1] * dr[1] + dr[2] * dr[2];
+
+    double t = a;
+    if (fa < 0 && fb > 0)
+    {
+        // Illinois modification of the regula falsi method
+        double previous = b;
+        int side = 0;
+        for (int k = 0; k < MAX_REFINE_ITERATIONS
+                        && fabs(t - previous) > m_tolerance; ++k)
+        {
+            previous = t;
+            t = b - fb * (b - a) / (fb - fa);
+            double ft = rangeRate(t);
+            if (ft < 0)
+            {
+                a = t;
+                fa = ft;
+                if (side == -1)
+                    fb /= 2;
+                side = -1;
+            }
+            else
+            {
+                b = t;
+                fb = ft;
+                if (side == 1)
+                    fa /= 2;
+                side = 1;
+            }
+        }
+    }
+    else
+    {
+        // No minimum inside: the objects are closest at an end, which
+        // is the approach, if the screening interval ends there too
+        const bool atStart = startEdge && fa >= 0;
+        const bool atStop = stopEdge && fb <= 0;
+        if (!atStart && !atStop)
+            return false;
+        t = atStart && (!atStop || rangeA <= rangeB) ? a : b;
+    }
+
+    rangeRate(t);
+    conjunction.primary = primary;
+    conjunction.secondary = secondary;
+    conjunction.tca = t;
+    conjunction.distance = sqrt(dr[0] * dr[0] + dr[1] * dr[1] + dr[2] * dr[2]);
+    conjunction.relativeSpeed = sqrt(dv[0] * dv[0] + dv[1] * dv[1]
+                                     + dv[2] * dv[2]);
+    return true;
+}
+//------------------------------------------------------------------------------
+
+}  // namespace quicktle
@@ -0,0 +1,333 @@
+/*-----------------------------------------------------------------------------+
+ | QuickTle                                                                    |
+ | Copyright 2011-2015 Sergei Fundaev                                          |
+ +-----------------------------------------------------------------------------+
+ | This file is part of QuickTle library.                                      |
+ |                                                                             |
+ | QuickTle is free software: you can redistribute it and/or modify            |
+ | it under the terms of the GNU Lesser General Public License as published by |
+ | the Free Software Foundation, either version 3 of the License, or           |
+ | (at your option) any later version.                                         |
+ |                                                                             |
+ | QuickTle is distributed in the hope that it will be useful,                 |
+ | but WITHOUT ANY WARRANTY; without even the implied warranty of              |
+ | MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               |
+ | GNU Lesser General Public License for more details.                         |
+ |                                                                             |
+ | You should have received a copy of the GNU Lesser General Public License    |
+ | along with QuickTle. If not, see <http://www.gnu.org/licenses/>.            |
+ +----------------------------------------------------------------------------*/
+/*!
+    \file coordinates.cpp
+    \brief File contains the realization of methods of quicktle::EarthRotation
+           class and the functions for batch coordinate conversion.
+*/
+
+#define SECS_IN_DAY 86400
+#define UNIX_EPOCH_JD 2440587.5      //!< Julian date of Jan 1, 1970
+#define J2000_JD 2451545.0
+#define DAYS_IN_CENTURY 36525.
+#define SIDEREAL_RATE 7.2921158553e-5 //!< Earth rotation rate [rad/s]
+#define WGS84_A 6378137.
+#define WGS84_F (1 / 298.257223563)
+#define GEODETIC_ITERATIONS 2
+#define MAX_ANGLE (2 * M_PI)
+
+#include <cmath>
+#include <quicktle/coordinates.h>
+#include <quicktle/func.h>
+
+namespace quicktle
+{
+
+static const double WGS84_B = WGS84_A * (1 - WGS84_F);
+static const double WGS84_E2 = WGS84_F * (2 - WGS84_F);
+static const double WGS84_EP2 = WGS84_E2 / (1 - WGS84_E2);
+
+/*!
+    \brief Convert one Earth-fixed point into geodetic coordinates.
+    \see ecef2geodetic()
+*/
+template <typename Real>
+static inline void toGeodetic(Real x, Real y, Real z,
+                              Real &latitude, Real &longitude, Real &altitude)
+{
+    const Real A = static_cast<Real>(WGS84_A);
+    const Real B = static_cast<Real>(WGS84_B);
+    const Real F = static_cast<Real>(WGS84_F);
+    const Real E2 = static_cast<Real>(WGS84_E2);
+    const Real EP2 = static_cast<Real>(WGS84_EP2);
+
+    Real p = std::sqrt(x * x + y * y);
+    longitude = std::atan2(y, x);
+
+    // Parametric latitude: initial Bowring's guess
+    Real cb = p * B;
+    Real sb = z * A;
+    Real l = std::sqrt(cb * cb + sb * sb);
+    if (l == 0)
+    {
+        // Center of the Earth
+        latitude = 0;
+        altitude = -A;
+        return;
+    }
+    cb /= l;
+    sb /= l;
+
+    Real num = 0, den = 0, sphi = 0, cphi = 0;
+    for (int k = 0; k < GEODETIC_ITERATIONS; ++k)
+    {
+        num = z + EP2 * B * sb * sb * sb;
+        den = p - E2 * A * cb * cb * cb;
+        l = std::sqrt(num * num + den * den);
+        sphi = num / l;
+        cphi = den / l;
+
+        // tan(beta) = (1 - f) * tan(phi)
+        cb = cphi;
+        sb = (1 - F) * sphi;
+        l = std::sqrt(cb * cb + sb * sb);
+        cb /= l;
+        sb /= l;
+    }
+
+    latitude = std::atan2(num, den);
+    altitude = p * cphi + z * sphi - A * std::sqrt(1 - E2 * sphi * sphi);
+}
+//------------------------------------------------------------------------------
+
+//! Rotate the arrays of geocentric inertial coordinates by the sidereal angle
+template <typename Real>
+static inline void rotate(double c, double s, std::size_t count,
+                          const Real *x, const Real *y, const Real *z,
+                          Real *xe, Real *ye, Real *ze)
+{
+    const Real cr = static_cast<Real>(c);
+    const Real sr = static_cast<Real>(s);
+    for (std::size_t k = 0; k < count; ++k)
+    {
+        Real xk = x[k];
+        Real yk = y[k];
+        xe[k] = cr * xk + sr * yk;
+        ye[k] = -sr * xk + cr * yk;
+        ze[k] = z[k];
+    }
+}
+//------------------------------------------------------------------------------
+
+//! Rotate the arrays by the sidereal angle and convert them to geodetic
+template <typename Real>
+static inline void rotateToGeodetic(double c, double s, std::size_t count,
+                                    const Real *x, const Real *y,
+                                    const Real *z, Real *latitude,
+                                    Real *longitude, Real *altitude)
+{
+    const Real cr = static_cast<Real>(c);
+    const Real sr = static_cast<Real>(s);
+    for (std::size_t k = 0; k < count; ++k)
+    {
+        toGeodetic(cr * x[k] + sr * y[k], -sr * x[k] + cr * y[k], z[k],
+                   latitude[k], longitude[k], altitude[k]);
+    }
+}
+//------------------------------------------------------------------------------
+
+//! eci2ecef() on the uniform time grid in the given precision
+template <typename Real>
+static void gridToEcef(double start, double step, std::size_t count,
+                       const Real *x, const Real *y, const Real *z,
+                       Real *xe, Real *ye, Real *ze)
+{
+    // The angle is kept in double: it grows with the time
+    const double theta0 = gmst(start);
+    const double dTheta = SIDEREAL_RATE * step;
+    for (std::size_t k = 0; k < count; ++k)
+    {
+        double theta = theta0 + k * dTheta;
+        rotate(cos(theta), sin(theta), 1, x + k, y + k, z + k,
+               xe + k, ye + k, ze + k);
+    }
+}
+//------------------------------------------------------------------------------
+
+//! eci2geodetic() on the uniform time grid in the given precision
+template <typename Real>
+static void gridToGeodetic(double start, double step, std::size_t count,
+                           const Real *x, const Real *y, const Real *z,
+                           Real *latitude, Real *longitude, Real *altitude)
+{
+    const double theta0 = gmst(start);
+    const double dTheta = SIDEREAL_RATE * step;
+    for (std::size_t k = 0; k < count; ++k)
+    {
+        double theta = theta0 + k * dTheta;
+        rotateToGeodetic(cos(theta), sin(theta), 1, x + k, y + k, z + k,
+                         latitude + k, longitude + k, altitude + k);
+    }
+}
+//------------------------------------------------------------------------------
+
+double julianDate(double t)
+{
+    return t / SECS_IN_DAY + UNIX_EPOCH_JD;
+}
+//------------------------------------------------------------------------------
+
+double gmst(double t)
+{
+    // Split the time to keep the precision of the large linear term
+    double days = (t - (J2000_JD - UNIX_EPOCH_JD) * SECS_IN_DAY) / SECS_IN_DAY;
+    double T = days / DAYS_IN_CENTURY;
+    double seconds = 67310.54841 + 8640184.812866 * T
+                   + 0.093104 * T * T - 6.2e-6 * T * T * T;
+    double fraction = days - floor(days);
+    seconds += fraction * SECS_IN_DAY;
+
+    return normalizeAngle(seconds * MAX_ANGLE / SECS_IN_DAY);
+}
+//------------------------------------------------------------------------------
+
+EarthRotation::EarthRotation()
+{
+    assign(0);
+}
+//------------------------------------------------------------------------------
+
+EarthRotation::EarthRotation(double t)
+{
+    assign(t);
+}
+//------------------------------------------------------------------------------
+
+void EarthRotation::assign(double t)
+{
+    m_t = t;
+    m_gmst = quicktle::gmst(t);
+    m_cos = cos(m_gmst);
+    m_sin = sin(m_gmst);
+}
+//------------------------------------------------------------------------------
+
+double EarthRotation::time() const
+{
+    return m_t;
+}
+//------------------------------------------------------------------------------
+
+double EarthRotation::gmst() const
+{
+    return m_gmst;
+}
+//------------------------------------------------------------------------------
+
+void EarthRotation::eci2ecef(const double *eci, double *ecef) const
+{
+    double x = eci[0];
+    double y = eci[1];
+    ecef[0] = m_cos * x + m_sin * y;
+    ecef[1] = -m_sin * x + m_cos * y;
+    ecef[2] = eci[2];
+}
+//------------------------------------------------------------------------------
+
+void EarthRotation::eci2ecef(std::size_t count,
+                             const double *x, const double *y, const double *z,
+                             double *xe, double *ye, double *ze) const
+{
+    rotate(m_cos, m_sin, count, x, y, z, xe, ye, ze);
+}
+//------------------------------------------------------------------------------
+
+void EarthRotation::eci2ecef(std::size_t count,
+                             const float *x, const float *y, const float *z,
+                             float *xe, float *ye, float *ze) const
+{
+    rotate(m_cos, m_sin, count, x, y, z, xe, ye, ze);
+}
+//------------------------------------------------------------------------------
+
+void EarthRotation::eci2geodetic(std::size_t count,
+                                 const double *x, const double *y,
+                                 const double *z, double *latitude,
+                                 double *longitude, double *altitude) const
+{
+    rotateToGeodetic(m_cos, m_sin, count, x, y, z,
+                     latitude, longitude, altitude);
+}
+//------------------------------------------------------------------------------
+
+void EarthRotation::eci2geodetic(std::size_t count,
+                                 const float *x, const float *y,
+                                 const float *z, float *latitude,
+                                 float *longitude, float *altitude) const
+{
+    rotateToGeodetic(m_cos, m_sin, count, x, y, z,
+                     latitude, longitude, altitude);
+}
+//------------------------------------------------------------------------------
+
+void geodetic2ecef(double latitude, double longitude, double altitude,
+                   double *ecef)
+{
+    double sphi = sin(latitude);
+    double cphi = cos(latitude);
+    double N = WGS84_A / sqrt(1 - WGS84_E2 * sphi * sphi);
+
+    ecef[0] = (N + altitude) * cphi * cos(longitude);
+    ecef[1] = (N + altitude) * cphi * sin(longitude);
+    ecef[2] = (N * (1 - WGS84_E2) + altitude) * sphi;
+}
+//------------------------------------------------------------------------------
+
+void ecef2geodetic(std::size_t count,
+                   const double *x, const double *y, const double *z,
+                   double *latitude, double *longitude, double *altitude)
+{
+    for (std::size_t k = 0; k < count; ++k)
+        toGeodetic(x[k], y[k], z[k], latitude[k], longitude[k], altitude[k]);
+}
+//------------------------------------------------------------------------------
+
+void ecef2geodetic(std::size_t count,
+                   const float *x, const float *y, const float *z,
+                   float *latitude, float *longitude, float *altitude)
+{
+    for (std::size_t k = 0; k < count; ++k)
+        toGeodetic(x[k], y[k], z[k], latitude[k], longitude[k], altitude[k]);
+}
+//------------------------------------------------------------------------------
+
+void eci2ecef(double start, double step, std::size_t count,
+              const double *x, const double *y, const double *z,
+              double *xe, double *ye, double *ze)
+{
+    gridToEcef(start, step, count, x, y, z, xe, ye, ze);
+}
+//------------------------------------------------------------------------------
+
+void eci2ecef(double start, double step, std::size_t count,
+              const float *x, const float *y, const float *z,
+              float *xe, float *ye, float *ze)
+{
+    gridToEcef(start, step, count, x, y, z, xe, ye, ze);
+}
+//------------------------------------------------------------------------------
+
+void eci2geodetic(double start, double step, std::size_t count,
+                  const double *x, const double *y, const double *z,
+                  double *latitude, double *longitude, double *altitude)
+{
+    gridToGeodetic(start, step, count, x, y, z, latitude, longitude, altitude);
+}
+//------------------------------------------------------------------------------
+
+void eci2geodetic(double start, double step, std::size_t count,
+                  const float *x, const float *y, const float *z,
+                  float *latitude, float *longitude, float *altitude)
+{
+    gridToGeodetic(start, step, count, x, y, z, latitude, longitude, altitude);
+}
+//------------------------------------------------------------------------------
+
+}  // namespace quicktle
@@ -0,0 +1,318 @@
+/*-----------------------------------------------------------------------------+
+ | QuickTle                                                                    |
+ | Copyright 2011-2015 Sergei Fundaev                                          |
+ +-----------------------------------------------------------------------------+
+ | This file is part of QuickTle library.                                      |
+ |                                                                             |
+ | QuickTle is free software: you can redistribute it and/or modify            |
+ | it under the terms of the GNU Lesser General Public License as published by |
+ | the Free Software Foundation, either version 3 of the License, or           |
+ | (at your option) any later version.                                         |
+ |                                                                             |
+ | QuickTle is distributed in the hope that it will be useful,                 |
+ | but WITHOUT ANY WARRANTY; without even the implied warranty of              |
+ | MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               |
+ | GNU Lesser General Public License for more details.                         |
+ |                                                                             |
+ | You should have received a copy of the GNU Lesser General Public License    |
+ | along with QuickTle. If not, see <http://www.gnu.org/licenses/>.            |
+ +----------------------------------------------------------------------------*/
+/*!
+    \file coverage.cpp
+    \brief File contains the realization of methods of
+           quicktle::CoverageGrid class.
+*/
+
+#define EARTH_RADIUS 6371e3          //!< Mean radius of the Earth [m]
+#define DEFAULT_RESOLUTION (M_PI / 180)
+#define DEFAULT_STEP 60.
+#define BLOCK_SAMPLES 64             //!< Number of time steps in one block
+#define BAND_ROWS 4                  //!< Number of rows in one task
+
+#include <cmath>
+#include <algorithm>
+#include <quicktle/coverage.h>
+#include <quicktle/coordinates.h>
+#include <quicktle/threadpool.h>
+
+namespace quicktle
+{
+
+CoverageGrid::CoverageGrid()
+    : m_minElevation(0), m_step(DEFAULT_STEP), m_threads(0)
+{
+    setResolution(DEFAULT_RESOLUTION);
+}
+//------------------------------------------------------------------------------
+
+CoverageGrid::CoverageGrid(double resolution)
+    : m_minElevation(0), m_step(DEFAULT_STEP), m_threads(0)
+{
+    setResolution(resolution);
+}
+//------------------------------------------------------------------------------
+
+double CoverageGrid::resolution() const
+{
+    return m_resolution;
+}
+//------------------------------------------------------------------------------
+
+void CoverageGrid::setResolution(double resolution)
+{
+    m_rows = std::max<std::size_t>(1, std::size_t(floor(M_PI / resolution +
+                                                         0.5)));
+    m_columns = 2 * m_rows;
+    m_resolution = M_PI / m_rows;
+    m_coverageTime.clear();
+    m_meanVisible.clear();
+    m_maxVisible.clear();
+}
+//------------------------------------------------------------------------------
+
+std::size_t CoverageGrid::rows() const
+{
+    return m_rows;
+}
+//------------------------------------------------------------------------------
+
+std::size_t CoverageGrid::columns() const
+{
+    return m_columns;
+}
+//------------------------------------------------------------------------------
+
+double CoverageGrid::latitude(std::size_t row) const
+{
+    return -M_PI_2 + (row + 0.5) * m_resolution;
+}
+//------------------------------------------------------------------------------
+
+double CoverageGrid::longitude(std::size_t column) const
+{
+    return -M_PI + (column + 0.5) * m_resolution;
+}
+//------------------------------------------------------------------------------
+
+void CoverageGrid::setSatellites(const std::vector<Node> &satellites)
+{
+    m_propagators.resize(satellites.size());
+    for (std::size_t k = 0; k < satellites.size(); ++k)
+        m_propagators[k].assign(satellites[k]);
+}
+//------------------------------------------------------------------------------
+
+double CoverageGrid::minElevation() const
+{
+    return m_minElevation;
+}
+//------------------------------------------------------------------------------
+
+void CoverageGrid::setMinElevation(double minElevation)
+{
+    m_minElevation = minElevation;
+}
+//------------------------------------------------------------------------------
+
+double CoverageGrid::step() const
+{
+    return m_step;
+}
+//------------------------------------------------------------------------------
+
+void CoverageGrid::setStep(double step)
+{
+    m_step = step;
+}
+//------------------------------------------------------------------------------
+
+unsigned CoverageGrid::threads() const
+{
+    return m_threads;
+}
+//------------------------------------------------------------------------------
+
+void CoverageGrid::setThreads(unsigned threads)
+{
+    m_threads = threads;
+}
+//------------------------------------------------------------------------------
+
+const double* CoverageGrid::coverageTime() const
+{
+    return m_coverageTime.empty() ? 0 : &m_coverageTime[0];
+}
+//------------------------------------------------------------------------------
+
+const double* CoverageGrid::meanVisible() const
+{
+    return m_meanVisible.empty() ? 0 : &m_meanVisible[0];
+}
+//------------------------------------------------------------------------------
+
+const unsigned* CoverageGrid::maxVisible() const
+{
+    return m_maxVisible.empty() ? 0 : &m_maxVisible[0];
+}
+//------------------------------------------------------------------------------
+
+void CoverageGrid::footprints(double start, std::size_t first,
+                              std::size_t count, std::size_t satellite,
+                              std::vector<Footprint> &result) const
+{
+    const std::size_t satellites = m_propagators.size();
+    const double t0 = start + first * m_step;
+    const double cosElevation = cos(m_minElevation);
+    double x[BLOCK_SAMPLES], y[BLOCK_SAMPLES], z[BLOCK_SAMPLES];
+    m_propagators[satellite].propagate(t0, m_step, count, x, y, z);
+    eci2ecef(t0, m_step, count, x, y, z, x, y, z);
+
+    for (std::size_t j = 0; j < count; ++j)
+    {
+        Footprint &footprint = result[j * satellites + satellite];
+        double r = sqrt(x[j] * x[j] + y[j] * y[j] + z[j] * z[j]);
+        double c = EARTH_RADIUS * cosElevation / r;
+        if (c >= 1)
+        {
+            footprint.firstRow = 1;
+            footprint.lastRow = 0;
+            continue;
+        }
+        footprint.latitude = asin(z[j] / r);
+        footprint.longitude = atan2(y[j], x[j]);
+        footprint.radius = acos(c) - m_minElevation;
+
+        // Rows, which centers are within the radius from the latitude
+        double south = (footprint.latitude - footprint.radius + M_PI_2) /
+                       m_resolution - 0.5;
+        double north = (footprint.latitude + footprint.radius + M_PI_2) /
+                       m_resolution - 0.5;
+        footprint.firstRow = std::max(0, int(ceil(south)));
+        footprint.lastRow = std::min(int(m_rows) - 1, int(floor(north)));
+    }
+}
+//------------------------------------------------------------------------------
+
+void CoverageGrid::rasterize(const std::vector<Footprint> &footprints,
+                             std::size_t samples, const double *weights,
+                             std::size_t firstRow, std::size_t lastRow,
+                             std::size_t sample,
+                             std::vector<std::size_t> &stamps,
+                             std::vector<unsigned> &counts)
+{
+    const std::size_t satellites = m_propagators.size();
+    const int columns = int(m_columns);
+    for (std::size_t j = 0; j < samples; ++j)
+    {
+        const std::size_t stamp = sample + j + 1;
+        const double weight = weights[j];
+        for (std::size_t k = 0; k < satellites; ++k)
+        {
+            const Footprint &footprint = footprints[j * satellites + k];
+            int first = std::max(footprint.firstRow, int(firstRow));
+            int last = std::min(footprint.lastRow, int(lastRow) - 1);
+            if (last < first)
+                continue;
+
+            const double sinLatitude = sin(footprint.latitude);
+            const double cosLatitude = cos(footprint.latitude);
+            const double cosRadius = cos(footprint.radius);
+            for (int row = first; row <= last; ++row)
+            {
+                // Longitude span of the cap at the latitude of the row
+                double phi = latitude(row);
+                double denominator = cos(phi) * cosLatitude;
+                double cosSpan = denominator > 1e-12
+                        ? (cosRadius - sin(phi) * sinLatitude) / denominator
+                        : -1;
+                if (cosSpan >= 1)
+                    continue;
+                int west = 0, east = columns - 1;
+                if (cosSpan > -1)
+                {
+                    double span = acos(cosSpan);
+                    west = int(ceil((footprint.longitude - span + M_PI) /
+                                    m_resolution - 0.5));
+                    east = int(floor((footprint.longitude + span + M_PI) /
+                                     m_resolution - 0.5));
+                    if (east - west + 1 >= columns)
+                    {
+                        west = 0;
+                        east = columns - 1;
+                    }
+                }
+
+                std::size_t offset = std::size_t(row) * m_columns;
+                for (int column = west; column <= east; ++column)
+                {
+                    int wrapped = column < 0 ? column + columns
+                                             : (column >= columns
+                                                ? column - columns : column);
+                    std::size_t cell = offset + wrapped;
+                    if (stamps[cell] != stamp)
+                    {
+                        stamps[cell] = stamp;
+                        counts[cell] = 0;
+                        m_coverageTime[cell] += weight;
+                    }
+                    ++counts[cell];
+                    m_meanVisible[cell] += weight;
+                    if (counts[cell] > m_maxVisible[cell])
+                        m_maxVisible[cell] = counts[cell];
+                }
+            }
+        }
+    }
+}
+//------------------------------------------------------------------------------
+
+void CoverageGrid::compute(double start, double stop)
+{
+    const std::size_t cells = m_rows * m_columns;
+    m_coverageTime.assign(cells, 0);
+    m_meanVisible.assign(cells, 0);
+    m_maxVisible.assign(cells, 0);
+    if (stop <= start || m_step <= 0 || m_propagators.empty())
+        return;
+
+    ThreadPool &pool = ThreadPool::instance();
+
+    const std::size_t satellites = m_propagators.size();
+    const std::size_t total = std::size_t(ceil((stop - start) / m_step));
+    std::vector<std::size_t> stamps(cells, 0);
+    std::vector<unsigned> counts(cells, 0);
+    std::vector<Footprint> result(BLOCK_SAMPLES * satellites);
+    double weights[BLOCK_SAMPLES];
+    for (std::size_t block = 0; block < total; block += BLOCK_SAMPLES)
+    {
+        const std::size_t count = std::min<std::size_t>(BLOCK_SAMPLES,
+                                                        total - block);
+        for (std::size_t j = 0; j < count; ++j)
+        {
+            weights[j] = std::min(m_step,
+                                  stop - (start + (block + j) * m_step));
+        }
+
+        pool.parallelFor(satellites, 16,
+                         [&](std::size_t first, std::size_t last)
+                         {
+                             for (std::size_t k = first; k < last; ++k)
+                             {
+                                 footprints(start, block, count, k, result);
+                             }
+                         }, m_threads);
+        pool.parallelFor(m_rows, BAND_ROWS,
+                         [&](std::size_t first, std::size_t last)
+                         {
+                             rasterize(result, count, weights, first, last,
+                                       block, stamps, counts);
+                         }, m_threads);
+    }
+
+    const double duration = stop - start;
+    for (std::size_t cell = 0; cell < cells; ++cell)
+        m_meanVisible[cell] /= duration;
+}
+//------------------------------------------------------------------------------
+
+}  // namespace quicktle
@@ -22,11 +22,40 @@
     \brief File contains the realization of methods of quicktle::DataSet class
 */
 
+#include <atomic>
+#include <limits>
 #include <quicktle/dataset.h>
 
 namespace quicktle
 {
 
+namespace
+{
+
+//! Last revision, given to a data set
+std::atomic<unsigned long long> lastRevision(0);
+
+} // namespace
+
+DataSet::Cursor::Cursor()
+    : m_revision(0), m_propagatorValid(false), m_governedBegin(0),
+      m_governedEnd(0), m_bracketValid(false), m_bracket(0)
+{
+}
+//------------------------------------------------------------------------------
+
+DataSet::DataSet()
+    : m_interpolation(NearestNode), m_revision(++lastRevision)
+{
+}
+//------------------------------------------------------------------------------
+
+void DataSet::touch()
+{
+    m_revision = ++lastRevision;
+}
+//------------------------------------------------------------------------------
+
 DataSet& DataSet::append(const Node &node)
 {
     bool found = false;
@@ -39,6 +68,7 @@ DataSet& DataSet::append(const Node &node)
     else
         m_data.insert(m_data.begin() + index, node);
 
+    touch();
 	return *this;
 }
 //------------------------------------------------------------------------------
@@ -95,6 +125,7 @@ bool DataSet::remove(const Node &node)
         return false;
 
     m_data.erase(m_data.begin() + index);
+    touch();
     return true;
 }
 //------------------------------------------------------------------------------
@@ -129,6 +160,171 @@ const Node& DataSet::nearestNode(const time_t &t) const
 void DataSet::clear()
 {
     m_data.clear();
+    touch();
+}
+//------------------------------------------------------------------------------
+
+DataSet::IndexType DataSet::nearestIndex(double t) const
+{
+    // The first node with the epoch after t
+    IndexType begin = 0;
+    IndexType end = m_data.size();
+    while (begin < end)
+    {
+        IndexType middle = begin + (end - begin) / 2;
+        if (m_data[middle].preciseEpoch() <= t)
+            begin = middle + 1;
+        else
+            end = middle;
+    }
+
+    if (end == m_data.size())
+        return end - 1;
+    if (end > 0 && t - m_data[end - 1].preciseEpoch()
+                   < m_data[end].preciseEpoch() - t)
+    {
+        return end - 1;
+    }
+    return end;
+}
+//------------------------------------------------------------------------------
+
+const Propagator& DataSet::propagatorAt(Cursor &cursor, double t) const
+{
+    if (cursor.m_propagatorValid && t >= cursor.m_governedBegin
+        && t < cursor.m_governedEnd)
+    {
+        return cursor.m_propagator;
+    }
+
+    const IndexType index = nearestIndex(t);
+    cursor.m_propagator.assign(m_data[index]);
+    cursor.m_governedBegin = -std::numeric_limits<double>::infinity();
+    cursor.m_governedEnd = std::numeric_limits<double>::infinity();
+    if (index > 0)
+    {
+        cursor.m_governedBegin = (m_data[index - 1].preciseEpoch()
+                                  + m_data[index].preciseEpoch()) / 2;
+    }
+    if (index + 1 < m_data.size())
+    {
+        cursor.m_governedEnd = (m_data[index].preciseEpoch()
+                                + m_data[index + 1].preciseEpoch()) / 2;
+    }
+    cursor.m_propagatorValid = true;
+
+    return cursor.m_propagator;
+}
+//------------------------------------------------------------------------------
+
+DataSet::Interpolation DataSet::interpolation() const
+{
+    return m_interpolation;
+}
+//------------------------------------------------------------------------------
+
+void DataSet::setInterpolation(Interpolation interpolation)
+{
+    m_interpolation = interpolation;
+}
+//------------------------------------------------------------------------------
+
+void DataSet::blendedState(Cursor &cursor, double t, double *position,
+                           double *velocity) const
+{
+    const IndexType size = m_data.size();
+    if (size == 1 || t <= m_data[0].preciseEpoch()
+        || t >= m_data[size - 1].preciseEpoch())
+    {
+        propagatorAt(cursor, t).state(t, position, velocity);
+        return;
+    }
+
+    if (!cursor.m_bracketValid || t < m_data[cursor.m_bracket].preciseEpoch()
+        || t >= m_data[cursor.m_bracket + 1].preciseEpoch())
+    {
+        // The last node with the epoch not after t
+        IndexType begin = 0;
+        IndexType end = size;
+        while (begin < end)
+        {
+            IndexType middle = begin + (end - begin) / 2;
+            if (m_data[middle].preciseEpoch() <= t)
+                begin = middle + 1;
+            else
+                end = middle;
+        }
+        IndexType bracket = end - 1;
+
+        // Moving forward the right orbit becomes the left one
+        if (cursor.m_bracketValid && bracket == cursor.m_bracket + 1)
+            cursor.m_left = cursor.m_right;
+        else
+            cursor.m_left.assign(m_data[bracket]);
+        cursor.m_right.assign(m_data[bracket + 1]);
+        cursor.m_bracket = bracket;
+        cursor.m_bracketValid = true;
+    }
+
+    const double t0 = m_data[cursor.m_bracket].preciseEpoch();
+    const double dt = m_data[cursor.m_bracket + 1].preciseEpoch() - t0;
+    const double s = (t - t0) / dt;
+    const double w = s * s * (3 - 2 * s);
+    const double dw = 6 * s * (1 - s) / dt;
+
+    double r0[3], r1[3], v0[3], v1[3];
+    cursor.m_left.state(t, r0, velocity ? v0 : 0);
+    cursor.m_right.state(t, r1, velocity ? v1 : 0);
+    for (int k = 0; k < 3; ++k)
+    {
+        position[k] = r0[k] + w * (r1[k] - r0[k]);
+        if (velocity)
+            velocity[k] = v0[k] + w * (v1[k] - v0[k]) + dw * (r1[k] - r0[k]);
+    }
+}
+//------------------------------------------------------------------------------
+
+bool DataSet::stateAt(double t, double *position, double *velocity) const
+{
+    Cursor cursor;
+    return stateAt(cursor, t, position, velocity);
+}
+//------------------------------------------------------------------------------
+
+bool DataSet::stateAt(Cursor &cursor, double t, double *position,
+                      double *velocity) const
+{
+    if (m_data.empty())
+        return false;
+
+    if (cursor.m_revision != m_revision)
+    {
+        cursor.m_revision = m_revision;
+        cursor.m_propagatorValid = false;
+        cursor.m_bracketValid = false;
+    }
+
+    if (m_interpolation == HermiteBlend)
+        blendedState(cursor, t, position, velocity);
+    else
+        propagatorAt(cursor, t).state(t, position, velocity);
+    return true;
+}
+//------------------------------------------------------------------------------
+
+bool DataSet::statesAt(std::size_t count, const double *times,
+                       double *positions, double *velocities) const
+{
+    if (m_data.empty())
+        return false;
+
+    Cursor cursor;
+    for (std::size_t k = 0; k < count; ++k)
+    {
+        stateAt(cursor, times[k], positions + 3 * k,
+                velocities ? velocities + 3 * k : 0);
+    }
+    return true;
 }
 //------------------------------------------------------------------------------
 
@@ -0,0 +1,136 @@
+/*-----------------------------------------------------------------------------+
+ | QuickTle                                                                    |
+ | Copyright 2011-2015 Sergei Fundaev                                          |
+ +-----------------------------------------------------------------------------+
+ | This file is part of QuickTle library.                                      |
+ |                                                                             |
+ | QuickTle is free software: you can redistribute it and/or modify            |
+ | it under the terms of the GNU Lesser General Public License as published by |
+ | the Free Software Foundation, either version 3 of the License, or           |
+ | (at your option) any later version.                                         |
+ |                                                                             |
+ | QuickTle is distributed in the hope that it will be useful,                 |
+ | but WITHOUT ANY WARRANTY; without even the implied warranty of              |
+ | MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               |
+ | GNU Lesser General Public License for more details.                         |
+ |                                                                             |
+ | You should have received a copy of the GNU Lesser General Public License    |
+ | along with QuickTle. If not, see <http://www.gnu.org/licenses/>.            |
+ +----------------------------------------------------------------------------*/
+/*!
+    \file doppler.cpp
+    \brief File contains the realization of the functions for the range-rate
+           and Doppler profiles.
+*/
+
+#define SIDEREAL_RATE 7.2921158553e-5 //!< Earth rotation rate [rad/s]
+#define SPEED_OF_LIGHT 299792458.     //!< Speed of light [m/s]
+#define BLOCK_SAMPLES 256
+
+#include <cmath>
+#include <quicktle/doppler.h>
+#include <quicktle/propagator.h>
+#include <quicktle/coordinates.h>
+
+namespace quicktle
+{
+
+//! Range-rate profile with the given propagator
+static void profile(const Station &station, const Propagator &propagator,
+                    double start, double step, std::size_t count,
+                    double *range, double *rangeRate)
+{
+    const double *p = station.position();
+    double x[BLOCK_SAMPLES], y[BLOCK_SAMPLES], z[BLOCK_SAMPLES];
+    double vx[BLOCK_SAMPLES], vy[BLOCK_SAMPLES], vz[BLOCK_SAMPLES];
+    for (std::size_t block = 0; block < count; block += BLOCK_SAMPLES)
+    {
+        std::size_t size = count - block;
+        if (size > BLOCK_SAMPLES)
+            size = BLOCK_SAMPLES;
+        const double t = start + block * step;
+        propagator.propagate(t, step, size, x, y, z, vx, vy, vz);
+        eci2ecef(t, step, size, x, y, z, x, y, z);
+        eci2ecef(t, step, size, vx, vy, vz, vx, vy, vz);
+
+        for (std::size_t j = 0; j < size; ++j)
+        {
+            // Velocity relative to the rotating frame
+            double u = vx[j] + SIDEREAL_RATE * y[j];
+            double v = vy[j] - SIDEREAL_RATE * x[j];
+            double dx = x[j] - p[0];
+            double dy = y[j] - p[1];
+            double dz = z[j] - p[2];
+            double d = sqrt(dx * dx + dy * dy + dz * dz);
+            if (range)
+                range[block + j] = d;
+            rangeRate[block + j] = (dx * u + dy * v + dz * vz[j]) / d;
+        }
+    }
+}
+//------------------------------------------------------------------------------
+
+void rangeRateProfile(const Station &station, const Node &satellite,
+                      double start, double step, std::size_t count,
+                      double *range, double *rangeRate)
+{
+    profile(station, Propagator(satellite), start, step, count, range,
+            rangeRate);
+}
+//------------------------------------------------------------------------------
+
+void dopplerShift(std::size_t count, const double *rangeRate,
+                  double frequency, double *shift)
+{
+    const double scale = -frequency / SPEED_OF_LIGHT;
+    for (std::size_t k = 0; k < count; ++k)
+        shift[k] = scale * rangeRate[k];
+}
+//------------------------------------------------------------------------------
+
+std::size_t passProfileOffsets(const std::vector<Pass> &passes, double step,
+                               std::vector<std::size_t> &offsets)
+{
+    offsets.resize(passes.size());
+    std::size_t total = 0;
+    for (std::size_t k = 0; k < passes.size(); ++k)
+    {
+        offsets[k] = total;
+        double duration = passes[k].set - passes[k].rise;
+        if (duration >= 0)
+            total += std::size_t(floor(duration / step)) + 1;
+    }
+    return total;
+}
+//------------------------------------------------------------------------------
+
+void passProfiles(const std::vector<Station> &stations,
+                  const std::vector<Node> &satellites,
+                  const std::vector<Pass> &passes, double step,
+                  double *range, double *rangeRate, unsigned threads)
+{
+    std::vector<std::size_t> offsets;
+    const std::size_t total = passProfileOffsets(passes, step, offsets);
+
+    // The nodes are parsed here, so the threads use the propagators only
+    std::vector<Propagator> propagators(satellites.size());
+    for (std::size_t k = 0; k < satellites.size(); ++k)
+        propagators[k].assign(satellites[k]);
+
+    ThreadPool &pool = ThreadPool::instance();
+    pool.parallelFor(passes.size(), 1,
+                     [&](std::size_t first, std::size_t last)
+    {
+        for (std::size_t k = first; k < last; ++k)
+        {
+            const Pass &pass = passes[k];
+            std::size_t end = k + 1 < passes.size() ? offsets[k + 1] : total;
+            profile(stations[pass.station], propagators[pass.satellite],
+                    pass.rise, step, end - offsets[k],
+                    range ? range + offsets[k] : 0, rangeRate + offsets[k]);
+        }
+    }, threads);
+}
+//------------------------------------------------------------------------------
+
+}  // namespace quicktle
@@ -0,0 +1,366 @@
+/*-----------------------------------------------------------------------------+
+ | QuickTle                                                                    |
+ | Copyright 2011-2015 Sergei Fundaev                                          |
+ +-----------------------------------------------------------------------------+
+ | This file is part of QuickTle library.                                      |
+ |                                                                             |
+ | QuickTle is free software: you can redistribute it and/or modify            |
+ | it under the terms of the GNU Lesser General Public License as published by |
+ | the Free Software Foundation, either version 3 of the License, or           |
+ | (at your option) any later version.                                         |
+ |                                                                             |
+ | QuickTle is distributed in the hope that it will be useful,                 |
+ | but WITHOUT ANY WARRANTY; without even the implied warranty of              |
+ | MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               |
+ | GNU Lesser General Public License for more details.                         |
+ |                                                                             |
+ | You should have received a copy of the GNU Lesser General Public License    |
+ | along with QuickTle. If not, see <http://www.gnu.org/licenses/>.            |
+ +----------------------------------------------------------------------------*/
+/*!
+    \file eclipse.cpp
+    \brief File contains the realization of the solar ephemeris, the shadow
+           tests and the methods of quicktle::EclipsePredictor class.
+*/
+
+#define EARTH_RADIUS 6378137.        //!< Equatorial radius of the Earth [m]
+#define SUN_RADIUS 695700e3          //!< Radius of the Sun [m]
+#define AU 149597870700.             //!< Astronomical unit [m]
+#define J2000_JD 2451545.
+#define DEG (M_PI / 180)
+#define DEFAULT_STEP 60.
+#define DEFAULT_TOLERANCE 1e-3
+
+#include <cmath>
+#include <algorithm>
+#include <quicktle/eclipse.h>
+#include <quicktle/coordinates.h>
+#include <quicktle/threadpool.h>
+
+namespace quicktle
+{
+
+namespace
+{
+
+//! Continuous shadow functions: negative inside the shadow
+struct ShadowFunctions
+{
+    double penumbra;
+    double umbra;
+};
+//------------------------------------------------------------------------------
+
+//! Boundary of the shadow, crossed between two samples
+struct Crossing
+{
+    double t;
+    bool umbra;    //!< Umbra or penumbra boundary
+    bool entry;    //!< Entry into the shadow or exit from it
+    //! Order by time; the simultaneous boundaries of the cylindrical shadow
+    //! are entered from the penumbra and exited from the umbra
+    bool operator<(const Crossing &other) const
+    {
+        if (t != other.t)
+            return t < other.t;
+        return (entry ? umbra : !umbra) < (other.entry ? other.umbra
+                                                        : !other.umbra);
+    }
+};
+//------------------------------------------------------------------------------
+
+} // namespace
+
+static ShadowFunctions shadowFunctions(const double *r, const double *sun,
+                                       ShadowModel model)
+{
+    ShadowFunctions f;
+    double r2 = r[0] * r[0] + r[1] * r[1] + r[2] * r[2];
+    double rLength = sqrt(r2);
+    if (model == CylindricalShadow)
+    {
+        // Distance from the shadow axis behind the Earth; the function is
+        // continuous at the terminator plane, where it equals |r| - R
+        double sunLength = sqrt(sun[0] * sun[0] + sun[1] * sun[1] +
+                                sun[2] * sun[2]);
+        double p = (r[0] * sun[0] + r[1] * sun[1] + r[2] * sun[2]) / sunLength;
+        double distance = p < 0 ? sqrt(std::max(0., r2 - p * p)) : rLength;
+        f.penumbra = f.umbra = distance - EARTH_RADIUS;
+        return f;
+    }
+
+    // Angular separation of the Sun and the Earth centres, as seen from
+    // the satellite, compared with their angular radii
+    double d[3] = {sun[0] - r[0], sun[1] - r[1], sun[2] - r[2]};
+    double dLength = sqrt(d[0] * d[0] + d[1] * d[1] + d[2] * d[2]);
+    double cosAngle = -(d[0] * r[0] + d[1] * r[1] + d[2] * r[2]) /
+                      (dLength * rLength);
+    double angle = acos(std::max(-1., std::min(1., cosAngle)));
+    double sunRadius = asin(SUN_RADIUS / dLength);
+    double earthRadius = asin(std::min(1., EARTH_RADIUS / rLength));
+    f.penumbra = angle - (earthRadius + sunRadius);
+    f.umbra = angle - (earthRadius - sunRadius);
+    return f;
+}
+//------------------------------------------------------------------------------
+
+void sunPosition(double t, double *position)
+{
+    double T = (julianDate(t) - J2000_JD) / 36525;
+    double meanLongitude = (280.460 + 36000.771 * T) * DEG;
+    double M = (357.5291092 + 35999.05034 * T) * DEG;
+    double longitude = meanLongitude + (1.914666471 * sin(M) +
+                                        0.019994643 * sin(2 * M)) * DEG;
+    double distance = (1.000140612 - 0.016708617 * cos(M) -
+                       0.000139589 * cos(2 * M)) * AU;
+    double obliquity = (23.439291 - 0.0130042 * T) * DEG;
+
+    position[0] = distance * cos(longitude);
+    position[1] = distance * cos(obliquity) * sin(longitude);
+    position[2] = distance * sin(obliquity) * sin(longitude);
+}
+//------------------------------------------------------------------------------
+
+Shadow shadow(const double *position, const double *sun, ShadowModel model)
+{
+    ShadowFunctions f = shadowFunctions(position, sun, model);
+    if (f.umbra <= 0)
+        return Umbra;
+    return f.penumbra < 0 ? Penumbra : Sunlight;
+}
+//------------------------------------------------------------------------------
+
+void betaAngles(const std::vector<Node> &catalog, double t, double *beta)
+{
+    double sun[3];
+    sunPosition(t, sun);
+    double length = sqrt(sun[0] * sun[0] + sun[1] * sun[1] + sun[2] * sun[2]);
+    for (std::size_t k = 0; k < catalog.size(); ++k)
+    {
+        // Normal of the orbit plane is the third column of the orientation
+        const double *o = catalog[k].orientation();
+        double s = (o[2] * sun[0] + o[5] * sun[1] + o[8] * sun[2]) / length;
+        beta[k] = asin(std::max(-1., std::min(1., s)));
+    }
+}
+//------------------------------------------------------------------------------
+
+EclipsePredictor::EclipsePredictor()
+    : m_model(ConicalShadow), m_step(DEFAULT_STEP),
+      m_tolerance(DEFAULT_TOLERANCE), m_threads(0)
+{
+}
+//------------------------------------------------------------------------------
+
+EclipsePredictor::EclipsePredictor(const std::vector<Node> &satellites)
+    : m_model(ConicalShadow), m_step(DEFAULT_STEP),
+      m_tolerance(DEFAULT_TOLERANCE), m_threads(0)
+{
+    setSatellites(satellites);
+}
+//------------------------------------------------------------------------------
+
+void EclipsePredictor::setSatellites(const std::vector<Node> &satellites)
+{
+    m_propagators.resize(satellites.size());
+    for (std::size_t k = 0; k < satellites.size(); ++k)
+        m_propagators[k].assign(satellites[k]);
+}
+//------------------------------------------------------------------------------
+
+ShadowModel EclipsePredictor::model() const
+{
+    return m_model;
+}
+//------------------------------------------------------------------------------
+
+void EclipsePredictor::setModel(ShadowModel model)
+{
+    m_model = model;
+}
+//------------------------------------------------------------------------------
+
+double EclipsePredictor::step() const
+{
+    return m_step;
+}
+//------------------------------------------------------------------------------
+
+void EclipsePredictor::setStep(double step)
+{
+    m_step = step;
+}
+//------------------------------------------------------------------------------
+
+double EclipsePredictor::tolerance() const
+{
+    return m_tolerance;
+}
+//------------------------------------------------------------------------------
+
+void EclipsePredictor::setTolerance(double tolerance)
+{
+    m_tolerance = tolerance;
+}
+//------------------------------------------------------------------------------
+
+unsigned EclipsePredictor::threads() const
+{
+    return m_threads;
+}
+//------------------------------------------------------------------------------
+
+void EclipsePredictor::setThreads(unsigned threads)
+{
+    m_threads = threads;
+}
+//------------------------------------------------------------------------------
+
+std::vector<Eclipse> EclipsePredictor::predict(double start, double stop) const
+{
+    std::vector<Eclipse> result;
+    if (stop < start || m_step <= 0 || m_propagators.empty())
+        return result;
+
+    // Positions of the Sun on the grid; the last sample is at the end
+    const std::size_t count = std::size_t(ceil((stop - start) / m_step)) + 1;
+    std::vector<double> sun(3 * count);
+    for (std::size_t j = 0; j < count; ++j)
+        sunPosition(j + 1 == count ? stop : start + j * m_step, &sun[3 * j]);
+
+    ThreadPool &pool = ThreadPool::instance();
+
+    std::vector< std::vector<Eclipse> > eclipses(m_propagators.size());
+    pool.parallelFor(m_propagators.size(), 1,
+                     [&](std::size_t first, std::size_t last)
+                     {
+                         for (std::size_t k = first; k < last; ++k)
+                             predictSatellite(k, start, stop, sun, eclipses[k]);
+                     }, m_threads);
+
+    for (std::size_t k = 0; k < eclipses.size(); ++k)
+        result.insert(result.end(), eclipses[k].begin(), eclipses[k].end());
+    return result;
+}
+//------------------------------------------------------------------------------
+
+void EclipsePredictor::predictSatellite(std::size_t satellite, double start,
+                                        double stop,
+                                        const std::vector<double> &sun,
+                                        std::vector<Eclipse> &result) const
+{
+    const Propagator &propagator = m_propagators[satellite];
+    const std::size_t count = sun.size() / 3;
+    std::vector<double> positions(3 * count);
+    double *x = &positions[0];
+    propagator.propagate(start, m_step, count - 1, x, x + count, x + 2 * count);
+    double r[3];
+    propagator.state(stop, r);
+    x[count - 1] = r[0];
+    x[2 * count - 1] = r[1];
+    x[3 * count - 1] = r[2];
+
+    // Bisection of the shadow function between the samples
+    auto refine = [&](double a, double b, bool umbra, bool entry)
+    {
+        while (b - a > m_tolerance)
+        {
+            double t = 0.5 * (a + b);
+            double position[3], s[3];
+            propagator.state(t, position);
+            sunPosition(t, s);
+            ShadowFunctions f = shadowFunctions(position, s, m_model);
+            bool inside = (umbra ? f.umbra : f.penumbra) < 0;
+            if (inside == entry)
+                b = t;
+            else
+                a = t;
+        }
+        return 0.5 * (a + b);
+    };
+
+    Eclipse eclipse;
+    eclipse.satellite = satellite;
+    bool inPenumbra = false, inUmbra = false;
+    double previousTime = start;
+    for (std::size_t j = 0; j < count; ++j)
+    {
+        const double t = j + 1 == count ? stop : start + j * m_step;
+        double position[3] = {x[j], x[count + j], x[2 * count + j]};
+        ShadowFunctions f = shadowFunctions(position, &sun[3 * j], m_model);
+        bool penumbra = f.penumbra < 0;
+        bool umbra = f.umbra < 0;
+
+        if (j == 0)
+        {
+            if (penumbra)
+            {
+                eclipse.penumbraEntry = start;
+                eclipse.umbra = umbra;
+                eclipse.umbraEntry = umbra ? start : 0;
+                eclipse.umbraExit = 0;
+            }
+            inPenumbra = penumbra;
+            inUmbra = umbra;
+            continue;
+        }
+
+        Crossing crossings[2];
+        int crossingsCount = 0;
+        if (penumbra != inPenumbra)
+        {
+            Crossing &c = crossings[crossingsCount++];
+            c.t = refine(previousTime, t, false, penumbra);
+            c.umbra = false;
+            c.entry = penumbra;
+        }
+        if (umbra != inUmbra)
+        {
+            Crossing &c = crossings[crossingsCount++];
+            c.t = refine(previousTime, t, true, umbra);
+            c.umbra = true;
+            c.entry = umbra;
+        }
+        std::sort(crossings, crossings + crossingsCount);
+
+        for (int c = 0; c < crossingsCount; ++c)
+        {
+            const Crossing &crossing = crossings[c];
+            if (!crossing.umbra && crossing.entry)
+            {
+                eclipse.penumbraEntry = crossing.t;
+                eclipse.umbra = false;
+                eclipse.umbraEntry = eclipse.umbraExit = 0;
+            }
+            else if (crossing.umbra && crossing.entry)
+            {
+                eclipse.umbra = true;
+                eclipse.umbraEntry = crossing.t;
+            }
+            else if (crossing.umbra)
+            {
+                eclipse.umbraExit = crossing.t;
+            }
+            else
+            {
+                eclipse.penumbraExit = crossing.t;
+                result.push_back(eclipse);
+            }
+        }
+
+        inPenumbra = penumbra;
+        inUmbra = umbra;
+        previousTime = t;
+    }
+
+    if (inPenumbra)
+    {
+        if (inUmbra)
+            eclipse.umbraExit = stop;
+        eclipse.penumbraExit = stop;
+        result.push_back(eclipse);
+    }
+}
+//------------------------------------------------------------------------------
+
+}  // namespace quicktle
@@ -0,0 +1,158 @@
+/*-----------------------------------------------------------------------------+
+ | QuickTle                                                                    |
+ | Copyright 2011-2015 Sergei Fundaev                                          |
+ +-----------------------------------------------------------------------------+
+ | This file is part of QuickTle library.                                      |
+ |                                                                             |
+ | QuickTle is free software: you can redistribute it and/or modify            |
+ | it under the terms of the GNU Lesser General Public License as published by |
+ | the Free Software Foundation, either version 3 of the License, or           |
+ | (at your option) any later version.                                         |
+ |                                                                             |
+ | QuickTle is distributed in the hope that it will be useful,                 |
+ | but WITHOUT ANY WARRANTY; without even the implied warranty of              |
+ | MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               |
+ | GNU Lesser General Public License for more details.                         |
+ |                                                                             |
+ | You should have received a copy of the GNU Lesser General Public License    |
+ | along with QuickTle. If not, see <http://www.gnu.org/licenses/>.            |
+ +----------------------------------------------------------------------------*/
+/*!
+    \file elements.cpp
+    \brief File contains the realization of the functions for conversion
+           of the state vectors into the orbital elements.
+*/
+
+#define GM 3.986004418e14
+#define MAX_ANGLE (2 * M_PI)
+#define SMALL_ECCENTRICITY 1e-11
+#define SMALL_NODE 1e-11      //!< sin(i), below which the orbit is equatorial
+
+#include <cmath>
+#include <quicktle/elements.h>
+#include <quicktle/func.h>
+
+namespace quicktle
+{
+
+//! Elements of one state
+struct Elements
+{
+    double n;
+    double e;
+    double i;
+    double Omega;
+    double omega;
+    double M;
+};
+
+//! Convert one state into the elements
+static inline void toElements(const double *r, const double *v,
+                              Elements &elements)
+{
+    double h[3] = {r[1] * v[2] - r[2] * v[1],
+                   r[2] * v[0] - r[0] * v[2],
+                   r[0] * v[1] - r[1] * v[0]};
+    double hxy = sqrt(h[0] * h[0] + h[1] * h[1]);
+    double hh = sqrt(hxy * hxy + h[2] * h[2]);
+    double rr = sqrt(r[0] * r[0] + r[1] * r[1] + r[2] * r[2]);
+    double vv = v[0] * v[0] + v[1] * v[1] + v[2] * v[2];
+    double rv = r[0] * v[0] + r[1] * v[1] + r[2] * v[2];
+
+    elements.i = atan2(hxy, h[2]);
+
+    // Basis of the orbit plane: P to the ascending node, Q = h x P
+    double P[3], Q[3];
+    if (hxy > SMALL_NODE * hh)
+    {
+        elements.Omega = normalizeAngle(atan2(h[0], -h[1]));
+        P[0] = -h[1] / hxy;
+        P[1] = h[0] / hxy;
+    }
+    else
+    {
+        elements.Omega = 0;
+        P[0] = 1;
+        P[1] = 0;
+    }
+    P[2] = 0;
+    Q[0] = (h[1] * P[2] - h[2] * P[1]) / hh;
+    Q[1] = (h[2] * P[0] - h[0] * P[2]) / hh;
+    Q[2] = (h[0] * P[1] - h[1] * P[0]) / hh;
+
+    // Eccentricity vector
+    double ev[3];
+    for (int k = 0; k < 3; ++k)
+        ev[k] = ((vv - GM / rr) * r[k] - rv * v[k]) / GM;
+    double eP = ev[0] * P[0] + ev[1] * P[1] + ev[2] * P[2];
+    double eQ = ev[0] * Q[0] + ev[1] * Q[1] + ev[2] * Q[2];
+    elements.e = sqrt(eP * eP + eQ * eQ);
+
+    // Argument of latitude, argument of perigee and true anomaly
+    double u = atan2(r[0] * Q[0] + r[1] * Q[1] + r[2] * Q[2],
+                     r[0] * P[0] + r[1] * P[1] + r[2] * P[2]);
+    elements.omega = elements.e > SMALL_ECCENTRICITY
+                     ? normalizeAngle(atan2(eQ, eP)) : 0;
+    double nu = u - elements.omega;
+
+    double inverseA = 2 / rr - vv / GM;
+    if (inverseA <= 0 || elements.e >= 1)
+    {
+        elements.n = 0;
+        elements.M = 0;
+        return;
+    }
+    elements.n = sqrt(GM * inverseA * inverseA * inverseA);
+
+    const double e = elements.e;
+    double E = atan2(sqrt(1 - e * e) * sin(nu), e + cos(nu));
+    elements.M = normalizeAngle(E - e * sin(E));
+}
+//------------------------------------------------------------------------------
+
+void rv2coe(std::size_t count,
+            const double *positions, const double *velocities,
+            double *n, double *e, double *i,
+            double *Omega, double *omega, double *M)
+{
+    for (std::size_t k = 0; k < count; ++k)
+    {
+        Elements elements;
+        toElements(positions + 3 * k, velocities + 3 * k, elements);
+        if (n)
+            n[k] = elements.n;
+        if (e)
+            e[k] = elements.e;
+        if (i)
+            i[k] = elements.i;
+        if (Omega)
+            Omega[k] = elements.Omega;
+        if (omega)
+            omega[k] = elements.omega;
+        if (M)
+            M[k] = elements.M;
+    }
+}
+//------------------------------------------------------------------------------
+
+void rv2coe(double t, const double *position, const double *velocity,
+            Node &node)
+{
+    Elements elements;
+    toElements(position, velocity, elements);
+
+    node.setPreciseEpoch(t);
+    node.setElements(elements.n, elements.e, elements.i, elements.Omega,
+                     elements.omega, elements.M);
+}
+//------------------------------------------------------------------------------
+
+void rv2coe(std::size_t count, const double *times,
+            const double *positions, const double *velocities, Node *nodes)
+{
+    for (std::size_t k = 0; k < count; ++k)
+        rv2coe(times[k], positions + 3 * k, velocities + 3 * k, nodes[k]);
+}
+//------------------------------------------------------------------------------
+
+}  // namespace quicktle
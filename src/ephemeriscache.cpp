@@ -0,0 +1,336 @@
+/*-----------------------------------------------------------------------------+
+ | QuickTle                                                                    |
+ | Copyright 2011-2015 Sergei Fundaev                                          |
+ +-----------------------------------------------------------------------------+
+ | This file is part of QuickTle library.                                      |
+ |                                                                             |
+ | QuickTle is free software: you can redistribute it and/or modify            |
+ | it under the terms of the GNU Lesser General Public License as published by |
+ | the Free Software Foundation, either version 3 of the License, or           |
+ | (at your option) any later version.                                         |
+ |                                                                             |
+ | QuickTle is distributed in the hope that it will be useful,                 |
+ | but WITHOUT ANY WARRANTY; without even the implied warranty of              |
+ | MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               |
+ | GNU Lesser General Public License for more details.                         |
+ |                                                                             |
+ | You should have received a copy of the GNU Lesser General Public License    |
+ | along with QuickTle. If not, see <http://www.gnu.org/licenses/>.            |
+ +----------------------------------------------------------------------------*/
+/*!
+    \file ephemeriscache.cpp
+    \brief File contains the realization of methods of
+           quicktle::EphemerisCache class.
+*/
+
+#define DEFAULT_TOLERANCE 1.
+#define DEFAULT_MEMORY_BUDGET (64 << 20)
+#define DEFAULT_SPAN 86400.   //!< Segment length of the non-periodic orbits
+#define MAX_HALVINGS 30
+//! Memory of one segment, including the list and the hash table nodes
+#define SEGMENT_BYTES (sizeof(Segment) + 4 * sizeof(void*) \
+                       + sizeof(SegmentKey) + sizeof(Segments::iterator))
+
+#include <cmath>
+#include <algorithm>
+#include <quicktle/ephemeriscache.h>
+
+namespace quicktle
+{
+
+std::size_t EphemerisCache::SegmentHash::operator()(
+        const SegmentKey &key) const
+{
+    return std::hash<long long>()(key.second) * 31
+           + std::hash<std::size_t>()(key.first);
+}
+//------------------------------------------------------------------------------
+
+EphemerisCache::EphemerisCache()
+    : m_tolerance(DEFAULT_TOLERANCE), m_memoryBudget(DEFAULT_MEMORY_BUDGET)
+{
+}
+//------------------------------------------------------------------------------
+
+EphemerisCache::EphemerisCache(const std::vector<Node> &catalog)
+    : m_tolerance(DEFAULT_TOLERANCE), m_memoryBudget(DEFAULT_MEMORY_BUDGET)
+{
+    setCatalog(catalog);
+}
+//------------------------------------------------------------------------------
+
+void EphemerisCache::setCatalog(const std::vector<Node> &catalog)
+{
+    clear();
+    m_satellites.resize(catalog.size());
+    for (std::size_t k = 0; k < catalog.size(); ++k)
+    {
+        m_satellites[k].propagator.assign(catalog[k]);
+        double n = catalog[k].n();
+        m_satellites[k].period = n > 0 ? 2 * M_PI / n : DEFAULT_SPAN;
+    }
+    m_last.assign(catalog.size(), m_segments.end());
+    chooseSpans();
+}
+//------------------------------------------------------------------------------
+
+std::size_t EphemerisCache::size() const
+{
+    return m_satellites.size();
+}
+//------------------------------------------------------------------------------
+
+double EphemerisCache::tolerance() const
+{
+    return m_tolerance;
+}
+//------------------------------------------------------------------------------
+
+void EphemerisCache::setTolerance(double tolerance)
+{
+    m_tolerance = tolerance;
+    clear();
+    chooseSpans();
+}
+//------------------------------------------------------------------------------
+
+std::size_t EphemerisCache::memoryBudget() const
+{
+    return m_memoryBudget;
+}
+//------------------------------------------------------------------------------
+
+void EphemerisCache::setMemoryBudget(std::size_t bytes)
+{
+    m_memoryBudget = bytes;
+    evict(0);
+}
+//------------------------------------------------------------------------------
+
+std::size_t EphemerisCache::memoryUsage() const
+{
+    return m_segments.size() * SEGMENT_BYTES;
+}
+//------------------------------------------------------------------------------
+
+std::size_t EphemerisCache::segments() const
+{
+    return m_segments.size();
+}
+//------------------------------------------------------------------------------
+
+double EphemerisCache::segmentLength(std::size_t satellite) const
+{
+    return m_satellites[satellite].span;
+}
+//------------------------------------------------------------------------------
+
+void EphemerisCache::clear()
+{
+    m_index.clear();
+    m_segments.clear();
+    m_last.assign(m_satellites.size(), m_segments.end());
+}
+//------------------------------------------------------------------------------
+
+double EphemerisCache::state(std::size_t satellite, double t,
+                             double *position, double *velocity)
+{
+    const Satellite &s = m_satellites[satellite];
+    long long index = static_cast<long long>(
+                floor((t - s.propagator.epoch()) / s.span));
+
+    Segments::iterator it = m_last[satellite];
+    if (it == m_segments.end() || it->index != index)
+    {
+        it = segmentAt(satellite, t);
+        m_last[satellite] = it;
+    }
+    if (it != m_segments.begin())
+        m_segments.splice(m_segments.begin(), m_segments, it);
+
+    // Chebyshev polynomials and their derivatives
+    const double x = (t - it->middle) * it->scale;
+    double T[Order], D[Order];
+    T[0] = 1;
+    T[1] = x;
+    D[0] = 0;
+    D[1] = 1;
+    for (int k = 2; k < Order; ++k)
+    {
+        T[k] = 2 * x * T[k - 1] - T[k - 2];
+        D[k] = 2 * T[k - 1] + 2 * x * D[k - 1] - D[k - 2];
+    }
+
+    for (int c = 0; c < 3; ++c)
+    {
+        const double *coefficients = it->coefficients[c];
+        double r = 0, v = 0;
+        for (int k = 0; k < Order; ++k)
+        {
+            r += coefficients[k] * T[k];
+            v += coefficients[k] * D[k];
+        }
+        position[c] = r;
+        if (velocity)
+            velocity[c] = v * it->scale;
+    }
+
+    return it->error;
+}
+//------------------------------------------------------------------------------
+
+double EphemerisCache::fit(const Satellite &satellite, double start,
+                           Segment &segment) const
+{
+    const double half = satellite.span / 2;
+    segment.middle = start + half;
+    segment.scale = 1 / half;
+
+    double values[Order][3];
+    for (int j = 0; j < Order; ++j)
+    {
+        double x = cos(M_PI * (j + 0.5) / Order);
+        satellite.propagator.state(segment.middle + x * half, values[j]);
+    }
+    for (int c = 0; c < 3; ++c)
+    {
+        for (int k = 0; k < Order; ++k)
+        {
+            double sum = 0;
+            for (int j = 0; j < Order; ++j)
+                sum += values[j][c] * cos(M_PI * k * (j + 0.5) / Order);
+            segment.coefficients[c][k] = (k ? 2. : 1.) * sum / Order;
+        }
+    }
+
+    // The deviation is maximal between the nodes and at the ends
+    segment.error = 0;
+    for (int j = 0; j <= Order; ++j)
+    {
+        double x = cos(M_PI * j / Order);
+        double exact[3];
+        satellite.propagator.state(segment.middle + x * half, exact);
+
+        double T0 = 1, T1 = x, d2 = 0;
+        for (int c = 0; c < 3; ++c)
+        {
+            const double *coefficients = segment.coefficients[c];
+            double r = coefficients[0] + coefficients[1] * x;
+            double Tp = T0, Tk = T1;
+            for (int k = 2; k < Order; ++k)
+            {
+                double Tn = 2 * x * Tk - Tp;
+                r += coefficients[k] * Tn;
+                Tp = Tk;
+                Tk = Tn;
+            }
+            d2 += (r - exact[c]) * (r - exact[c]);
+        }
+        segment.error = std::max(segment.error, sqrt(d2));
+    }
+
+    // The truncated terms of the converging series are below the last
+    // ones; they bound the deviation between the measured points
+    double tail2 = 0;
+    for (int c = 0; c < 3; ++c)
+    {
+        double tail = fabs(segment.coefficients[c][Order - 2])
+                      + fabs(segment.coefficients[c][Order - 1]);
+        tail2 += tail * tail;
+    }
+    segment.error += sqrt(tail2);
+
+    return segment.error;
+}
+//------------------------------------------------------------------------------
+
+EphemerisCache::Segments::iterator EphemerisCache::segmentAt(
+        std::size_t satellite, double t)
+{
+    Satellite &s = m_satellites[satellite];
+    while (true)
+    {
+        long long index = static_cast<long long>(
+                    floor((t - s.propagator.epoch()) / s.span));
+        SegmentKey key(satellite, index);
+        auto found = m_index.find(key);
+        if (found != m_index.end())
+            return found->second;
+
+        Segment segment;
+        segment.satellite = satellite;
+        segment.index = index;
+        fit(s, s.propagator.epoch() + index * s.span, segment);
+        if (segment.error <= m_tolerance || s.halvings >= MAX_HALVINGS)
+        {
+            evict(SEGMENT_BYTES);
+            m_segments.push_front(segment);
+            m_index[key] = m_segments.begin();
+            return m_segments.begin();
+        }
+
+        // The orbit is curved here more than around the perigee;
+        // the segments of the old length have other indices
+        removeSegments(satellite);
+        s.span /= 2;
+        ++s.halvings;
+    }
+}
+//------------------------------------------------------------------------------
+
+void EphemerisCache::removeSegments(std::size_t satellite)
+{
+    for (Segments::iterator it = m_segments.begin(); it != m_segments.end();)
+    {
+        if (it->satellite == satellite)
+        {
+            m_index.erase(SegmentKey(satellite, it->index));
+            it = m_segments.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+    m_last[satellite] = m_segments.end();
+}
+//------------------------------------------------------------------------------
+
+void EphemerisCache::chooseSpans()
+{
+    for (std::size_t k = 0; k < m_satellites.size(); ++k)
+    {
+        Satellite &s = m_satellites[k];
+        const Propagator &propagator = s.propagator;
+
+        // The orbit is curved most of all around the perigee
+        double n = 2 * M_PI / s.period;
+        double perigee = propagator.epoch()
+                         - propagator.meanAnomaly(propagator.epoch()) / n;
+        s.span = s.period / 2;
+        for (s.halvings = 0; s.halvings < MAX_HALVINGS; ++s.halvings)
+        {
+            Segment segment;
+            if (fit(s, perigee - s.span / 2, segment) <= m_tolerance)
+                break;
+            s.span /= 2;
+        }
+    }
+}
+//------------------------------------------------------------------------------
+
+void EphemerisCache::evict(std::size_t bytes)
+{
+    while (!m_segments.empty() && memoryUsage() + bytes > m_memoryBudget)
+    {
+        const Segment &segment = m_segments.back();
+        m_index.erase(SegmentKey(segment.satellite, segment.index));
+        if (m_last[segment.satellite] == --m_segments.end())
+            m_last[segment.satellite] = m_segments.end();
+        m_segments.pop_back();
+    }
+}
+//------------------------------------------------------------------------------
+
+}  // namespace quicktle
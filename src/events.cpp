@@ -0,0 +1,315 @@
+/*-----------------------------------------------------------------------------+
+ | QuickTle                                                                    |
+ | Copyright 2011-2015 Sergei Fundaev                                          |
+ +-----------------------------------------------------------------------------+
+ | This file is part of QuickTle library.                                      |
+ |                                                                             |
+ | QuickTle is free software: you can redistribute it and/or modify            |
+ | it under the terms of the GNU Lesser General Public License as published by |
+ | the Free Software Foundation, either version 3 of the License, or           |
+ | (at your option) any later version.                                         |
+ |                                                                             |
+ | QuickTle is distributed in the hope that it will be useful,                 |
+ | but WITHOUT ANY WARRANTY; without even the implied warranty of              |
+ | MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               |
+ | GNU Lesser General Public License for more details.                         |
+ |                                                                             |
+ | You should have received a copy of the GNU Lesser General Public License    |
+ | along with QuickTle. If not, see <http://www.gnu.org/licenses/>.            |
+ +----------------------------------------------------------------------------*/
+/*!
+    \file events.cpp
+    \brief File contains the realization of methods of
+           quicktle::EventFinder class.
+*/
+
+#define MAX_ANGLE (2 * M_PI)
+#define DEFAULT_TOLERANCE 1e-3
+#define MAX_NEWTON_ITERATIONS 10
+#define MIN_SIN_INCLINATION 1e-9   //!< Equatorial orbits have no nodes
+
+#include <cmath>
+#include <algorithm>
+#include <quicktle/events.h>
+#include <quicktle/threadpool.h>
+#include <quicktle/func.h>
+
+namespace quicktle
+{
+
+namespace
+{
+
+//! Event, defined by the argument of latitude
+struct LatitudeTarget
+{
+    OrbitEventType type;
+    double u;         //!< Argument of latitude [Radians]
+    double latitude;  //!< Geocentric latitude [Radians]
+};
+
+//! Order of events by time
+bool earlierEvent(const OrbitEvent &event1, const OrbitEvent &event2)
+{
+    return event1.t < event2.t;
+}
+//------------------------------------------------------------------------------
+
+} // namespace
+
+//! Mean anomaly at the given true anomaly
+static double meanAnomaly(double nu, double e)
+{
+    double E = 2 * atan2(sqrt(1 - e) * sin(nu / 2),
+                         sqrt(1 + e) * cos(nu / 2));
+    return E - e * sin(E);
+}
+//------------------------------------------------------------------------------
+
+EventFinder::EventFinder()
+    : m_model(TwoBody), m_tolerance(DEFAULT_TOLERANCE), m_threads(0),
+      m_nodeCrossings(true), m_apsides(true)
+{
+}
+//------------------------------------------------------------------------------
+
+EventFinder::EventFinder(const std::vector<Node> &satellites)
+    : m_model(TwoBody), m_tolerance(DEFAULT_TOLERANCE), m_threads(0),
+      m_nodeCrossings(true), m_apsides(true)
+{
+    setSatellites(satellites);
+}
+//------------------------------------------------------------------------------
+
+void EventFinder::setSatellites(const std::vector<Node> &satellites)
+{
+    m_propagators.resize(satellites.size());
+    m_orbits.resize(satellites.size());
+    for (std::size_t k = 0; k < satellites.size(); ++k)
+    {
+        const Node &node = satellites[k];
+        m_propagators[k].assign(node);
+        m_propagators[k].setOrbitModel(m_model);
+
+        Orbit &orbit = m_orbits[k];
+        orbit.e = node.e();
+        orbit.omega = node.omega();
+        orbit.sini = sin(node.i());
+        orbit.epoch = node.preciseEpoch();
+    }
+}
+//------------------------------------------------------------------------------
+
+OrbitModel EventFinder::orbitModel() const
+{
+    return m_model;
+}
+//------------------------------------------------------------------------------
+
+void EventFinder::setOrbitModel(OrbitModel model)
+{
+    m_model = model;
+    for (std::size_t k = 0; k < m_propagators.size(); ++k)
+        m_propagators[k].setOrbitModel(model);
+}
+//------------------------------------------------------------------------------
+
+bool EventFinder::nodeCrossings() const
+{
+    return m_nodeCrossings;
+}
+//------------------------------------------------------------------------------
+
+void EventFinder::setNodeCrossings(bool enabled)
+{
+    m_nodeCrossings = enabled;
+}
+//------------------------------------------------------------------------------
+
+bool EventFinder::apsides() const
+{
+    return m_apsides;
+}
+//------------------------------------------------------------------------------
+
+void EventFinder::setApsides(bool enabled)
+{
+    m_apsides = enabled;
+}
+//------------------------------------------------------------------------------
+
+const std::vector<double>& EventFinder::latitudes() const
+{
+    return m_latitudes;
+}
+//------------------------------------------------------------------------------
+
+void EventFinder::setLatitudes(const std::vector<double> &latitudes)
+{
+    m_latitudes = latitudes;
+}
+//------------------------------------------------------------------------------
+
+double EventFinder::tolerance() const
+{
+    return m_tolerance;
+}
+//------------------------------------------------------------------------------
+
+void EventFinder::setTolerance(double tolerance)
+{
+    m_tolerance = tolerance;
+}
+//------------------------------------------------------------------------------
+
+unsigned EventFinder::threads() const
+{
+    return m_threads;
+}
+//------------------------------------------------------------------------------
+
+void EventFinder::setThreads(unsigned threads)
+{
+    m_threads = threads;
+}
+//------------------------------------------------------------------------------
+
+std::vector<OrbitEvent> EventFinder::find(double start, double stop) const
+{
+    std::vector<OrbitEvent> result;
+    if (stop < start || m_propagators.empty())
+        return result;
+
+    ThreadPool &pool = ThreadPool::instance();
+
+    std::vector< std::vector<OrbitEvent> > events(m_propagators.size());
+    pool.parallelFor(m_propagators.size(), 1,
+                     [&](std::size_t first, std::size_t last)
+                     {
+                         for (std::size_t k = first; k < last; ++k)
+                             findSatellite(k, start, stop, events[k]);
+                     }, m_threads);
+
+    for (std::size_t k = 0; k < events.size(); ++k)
+        result.insert(result.end(), events[k].begin(), events[k].end());
+    return result;
+}
+//------------------------------------------------------------------------------
+
+void EventFinder::findSatellite(std::size_t satellite, double start,
+                                double stop,
+                                std::vector<OrbitEvent> &result) const
+{
+    const Propagator &propagator = m_propagators[satellite];
+    const Orbit &orbit = m_orbits[satellite];
+    const double rate = propagator.meanAnomalyRate();
+    if (!(rate > 0))
+        return;
+    const double period = MAX_ANGLE / rate;
+
+    OrbitEvent event;
+    event.satellite = satellite;
+
+    // The apsides are at the constant mean anomalies 0 and pi
+    if (m_apsides)
+    {
+        const double M = propagator.meanAnomaly(start);
+        for (int apogee = 0; apogee < 2; ++apogee)
+        {
+            event.type = apogee ? Apogee : Perigee;
+            event.latitude = 0;
+            double first = start + normalizeAngle(apogee * M_PI - M) / rate;
+            for (std::size_t k = 0; first + k * period <= stop; ++k)
+            {
+                event.t = first + k * period;
+                result.push_back(event);
+            }
+        }
+    }
+
+    // The other events are at the constant arguments of latitude
+    std::vector<LatitudeTarget> targets;
+    if (m_nodeCrossings && orbit.sini > MIN_SIN_INCLINATION)
+    {
+        LatitudeTarget target = {AscendingNode, 0, 0};
+        targets.push_back(target);
+        target.type = DescendingNode;
+        target.u = M_PI;
+        targets.push_back(target);
+    }
+    for (std::size_t k = 0; k < m_latitudes.size(); ++k)
+    {
+        // The tangent latitude is not crossed
+        double s = sin(m_latitudes[k]) / orbit.sini;
+        if (!(fabs(s) < 1))
+            continue;
+        LatitudeTarget target = {NorthwardLatitude, asin(s), m_latitudes[k]};
+        targets.push_back(target);
+        target.type = SouthwardLatitude;
+        target.u = M_PI - target.u;
+        targets.push_back(target);
+    }
+
+    // Newton's method for sin(latitude) = z / r; near the extremum of the
+    // latitude it may diverge, then the prediction is kept
+    auto refine = [&](double prediction, double sinLatitude)
+    {
+        double t = prediction;
+        for (int k = 0; k < MAX_NEWTON_ITERATIONS; ++k)
+        {
+            double r[3], v[3];
+            propagator.state(t, r, v);
+            double radius = sqrt(r[0] * r[0] + r[1] * r[1] + r[2] * r[2]);
+            double radialRate = (r[0] * v[0] + r[1] * v[1] + r[2] * v[2])
+                              / radius;
+            double g = r[2] / radius - sinLatitude;
+            double dg = (v[2] * radius - r[2] * radialRate)
+                      / (radius * radius);
+            if (dg == 0)
+                break;
+            double dt = g / dg;
+            t -= dt;
+            if (fabs(dt) < m_tolerance)
+                break;
+        }
+        return fabs(t - prediction) < period / 8 ? t : prediction;
+    };
+
+    for (std::size_t j = 0; j < targets.size(); ++j)
+    {
+        const LatitudeTarget &target = targets[j];
+        const double sinLatitude = sin(target.latitude);
+        event.type = target.type;
+        event.latitude = target.latitude;
+
+        // The first event is predicted from the start, each next one from
+        // the previous event, about one revolution later
+        double t = start;
+        bool first = true;
+        for (;;)
+        {
+            double expected = first ? start : t + period;
+            double omega = orbit.omega
+                         + propagator.omegaRate() * (expected - orbit.epoch);
+            double M = meanAnomaly(target.u - omega, orbit.e);
+            double dM = first
+                    ? normalizeAngle(M - propagator.meanAnomaly(t))
+                    : normalizeAngle(M - propagator.meanAnomaly(t) - M_PI)
+                      + M_PI;
+            double next = refine(t + dM / rate, sinLatitude);
+            if (next > stop)
+                break;
+            first = false;
+            t = next;
+            if (t < start)
+                continue;
+            event.t = t;
+            result.push_back(event);
+        }
+    }
+
+    std::sort(result.begin(), result.end(), earlierEvent);
+}
+//------------------------------------------------------------------------------
+
+}  // namespace quicktle
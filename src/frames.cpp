@@ -0,0 +1,507 @@
+/*-----------------------------------------------------------------------------+
+ | QuickTle                                                                    |
+ | Copyright 2011-2015 Sergei Fundaev                                          |
+ +-----------------------------------------------------------------------------+
+ | This file is part of QuickTle library.                                      |
+ |                                                                             |
+ | QuickTle is free software: you can redistribute it and/or modify            |
+ | it under the terms of the GNU Lesser General Public License as published by |
+ | the Free Software Foundation, either version 3 of the License, or           |
+ | (at your option) any later version.                                         |
+ |                                                                             |
+ | QuickTle is distributed in the hope that it will be useful,                 |
+ | but WITHOUT ANY WARRANTY; without even the implied warranty of              |
+ | MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               |
+ | GNU Lesser General Public License for more details.                         |
+ |                                                                             |
+ | You should have received a copy of the GNU Lesser General Public License    |
+ | along with QuickTle. If not, see <http://www.gnu.org/licenses/>.            |
+ +----------------------------------------------------------------------------*/
+/*!
+    \file frames.cpp
+    \brief File contains the realization of methods of
+           quicktle::EarthOrientation and quicktle::FrameConverter classes.
+*/
+
+#define SIDEREAL_RATE 7.2921158553e-5 //!< Earth rotation rate [rad/s]
+#define SECS_IN_DAY 86400.
+#define UNIX_EPOCH_MJD 40587.         //!< MJD of Jan 1, 1970
+#define J2000_MJD 51544.5
+#define DAYS_IN_CENTURY 36525.
+#define ARCSEC (M_PI / 180 / 3600)
+#define DEG (M_PI / 180)
+#define DEFAULT_INTERVAL 3600.
+#define NUTATION_TERMS 30
+
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+#include <quicktle/frames.h>
+#include <quicktle/coordinates.h>
+
+namespace quicktle
+{
+
+namespace
+{
+
+//! Term of IAU-80 nutation series (in 0.0001 arcsec)
+struct NutationTerm
+{
+    int l, lp, F, D, Omega;     //!< Multipliers of the fundamental arguments
+    double psi, psiT;           //!< Longitude: constant and rate per century
+    double eps, epsT;           //!< Obliquity: constant and rate per century
+};
+
+//! The largest terms of IAU-80 nutation series
+const NutationTerm NUTATION[NUTATION_TERMS] = {
+    { 0,  0, 0,  0, 1, -171996, -174.2, 92025,  8.9},
+    { 0,  0, 2, -2, 2,  -13187,   -1.6,  5736, -3.1},
+    { 0,  0, 2,  0, 2,   -2274,   -0.2,   977, -0.5},
+    { 0,  0, 0,  0, 2,    2062,    0.2,  -895,  0.5},
+    { 0,  1, 0,  0, 0,    1426,   -3.4,    54, -0.1},
+    { 1,  0, 0,  0, 0,     712,    0.1,    -7,    0},
+    { 0,  1, 2, -2, 2,    -517,    1.2,   224, -0.6},
+    { 0,  0, 2,  0, 1,    -386,   -0.4,   200,    0},
+    { 1,  0, 2,  0, 2,    -301,      0,   129, -0.1},
+    { 0, -1, 2, -2, 2,     217,   -0.5,   -95,  0.3},
+    { 1,  0, 0, -2, 0,    -158,      0,    -1,    0},
+    { 0,  0, 2, -2, 1,     129,    0.1,   -70,    0},
+    {-1,  0, 2,  0, 2,     123,      0,   -53,    0},
+    { 1,  0, 0,  0, 1,      63,    0.1,   -33,    0},
+    { 0,  0, 0,  2, 0,      63,      0,    -2,    0},
+    {-1,  0, 2,  2, 2,     -59,      0,    26,    0},
+    {-1,  0, 0,  0, 1,     -58,   -0.1,    32,    0},
+    { 1,  0, 2,  0, 1,     -51,      0,    27,    0},
+    { 2,  0, 0, -2, 0,      48,      0,     1,    0},
+    {-2,  0, 2,  0, 1,      46,      0,   -24,    0},
+    { 0,  0, 2,  2, 2,     -38,      0,    16,    0},
+    { 2,  0, 2,  0, 2,     -31,      0,    13,    0},
+    { 2,  0, 0,  0, 0,      29,      0,    -1,    0},
+    { 1,  0, 2, -2, 2,      29,      0,   -12,    0},
+    { 0,  0, 2,  0, 0,      26,      0,    -1,    0},
+    { 0,  0, 2, -2, 0,     -22,      0,     0,    0},
+    {-1,  0, 2,  0, 1,      21,      0,   -10,    0},
+    { 0,  2, 0,  0, 0,      17,   -0.1,     0,    0},
+    { 0,  2, 2, -2, 2,     -16,    0.1,     7,    0},
+    {-1,  0, 0,  2, 1,      16,      0,    -8,    0}
+};
+//------------------------------------------------------------------------------
+
+} // namespace
+
+//! Frame rotation about X axis
+static void rotation1(double angle, double *m)
+{
+    double c = cos(angle), s = sin(angle);
+    m[0] = 1; m[1] = 0;  m[2] = 0;
+    m[3] = 0; m[4] = c;  m[5] = s;
+    m[6] = 0; m[7] = -s; m[8] = c;
+}
+//------------------------------------------------------------------------------
+
+//! Frame rotation about Y axis
+static void rotation2(double angle, double *m)
+{
+    double c = cos(angle), s = sin(angle);
+    m[0] = c; m[1] = 0; m[2] = -s;
+    m[3] = 0; m[4] = 1; m[5] = 0;
+    m[6] = s; m[7] = 0; m[8] = c;
+}
+//------------------------------------------------------------------------------
+
+//! Frame rotation about Z axis
+static void rotation3(double angle, double *m)
+{
+    double c = cos(angle), s = sin(angle);
+    m[0] = c;  m[1] = s; m[2] = 0;
+    m[3] = -s; m[4] = c; m[5] = 0;
+    m[6] = 0;  m[7] = 0; m[8] = 1;
+}
+//------------------------------------------------------------------------------
+
+//! Product of 3x3 matrices: result = a * b (result may coincide with a or b)
+static void multiply(const double *a, const double *b, double *result)
+{
+    double m[9];
+    for (int i = 0; i < 3; ++i)
+    {
+        for (int j = 0; j < 3; ++j)
+        {
+            m[3 * i + j] = a[3 * i] * b[j] + a[3 * i + 1] * b[3 + j] +
+                           a[3 * i + 2] * b[6 + j];
+        }
+    }
+    std::copy(m, m + 9, result);
+}
+//------------------------------------------------------------------------------
+
+//! Apply the matrix to the vector in place
+static inline void apply(const double *m, double &x, double &y, double &z)
+{
+    double u = m[0] * x + m[1] * y + m[2] * z;
+    double v = m[3] * x + m[4] * y + m[5] * z;
+    z = m[6] * x + m[7] * y + m[8] * z;
+    x = u;
+    y = v;
+}
+//------------------------------------------------------------------------------
+
+//! Matrix, which converts TEME into the mean equator and equinox of J2000
+static void precessionNutation(double t, double *m)
+{
+    double T = (t / SECS_IN_DAY + UNIX_EPOCH_MJD - J2000_MJD) /
+               DAYS_IN_CENTURY;
+    double T2 = T * T, T3 = T2 * T;
+
+    // Fundamental arguments of the nutation theory
+    double l = (134.96298139 + (1325 * 360 + 198.8673981) * T +
+                0.0086972 * T2 + 1.78e-5 * T3) * DEG;
+    double lp = (357.52772333 + (99 * 360 + 359.0503400) * T -
+                 0.0001603 * T2 - 3.3e-6 * T3) * DEG;
+    double F = (93.27191028 + (1342 * 360 + 82.0175381) * T -
+                0.0036825 * T2 + 3.1e-6 * T3) * DEG;
+    double D = (297.85036306 + (1236 * 360 + 307.1114800) * T -
+                0.0019142 * T2 + 5.3e-6 * T3) * DEG;
+    double Omega = (125.04452222 - (5 * 360 + 134.1362608) * T +
+                    0.0020708 * T2 + 2.2e-6 * T3) * DEG;
+
+    double dPsi = 0, dEps = 0;
+    for (int k = 0; k < NUTATION_TERMS; ++k)
+    {
+        const NutationTerm &term = NUTATION[k];
+        double argument = term.l * l + term.lp * lp + term.F * F +
+                          term.D * D + term.Omega * Omega;
+        dPsi += (term.psi + term.psiT * T) * sin(argument);
+        dEps += (term.eps + term.epsT * T) * cos(argument);
+    }
+    dPsi *= 1e-4 * ARCSEC;
+    dEps *= 1e-4 * ARCSEC;
+
+    double meanEps = (84381.448 - 46.8150 * T - 0.00059 * T2 +
+                      0.001813 * T3) * ARCSEC;
+    double zeta = (2306.2181 * T + 0.30188 * T2 + 0.017998 * T3) * ARCSEC;
+    double theta = (2004.3109 * T - 0.42665 * T2 - 0.041833 * T3) * ARCSEC;
+    double z = (2306.2181 * T + 1.09468 * T2 + 0.018203 * T3) * ARCSEC;
+
+    // TEME -> true of date (equation of the equinoxes)
+    double r[9];
+    rotation3(-dPsi * cos(meanEps), m);
+    // True of date -> mean of date
+    rotation1(meanEps + dEps, r);
+    multiply(r, m, m);
+    rotation3(dPsi, r);
+    multiply(r, m, m);
+    rotation1(-meanEps, r);
+    multiply(r, m, m);
+    // Mean of date -> J2000
+    rotation3(z, r);
+    multiply(r, m, m);
+    rotation2(-theta, r);
+    multiply(r, m, m);
+    rotation3(zeta, r);
+    multiply(r, m, m);
+}
+//------------------------------------------------------------------------------
+
+/*!
+    \brief Parse the fixed width field of the line
+    \return Whether the field is not blank.
+*/
+static bool parseField(const char *line, std::size_t length,
+                       std::size_t position, std::size_t width, double &value)
+{
+    if (position + width > length)
+        return false;
+    char buffer[32];
+    std::memcpy(buffer, line + position, width);
+    buffer[width] = 0;
+    char *end;
+    value = strtod(buffer, &end);
+    return end != buffer;
+}
+//------------------------------------------------------------------------------
+
+/*!
+    \brief Parse the lines of IERS "finals" file
+    \return Number of parsed days.
+*/
+static std::size_t parseFinals(const char *data, std::size_t size,
+                               EarthOrientation &eop)
+{
+    std::size_t days = 0;
+    const char *end = data + size;
+    while (data < end)
+    {
+        const char *next = static_cast<const char*>(
+                    std::memchr(data, '\n', end - data));
+        std::size_t length = (next ? next : end) - data;
+
+        double mjd, xp, yp, dut1;
+        if (parseField(data, length, 7, 8, mjd) &&
+            parseField(data, length, 18, 9, xp) &&
+            parseField(data, length, 37, 9, yp) &&
+            parseField(data, length, 58, 10, dut1))
+        {
+            eop.append(mjd, xp * ARCSEC, yp * ARCSEC, dut1);
+            ++days;
+        }
+        data = next ? next + 1 : end;
+    }
+    return days;
+}
+//------------------------------------------------------------------------------
+
+EarthOrientation::EarthOrientation()
+{
+}
+//------------------------------------------------------------------------------
+
+bool EarthOrientation::load(const std::string &fileName)
+{
+    clear();
+#ifndef _WIN32
+    int file = open(fileName.c_str(), O_RDONLY);
+    if (file < 0)
+        return false;
+    struct stat info;
+    if (fstat(file, &info) != 0 || info.st_size <= 0)
+    {
+        close(file);
+        return false;
+    }
+    std::size_t size = static_cast<std::size_t>(info.st_size);
+    void *data = mmap(0, size, PROT_READ, MAP_PRIVATE, file, 0);
+    close(file);
+    if (data == MAP_FAILED)
+        return false;
+    std::size_t days = parseFinals(static_cast<const char*>(data), size,
+                                   *this);
+    munmap(data, size);
+#else
+    std::ifstream stream(fileName.c_str(), std::ios::binary);
+    if (!stream)
+        return false;
+    std::string data((std::istreambuf_iterator<char>(stream)),
+                     std::istreambuf_iterator<char>());
+    std::size_t days = parseFinals(data.data(), data.size(), *this);
+#endif
+    return days > 0;
+}
+//------------------------------------------------------------------------------
+
+void EarthOrientation::append(double mjd, double xp, double yp, double dut1)
+{
+    m_mjd.push_back(mjd);
+    m_xp.push_back(xp);
+    m_yp.push_back(yp);
+    m_dut1.push_back(dut1);
+}
+//------------------------------------------------------------------------------
+
+void EarthOrientation::clear()
+{
+    m_mjd.clear();
+    m_xp.clear();
+    m_yp.clear();
+    m_dut1.clear();
+}
+//------------------------------------------------------------------------------
+
+std::size_t EarthOrientation::size() const
+{
+    return m_mjd.size();
+}
+//------------------------------------------------------------------------------
+
+void EarthOrientation::parameters(double t, double &xp, double &yp,
+                                  double &dut1) const
+{
+    xp = yp = dut1 = 0;
+    if (m_mjd.empty())
+        return;
+
+    double mjd = t / SECS_IN_DAY + UNIX_EPOCH_MJD;
+    std::size_t k = std::upper_bound(m_mjd.begin(), m_mjd.end(), mjd)
+                  - m_mjd.begin();
+    if (k == 0 || k == m_mjd.size())
+    {
+        std::size_t nearest = k ? k - 1 : 0;
+        xp = m_xp[nearest];
+        yp = m_yp[nearest];
+        dut1 = m_dut1[nearest];
+        return;
+    }
+
+    double s = (mjd - m_mjd[k - 1]) / (m_mjd[k] - m_mjd[k - 1]);
+    xp = m_xp[k - 1] + s * (m_xp[k] - m_xp[k - 1]);
+    yp = m_yp[k - 1] + s * (m_yp[k] - m_yp[k - 1]);
+
+    // The leap second is inserted at the end of the day
+    double jump = m_dut1[k] - m_dut1[k - 1];
+    if (jump > 0.5)
+        jump -= 1;
+    else if (jump < -0.5)
+        jump += 1;
+    dut1 = m_dut1[k - 1] + s * jump;
+}
+//------------------------------------------------------------------------------
+
+FrameConverter::FrameConverter()
+    : m_eop(0), m_interval(DEFAULT_INTERVAL)
+{
+}
+//------------------------------------------------------------------------------
+
+FrameConverter::FrameConverter(const EarthOrientation *eop)
+    : m_eop(eop), m_interval(DEFAULT_INTERVAL)
+{
+}
+//------------------------------------------------------------------------------
+
+const EarthOrientation* FrameConverter::earthOrientation() const
+{
+    return m_eop;
+}
+//------------------------------------------------------------------------------
+
+void FrameConverter::setEarthOrientation(const EarthOrientation *eop)
+{
+    m_eop = eop;
+}
+//------------------------------------------------------------------------------
+
+double FrameConverter::interval() const
+{
+    return m_interval;
+}
+//------------------------------------------------------------------------------
+
+void FrameConverter::setInterval(double interval)
+{
+    m_interval = interval;
+}
+//------------------------------------------------------------------------------
+
+void FrameConverter::orientation(double t, Orientation &result) const
+{
+    precessionNutation(t, result.precessionNutation);
+
+    double xp = 0, yp = 0;
+    result.dut1 = 0;
+    if (m_eop)
+        m_eop->parameters(t, xp, yp, result.dut1);
+    double r[9];
+    rotation2(-xp, result.polarMotion);
+    rotation1(-yp, r);
+    multiply(r, result.polarMotion, result.polarMotion);
+}
+//------------------------------------------------------------------------------
+
+void FrameConverter::rotations(double t, double *gcrf, double *itrf) const
+{
+    Orientation o;
+    orientation(t, o);
+    if (gcrf)
+        std::copy(o.precessionNutation, o.precessionNutation + 9, gcrf);
+    if (itrf)
+    {
+        double r[9];
+        rotation3(gmst(t + o.dut1), r);
+        multiply(o.polarMotion, r, itrf);
+    }
+}
+//------------------------------------------------------------------------------
+
+template <typename Apply>
+void FrameConverter::forEachSample(double start, double step,
+                                   std::size_t count, Apply apply) const
+{
+    Orientation left, right, current;
+    double node = 0;
+    bool valid = false;
+    for (std::size_t k = 0; k < count; ++k)
+    {
+        const double t = start + k * step;
+        double index = floor(t / m_interval);
+        if (!valid || index * m_interval != node)
+        {
+            // Reuse the right node, when the grid moves to the next interval
+            if (valid && index * m_interval == node + m_interval)
+                left = right;
+            else
+                orientation(index * m_interval, left);
+            node = index * m_interval;
+            orientation(node + m_interval, right);
+            valid = true;
+        }
+
+        double s = (t - node) / m_interval;
+        for (int i = 0; i < 9; ++i)
+        {
+            current.precessionNutation[i] = left.precessionNutation[i] + s *
+                    (right.precessionNutation[i] - left.precessionNutation[i]);
+            current.polarMotion[i] = left.polarMotion[i] + s *
+                    (right.polarMotion[i] - left.polarMotion[i]);
+        }
+
+        // UT1-UTC jumps by the leap second between the nodes, so it is
+        // not interpolated; parameters() is one binary search
+        current.dut1 = 0;
+        if (m_eop)
+        {
+            double xp, yp;
+            m_eop->parameters(t, xp, yp, current.dut1);
+        }
+        apply(k, t, current);
+    }
+}
+//------------------------------------------------------------------------------
+
+void FrameConverter::toGcrf(double start, double step, std::size_t count,
+                            double *x, double *y, double *z,
+                            double *vx, double *vy, double *vz) const
+{
+    forEachSample(start, step, count,
+                  [&](std::size_t k, double, const Orientation &o)
+                  {
+                      apply(o.precessionNutation, x[k], y[k], z[k]);
+                      if (vx)
+                          apply(o.precessionNutation, vx[k], vy[k], vz[k]);
+                  });
+}
+//------------------------------------------------------------------------------
+
+void FrameConverter::toItrf(double start, double step, std::size_t count,
+                            double *x, double *y, double *z,
+                            double *vx, double *vy, double *vz) const
+{
+    forEachSample(start, step, count,
+                  [&](std::size_t k, double t, const Orientation &o)
+                  {
+                      double earth[9];
+                      rotation3(gmst(t + o.dut1), earth);
+                      apply(earth, x[k], y[k], z[k]);
+                      if (vx)
+                      {
+                          // Velocity relative to the rotating frame
+                          apply(earth, vx[k], vy[k], vz[k]);
+                          vx[k] += SIDEREAL_RATE * y[k];
+                          vy[k] -= SIDEREAL_RATE * x[k];
+                          apply(o.polarMotion, vx[k], vy[k], vz[k]);
+                      }
+                      apply(o.polarMotion, x[k], y[k], z[k]);
+                  });
+}
+//------------------------------------------------------------------------------
+
+}  // namespace quicktle
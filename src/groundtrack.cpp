@@ -0,0 +1,255 @@
+/*-----------------------------------------------------------------------------+
+ | QuickTle                                                                    |
+ | Copyright 2011-2015 Sergei Fundaev                                          |
+ +-----------------------------------------------------------------------------+
+ | This file is part of QuickTle library.                                      |
+ |                                                                             |
+ | QuickTle is free software: you can redistribute it and/or modify            |
+ | it under the terms of the GNU Lesser General Public License as published by |
+ | the Free Software Foundation, either version 3 of the License, or           |
+ | (at your option) any later version.                                         |
+ |                                                                             |
+ | QuickTle is distributed in the hope that it will be useful,                 |
+ | but WITHOUT ANY WARRANTY; without even the implied warranty of              |
+ | MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               |
+ | GNU Lesser General Public License for more details.                         |
+ |                                                                             |
+ | You should have received a copy of the GNU Lesser General Public License    |
+ | along with QuickTle. If not, see <http://www.gnu.org/licenses/>.            |
+ +----------------------------------------------------------------------------*/
+/*!
+    \file groundtrack.cpp
+    \brief File contains the realization of methods of
+           quicktle::GroundTrack class.
+*/
+
+#define MAX_ANGLE (2 * M_PI)
+#define COARSE_SAMPLES_PER_REV 32
+#define MAX_REFINE_DEPTH 16
+
+#include <cmath>
+#include <algorithm>
+#include <utility>
+#include <quicktle/groundtrack.h>
+#include <quicktle/coordinates.h>
+
+namespace quicktle
+{
+
+//! Distance from the point p to the segment [a, b] in the projection plane
+static double segmentDistance(const TrackPoint &p, const TrackPoint &a,
+                              const TrackPoint &b)
+{
+    double dx = b.longitude - a.longitude;
+    double dy = b.latitude - a.latitude;
+    double px = p.longitude - a.longitude;
+    double py = p.latitude - a.latitude;
+    double length2 = dx * dx + dy * dy;
+    double s = length2 > 0 ? (px * dx + py * dy) / length2 : 0;
+    s = std::max(0., std::min(1., s));
+    return hypot(px - s * dx, py - s * dy);
+}
+//------------------------------------------------------------------------------
+
+/*!
+    \brief Mark the samples, which are kept by Douglas-Peucker simplification
+           with the given tolerance.
+*/
+static void simplify(const std::vector<TrackPoint> &samples, double tolerance,
+                     std::vector<char> &keep)
+{
+    keep.assign(samples.size(), 0);
+    if (samples.empty())
+        return;
+    keep.front() = keep.back() = 1;
+
+    std::vector< std::pair<std::size_t, std::size_t> > ranges;
+    ranges.push_back(std::make_pair(std::size_t(0), samples.size() - 1));
+    while (!ranges.empty())
+    {
+        std::size_t first = ranges.back().first;
+        std::size_t last = ranges.back().second;
+        ranges.pop_back();
+
+        double maxDistance = 0;
+        std::size_t farthest = first;
+        for (std::size_t k = first + 1; k < last; ++k)
+        {
+            double d = segmentDistance(samples[k], samples[first],
+                                       samples[last]);
+            if (d > maxDistance)
+            {
+                maxDistance = d;
+                farthest = k;
+            }
+        }
+
+        if (maxDistance > tolerance)
+        {
+            keep[farthest] = 1;
+            ranges.push_back(std::make_pair(first, farthest));
+            ranges.push_back(std::make_pair(farthest, last));
+        }
+    }
+}
+//------------------------------------------------------------------------------
+
+//! Index of the 2 * M_PI wide band [-M_PI, M_PI) + 2 * M_PI * index
+static inline double band(double longitude)
+{
+    return floor((longitude + M_PI) / MAX_ANGLE);
+}
+//------------------------------------------------------------------------------
+
+//! Point with the longitude, reduced into [-M_PI, M_PI] from the given band
+static inline TrackPoint reduce(const TrackPoint &point, double index)
+{
+    TrackPoint reduced = point;
+    reduced.longitude -= index * MAX_ANGLE;
+    return reduced;
+}
+//------------------------------------------------------------------------------
+
+GroundTrack::GroundTrack()
+    : m_period(0), m_tolerance(1e-3)
+{
+}
+//------------------------------------------------------------------------------
+
+GroundTrack::GroundTrack(const Node &node, double tolerance)
+    : m_tolerance(tolerance)
+{
+    assign(node);
+}
+//------------------------------------------------------------------------------
+
+void GroundTrack::assign(const Node &node)
+{
+    m_propagator.assign(node);
+    m_period = node.n() > 0 ? MAX_ANGLE / node.n() : 0;
+}
+//------------------------------------------------------------------------------
+
+double GroundTrack::tolerance() const
+{
+    return m_tolerance;
+}
+//------------------------------------------------------------------------------
+
+void GroundTrack::setTolerance(double tolerance)
+{
+    m_tolerance = tolerance;
+}
+//------------------------------------------------------------------------------
+
+TrackPoint GroundTrack::point(double t, double longitude) const
+{
+    double r[3], altitude;
+    TrackPoint point;
+    point.t = t;
+    m_propagator.state(t, r);
+    EarthRotation(t).eci2geodetic(1, r, r + 1, r + 2, &point.latitude,
+                                  &point.longitude, &altitude);
+    point.longitude += MAX_ANGLE *
+            floor((longitude - point.longitude) / MAX_ANGLE + 0.5);
+    return point;
+}
+//------------------------------------------------------------------------------
+
+void GroundTrack::refine(const TrackPoint &a, const TrackPoint &b, int depth,
+                         std::vector<TrackPoint> &samples) const
+{
+    if (depth < MAX_REFINE_DEPTH)
+    {
+        TrackPoint middle = point(0.5 * (a.t + b.t), a.longitude);
+        if (segmentDistance(middle, a, b) > 0.5 * m_tolerance)
+        {
+            refine(a, middle, depth + 1, samples);
+            refine(middle, b, depth + 1, samples);
+            return;
+        }
+    }
+    samples.push_back(b);
+}
+//------------------------------------------------------------------------------
+
+std::size_t GroundTrack::compute(double start, double stop,
+                                 std::vector<Polyline> &polylines) const
+{
+    polylines.clear();
+    if (stop < start || m_period <= 0)
+        return 0;
+
+    // Adaptive samples with the continuous longitude
+    std::vector<TrackPoint> samples;
+    samples.push_back(point(start, 0));
+    const double step = m_period / COARSE_SAMPLES_PER_REV;
+    const std::size_t count = std::size_t(ceil((stop - start) / step));
+    for (std::size_t k = 1; k <= count; ++k)
+    {
+        double t = k == count ? stop : start + k * step;
+        const TrackPoint a = samples.back();
+        refine(a, point(t, a.longitude), 0, samples);
+    }
+
+    std::vector<char> keep;
+    simplify(samples, 0.5 * m_tolerance, keep);
+
+    // Split at the antimeridian
+    std::size_t total = 0;
+    polylines.push_back(Polyline());
+    const TrackPoint *previous = &samples[0];
+    polylines.back().push_back(reduce(*previous, band(previous->longitude)));
+    for (std::size_t k = 1; k < samples.size(); ++k)
+    {
+        if (!keep[k])
+            continue;
+        const TrackPoint &current = samples[k];
+        double from = band(previous->longitude);
+        double to = band(current.longitude);
+        while (from != to)
+        {
+            // Crossing of the boundary between the bands
+            double next = to > from ? from + 1 : from - 1;
+            double boundary = (std::max(from, next) - 0.5) * MAX_ANGLE;
+            double s = (boundary - previous->longitude) /
+                       (current.longitude - previous->longitude);
+            TrackPoint crossing;
+            crossing.t = previous->t + s * (current.t - previous->t);
+            crossing.latitude = previous->latitude +
+                                s * (current.latitude - previous->latitude);
+            crossing.longitude = next > from ? M_PI : -M_PI;
+            polylines.back().push_back(crossing);
+            total += polylines.back().size();
+            polylines.push_back(Polyline());
+            crossing.longitude = -crossing.longitude;
+            polylines.back().push_back(crossing);
+            from = next;
+        }
+        polylines.back().push_back(reduce(current, to));
+        previous = &current;
+    }
+    total += polylines.back().size();
+    return total;
+}
+//------------------------------------------------------------------------------
+
+void groundTracks(const std::vector<Node> &catalog, double start, double stop,
+                  double tolerance, std::vector< std::vector<Polyline> > &tracks,
+                  unsigned threads)
+{
+    tracks.resize(catalog.size());
+    ThreadPool &pool = ThreadPool::instance();
+    pool.parallelFor(catalog.size(), 1,
+                     [&](std::size_t first, std::size_t last)
+                     {
+                         for (std::size_t k = first; k < last; ++k)
+                         {
+                             GroundTrack(catalog[k], tolerance)
+                                     .compute(start, stop, tracks[k]);
+                         }
+                     }, threads);
+}
+//------------------------------------------------------------------------------
+
+}  // namespace quicktle
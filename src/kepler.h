@@ -0,0 +1,118 @@
+/*-----------------------------------------------------------------------------+
+ | QuickTle                                                                    |
+ | Copyright 2011-2015 Sergei Fundaev                                          |
+ +-----------------------------------------------------------------------------+
+ | This file is part of QuickTle library.                                      |
+ |                                                                             |
+ | QuickTle is free software: you can redistribute it and/or modify            |
+ | it under the terms of the GNU Lesser General Public License as published by |
+ | the Free Software Foundation, either version 3 of the License, or           |
+ | (at your option) any later version.                                         |
+ |                                                                             |
+ | QuickTle is distributed in the hope that it will be useful,                 |
+ | but WITHOUT ANY WARRANTY; without even the implied warranty of              |
+ | MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               |
+ | GNU Lesser General Public License for more details.                         |
+ |                                                                             |
+ | You should have received a copy of the GNU Lesser General Public License    |
+ | along with QuickTle. If not, see <http://www.gnu.org/licenses/>.            |
+ +----------------------------------------------------------------------------*/
+/*!
+    \file kepler.h
+    \brief File contains the Kepler equation solver, shared by the
+           propagation kernels of the library. It is not installed.
+*/
+
+#ifndef TLEKEPLER_H
+#define TLEKEPLER_H
+
+#define KEPLER_MAX_ITERATIONS 50
+
+#include <cmath>
+#include <quicktle/fastmath.h>
+
+namespace quicktle
+{
+
+//! Newton step, after which the eccentric anomaly is accepted
+template <typename Real> struct KeplerTolerance;
+template <> struct KeplerTolerance<double>
+{
+    static double value() { return 1e-8; }
+};
+template <> struct KeplerTolerance<float>
+{
+    // Less is below the rounding noise of float
+    static float value() { return 1e-5f; }
+};
+//------------------------------------------------------------------------------
+
+//! Sine and cosine of the standard library
+struct AccurateSinCos
+{
+    template <typename Real>
+    static void compute(Real x, Real &sine, Real &cosine)
+    {
+        sine = std::sin(x);
+        cosine = std::cos(x);
+    }
+};
+
+//! Sine and cosine of the fast math tier
+struct FastSinCos
+{
+    template <typename Real>
+    static void compute(Real x, Real &sine, Real &cosine)
+    {
+        fastSinCos(x, sine, cosine);
+    }
+};
+//------------------------------------------------------------------------------
+
+/*!
+    \brief Solve Kepler equation E - e * sin(E) = M by Newton's method.
+    \param M - mean anomaly
+    \param e - eccentricity
+    \param E - initial guess of eccentric anomaly
+    \param sinE, cosE - buffers for sine and cosine of the result
+    \return Eccentric anomaly
+
+    The last Newton step is smaller than KeplerTolerance, so the sine
+    and cosine of the result are obtained by the first-order correction
+    of the values, computed during this step, instead of the new
+    evaluation.
+*/
+template <typename SinCos, typename Real>
+static inline Real solveKepler(Real M, Real e, Real E, Real &sinE, Real &cosE)
+{
+    for (int k = 0; k < KEPLER_MAX_ITERATIONS; ++k)
+    {
+        SinCos::compute(E, sinE, cosE);
+        Real d = (E - e * sinE - M) / (1 - e * cosE);
+        E -= d;
+        if (std::fabs(d) < KeplerTolerance<Real>::value())
+        {
+            Real s = sinE;
+            sinE -= cosE * d;
+            cosE += s * d;
+            return E;
+        }
+    }
+
+    SinCos::compute(E, sinE, cosE);
+    return E;
+}
+//------------------------------------------------------------------------------
+
+//! Initial guess of eccentric anomaly, suitable for any eccentricity
+template <typename Real>
+static inline Real keplerGuess(Real M, Real e)
+{
+    // M is in [0, 2 * pi), so the sign of sin(M) is known without the call
+    return M + Real(0.85) * e * (M > Real(M_PI) ? -1 : 1);
+}
+//------------------------------------------------------------------------------
+
+} // namespace quicktle
+
+#endif // TLEKEPLER_H
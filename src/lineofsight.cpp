@@ -0,0 +1,345 @@
+/*-----------------------------------------------------------------------------+
+ | QuickTle                                                                    |
+ | Copyright 2011-2015 Sergei Fundaev                                          |
+ +-----------------------------------------------------------------------------+
+ | This file is part of QuickTle library.                                      |
+ |                                                                             |
+ | QuickTle is free software: you can redistribute it and/or modify            |
+ | it under the terms of the GNU Lesser General Public License as published by |
+ | the Free Software Foundation, either version 3 of the License, or           |
+ | (at your option) any later version.                                         |
+ |                                                                             |
+ | QuickTle is distributed in the hope that it will be useful,                 |
+ | but WITHOUT ANY WARRANTY; without even the implied warranty of              |
+ | MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               |
+ | GNU Lesser General Public License for more details.                         |
+ |                                                                             |
+ | You should have received a copy of the GNU Lesser General Public License    |
+ | along with QuickTle. If not, see <http://www.gnu.org/licenses/>.            |
+ +----------------------------------------------------------------------------*/
+/*!
+    \file lineofsight.cpp
+    \brief File contains the realization of methods of
+           quicktle::LineOfSightMatrix class.
+*/
+
+#define EARTH_RADIUS 6378137.         //!< Equatorial radius of the Earth [m]
+#define DEFAULT_MARGIN 100e3          //!< Top of the dense atmosphere [m]
+#define SATELLITES_GRAIN 1024
+#define ROWS_PER_TASK 64
+
+#include <cmath>
+#include <algorithm>
+#include <limits>
+#include <quicktle/lineofsight.h>
+#include <quicktle/threadpool.h>
+#include "celltable.h"
+
+namespace quicktle
+{
+
+//! Cell index of the coordinate
+static inline std::int64_t cellIndex(double x, double cellSize)
+{
+    return static_cast<std::int64_t>(floor(x / cellSize));
+}
+//------------------------------------------------------------------------------
+
+/*!
+    \brief Test the segments from the point a to the candidates for the
+           crossing of the sphere and the range limit.
+    \param a - 3 coordinates of the first end [m]
+    \param count - number of candidates
+    \param bx, by, bz - coordinates of the other ends [m]
+    \param radius2 - squared radius of the sphere [m^2]
+    \param range2 - squared maximal range [m^2]
+    \param distance2 - output: squared distances to the candidates [m^2]
+    \param visible - output: 1 for the unobstructed lines, otherwise 0
+*/
+static void occlusionTest(const double *a, std::size_t count,
+                          const double *bx, const double *by,
+                          const double *bz, double radius2, double range2,
+                          double *distance2, unsigned char *visible)
+{
+    const double ax = a[0], ay = a[1], az = a[2];
+    for (std::size_t j = 0; j < count; ++j)
+    {
+        double dx = bx[j] - ax;
+        double dy = by[j] - ay;
+        double dz = bz[j] - az;
+        double dd = dx * dx + dy * dy + dz * dz;
+        double ad = ax * dx + ay * dy + az * dz;
+
+        // Point of the segment, closest to the center of the Earth
+        double s = dd > 0 ? -ad / dd : 0;
+        s = s < 0 ? 0 : (s > 1 ? 1 : s);
+        double px = ax + s * dx;
+        double py = ay + s * dy;
+        double pz = az + s * dz;
+
+        distance2[j] = dd;
+        visible[j] = (px * px + py * py + pz * pz >= radius2) & (dd <= range2);
+    }
+}
+//------------------------------------------------------------------------------
+
+LineOfSightMatrix::LineOfSightMatrix()
+    : m_table(new CellTable), m_t(0), m_margin(DEFAULT_MARGIN),
+      m_maxRange(0), m_threads(0)
+{
+}
+//------------------------------------------------------------------------------
+
+LineOfSightMatrix::LineOfSightMatrix(const std::vector<Node> &satellites)
+    : m_table(new CellTable), m_t(0), m_margin(DEFAULT_MARGIN),
+      m_maxRange(0), m_threads(0)
+{
+    setSatellites(satellites);
+}
+//------------------------------------------------------------------------------
+
+LineOfSightMatrix::~LineOfSightMatrix()
+{
+}
+//------------------------------------------------------------------------------
+
+void LineOfSightMatrix::setSatellites(const std::vector<Node> &satellites)
+{
+    m_propagators.resize(satellites.size());
+    for (std::size_t k = 0; k < satellites.size(); ++k)
+        m_propagators[k].assign(satellites[k]);
+    m_positions.clear();
+    m_offsets.clear();
+    m_neighbours.clear();
+    m_ranges.clear();
+}
+//------------------------------------------------------------------------------
+
+std::size_t LineOfSightMatrix::size() const
+{
+    return m_propagators.size();
+}
+//------------------------------------------------------------------------------
+
+double LineOfSightMatrix::margin() const
+{
+    return m_margin;
+}
+//------------------------------------------------------------------------------
+
+void LineOfSightMatrix::setMargin(double margin)
+{
+    m_margin = margin;
+}
+//------------------------------------------------------------------------------
+
+double LineOfSightMatrix::maxRange() const
+{
+    return m_maxRange;
+}
+//------------------------------------------------------------------------------
+
+void LineOfSightMatrix::setMaxRange(double maxRange)
+{
+    m_maxRange = maxRange;
+}
+//------------------------------------------------------------------------------
+
+unsigned LineOfSightMatrix::threads() const
+{
+    return m_threads;
+}
+//------------------------------------------------------------------------------
+
+void LineOfSightMatrix::setThreads(unsigned threads)
+{
+    m_threads = threads;
+}
+//------------------------------------------------------------------------------
+
+std::size_t LineOfSightMatrix::compute(double t)
+{
+    m_t = t;
+    const std::size_t count = size();
+    m_positions.resize(3 * count);
+    m_offsets.assign(count + 1, 0);
+    m_neighbours.clear();
+    m_ranges.clear();
+    if (!count)
+        return 0;
+
+    ThreadPool &pool = ThreadPool::instance();
+
+    pool.parallelFor(count, SATELLITES_GRAIN,
+                     [&](std::size_t first, std::size_t last)
+    {
+        for (std::size_t k = first; k < last; ++k)
+            m_propagators[k].state(t, &m_positions[3 * k]);
+    }, m_threads);
+
+    // The longest unobstructed line is the sum of the distances to the
+    // horizon of the grazing sphere of its ends
+    const double radius = EARTH_RADIUS + m_margin;
+    double horizon = 0;
+    for (std::size_t k = 0; k < count; ++k)
+    {
+        const double *r = &m_positions[3 * k];
+        double r2 = r[0] * r[0] + r[1] * r[1] + r[2] * r[2];
+        if (r2 > radius * radius)
+            horizon = std::max(horizon, sqrt(r2 - radius * radius));
+    }
+    if (!(horizon > 0))
+        return 0;
+    double cellSize = 2 * horizon;
+    if (m_maxRange > 0)
+        cellSize = std::min(cellSize, m_maxRange);
+
+    m_entries.resize(count);
+    for (std::size_t k = 0; k < count; ++k)
+    {
+        const double *r = &m_positions[3 * k];
+        m_entries[k].first = cellKey(cellIndex(r[0], cellSize),
+                                     cellIndex(r[1], cellSize),
+                                     cellIndex(r[2], cellSize));
+        m_entries[k].second = static_cast<std::uint32_t>(k);
+    }
+    std::sort(m_entries.begin(), m_entries.end());
+    m_table->build(m_entries);
+    for (int j = 0; j < 3; ++j)
+    {
+        m_sorted[j].resize(count);
+        for (std::size_t e = 0; e < count; ++e)
+            m_sorted[j][e] = m_positions[3 * m_entries[e].second + j];
+    }
+
+    // Each task writes the lists of its rows into own buffers, which are
+    // concatenated in the order of the rows
+    const std::size_t tasks = (count + ROWS_PER_TASK - 1) / ROWS_PER_TASK;
+    std::vector< std::vector<std::size_t> > neighbours(tasks);
+    std::vector< std::vector<double> > ranges(tasks);
+    pool.parallelFor(tasks, 1, [&](std::size_t first, std::size_t last)
+    {
+        for (std::size_t task = first; task < last; ++task)
+        {
+            testRows(task * ROWS_PER_TASK,
+                     std::min(count, (task + 1) * ROWS_PER_TASK),
+                     cellSize, neighbours[task], ranges[task]);
+        }
+    }, m_threads);
+
+    for (std::size_t k = 0; k < count; ++k)
+        m_offsets[k + 1] += m_offsets[k];
+    m_neighbours.reserve(m_offsets[count]);
+    m_ranges.reserve(m_offsets[count]);
+    for (std::size_t task = 0; task < tasks; ++task)
+    {
+        m_neighbours.insert(m_neighbours.end(), neighbours[task].begin(),
+                            neighbours[task].end());
+        m_ranges.insert(m_ranges.end(), ranges[task].begin(),
+                        ranges[task].end());
+    }
+
+    std::size_t links = m_offsets[count] / 2;
+    return links;
+}
+//------------------------------------------------------------------------------
+
+void LineOfSightMatrix::testRows(std::size_t first, std::size_t last,
+                                 double cellSize,
+                                 std::vector<std::size_t> &neighbours,
+                                 std::vector<double> &ranges)
+{
+    const double radius = EARTH_RADIUS + m_margin;
+    const double radius2 = radius * radius;
+    const double range2 = m_maxRange > 0
+            ? m_maxRange * m_maxRange
+            : std::numeric_limits<double>::infinity();
+
+    std::vector<double> distance2;
+    std::vector<unsigned char> visible;
+    for (std::size_t k = first; k < last; ++k)
+    {
+        const std::size_t row = neighbours.size();
+        const double *a = &m_positions[3 * k];
+        if (a[0] * a[0] + a[1] * a[1] + a[2] * a[2] < radius2)
+            continue;
+
+        std::int64_t ix = cellIndex(a[0], cellSize);
+        std::int64_t iy = cellIndex(a[1], cellSize);
+        std::int64_t iz = cellIndex(a[2], cellSize);
+        for (int dx = -1; dx <= 1; ++dx)
+        {
+            for (int dy = -1; dy <= 1; ++dy)
+            {
+                for (int dz = -1; dz <= 1; ++dz)
+                {
+                    std::uint32_t begin, end;
+                    if (!m_table->find(cellKey(ix + dx, iy + dy, iz + dz),
+                                       begin, end))
+                    {
+                        continue;
+                    }
+
+                    std::size_t cell = end - begin;
+                    if (distance2.size() < cell)
+                    {
+                        distance2.resize(cell);
+                        visible.resize(cell);
+                    }
+                    occlusionTest(a, cell, &m_sorted[0][begin],
+                                  &m_sorted[1][begin], &m_sorted[2][begin],
+                                  radius2, range2, &distance2[0],
+                                  &visible[0]);
+                    for (std::size_t e = 0; e < cell; ++e)
+                    {
+                        std::size_t j = m_entries[begin + e].second;
+                        if (!visible[e] || j == k)
+                            continue;
+                        neighbours.push_back(j);
+                        ranges.push_back(sqrt(distance2[e]));
+                    }
+                }
+            }
+        }
+        m_offsets[k + 1] = neighbours.size() - row;
+    }
+}
+//------------------------------------------------------------------------------
+
+double LineOfSightMatrix::time() const
+{
+    return m_t;
+}
+//------------------------------------------------------------------------------
+
+std::size_t LineOfSightMatrix::links() const
+{
+    return m_neighbours.size() / 2;
+}
+//------------------------------------------------------------------------------
+
+const std::size_t* LineOfSightMatrix::offsets() const
+{
+    return m_offsets.empty() ? 0 : &m_offsets[0];
+}
+//------------------------------------------------------------------------------
+
+const std::size_t* LineOfSightMatrix::neighbours() const
+{
+    return m_neighbours.empty() ? 0 : &m_neighbours[0];
+}
+//------------------------------------------------------------------------------
+
+const double* LineOfSightMatrix::ranges() const
+{
+    return m_ranges.empty() ? 0 : &m_ranges[0];
+}
+//------------------------------------------------------------------------------
+
+const double* LineOfSightMatrix::position(std::size_t k) const
+{
+    return &m_positions[3 * k];
+}
+//------------------------------------------------------------------------------
+
+}  // namespace quicktle
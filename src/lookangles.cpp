@@ -0,0 +1,213 @@
+/*-----------------------------------------------------------------------------+
+ | QuickTle                                                                    |
+ | Copyright 2011-2015 Sergei Fundaev                                          |
+ +-----------------------------------------------------------------------------+
+ | This file is part of QuickTle library.                                      |
+ |                                                                             |
+ | QuickTle is free software: you can redistribute it and/or modify            |
+ | it under the terms of the GNU Lesser General Public License as published by |
+ | the Free Software Foundation, either version 3 of the License, or           |
+ | (at your option) any later version.                                         |
+ |                                                                             |
+ | QuickTle is distributed in the hope that it will be useful,                 |
+ | but WITHOUT ANY WARRANTY; without even the implied warranty of              |
+ | MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               |
+ | GNU Lesser General Public License for more details.                         |
+ |                                                                             |
+ | You should have received a copy of the GNU Lesser General Public License    |
+ | along with QuickTle. If not, see <http://www.gnu.org/licenses/>.            |
+ +----------------------------------------------------------------------------*/
+/*!
+    \file lookangles.cpp
+    \brief File contains the realization of methods of
+           quicktle::LookAngleMatrix class.
+*/
+
+#define SIDEREAL_RATE 7.2921158553e-5 //!< Earth rotation rate [rad/s]
+#define MAX_ANGLE (2 * M_PI)
+#define CHUNK_SATELLITES 256
+
+#include <cmath>
+#include <quicktle/lookangles.h>
+#include <quicktle/coordinates.h>
+#include <quicktle/threadpool.h>
+
+namespace quicktle
+{
+
+LookAngleMatrix::LookAngleMatrix()
+    : m_t(0), m_threads(0)
+{
+}
+//------------------------------------------------------------------------------
+
+LookAngleMatrix::LookAngleMatrix(const std::vector<Station> &stations,
+                                 const std::vector<Node> &satellites)
+    : m_t(0), m_threads(0)
+{
+    setStations(stations);
+    setSatellites(satellites);
+}
+//------------------------------------------------------------------------------
+
+void LookAngleMatrix::setStations(const std::vector<Station> &stations)
+{
+    m_stations = stations;
+}
+//------------------------------------------------------------------------------
+
+void LookAngleMatrix::setSatellites(const std::vector<Node> &satellites)
+{
+    m_dataSets.clear();
+    m_cursors.clear();
+    m_propagators.resize(satellites.size());
+    for (std::size_t k = 0; k < satellites.size(); ++k)
+        m_propagators[k].assign(satellites[k]);
+}
+//------------------------------------------------------------------------------
+
+void LookAngleMatrix::setSatellites(const std::vector<DataSet> &satellites)
+{
+    m_propagators.clear();
+    m_dataSets = satellites;
+    m_cursors.assign(satellites.size(), DataSet::Cursor());
+}
+//------------------------------------------------------------------------------
+
+std::size_t LookAngleMatrix::stations() const
+{
+    return m_stations.size();
+}
+//------------------------------------------------------------------------------
+
+std::size_t LookAngleMatrix::satellites() const
+{
+    return m_dataSets.empty() ? m_propagators.size() : m_dataSets.size();
+}
+//------------------------------------------------------------------------------
+
+unsigned LookAngleMatrix::threads() const
+{
+    return m_threads;
+}
+//------------------------------------------------------------------------------
+
+void LookAngleMatrix::setThreads(unsigned threads)
+{
+    m_threads = threads;
+}
+//------------------------------------------------------------------------------
+
+double LookAngleMatrix::time() const
+{
+    return m_t;
+}
+//------------------------------------------------------------------------------
+
+const double* LookAngleMatrix::azimuth() const
+{
+    return m_azimuth.empty() ? 0 : &m_azimuth[0];
+}
+//------------------------------------------------------------------------------
+
+const double* LookAngleMatrix::elevation() const
+{
+    return m_elevation.empty() ? 0 : &m_elevation[0];
+}
+//------------------------------------------------------------------------------
+
+const double* LookAngleMatrix::range() const
+{
+    return m_range.empty() ? 0 : &m_range[0];
+}
+//------------------------------------------------------------------------------
+
+const double* LookAngleMatrix::rangeRate() const
+{
+    return m_rangeRate.empty() ? 0 : &m_rangeRate[0];
+}
+//------------------------------------------------------------------------------
+
+void LookAngleMatrix::compute(double t)
+{
+    m_t = t;
+    const std::size_t size = m_stations.size() * satellites();
+    m_azimuth.resize(size);
+    m_elevation.resize(size);
+    m_range.resize(size);
+    m_rangeRate.resize(size);
+    if (!size)
+        return;
+
+    ThreadPool &pool = ThreadPool::instance();
+    pool.parallelFor(satellites(), CHUNK_SATELLITES,
+                     [&](std::size_t first, std::size_t last)
+                     {
+                         computeChunk(t, first, last);
+                     }, m_threads);
+}
+//------------------------------------------------------------------------------
+
+void LookAngleMatrix::computeChunk(double t, std::size_t first,
+                                   std::size_t last)
+{
+    const EarthRotation rotation(t);
+    const std::size_t count = last - first;
+    const std::size_t columns = satellites();
+
+    // Earth-fixed states of the chunk
+    double x[CHUNK_SATELLITES], y[CHUNK_SATELLITES], z[CHUNK_SATELLITES];
+    double vx[CHUNK_SATELLITES], vy[CHUNK_SATELLITES], vz[CHUNK_SATELLITES];
+    for (std::size_t k = 0; k < count; ++k)
+    {
+        double r[3], v[3], re[3], ve[3];
+        if (m_dataSets.empty())
+            m_propagators[first + k].state(t, r, v);
+        else
+            m_dataSets[first + k].stateAt(m_cursors[first + k], t, r, v);
+        rotation.eci2ecef(r, re);
+        rotation.eci2ecef(v, ve);
+
+        // Velocity relative to the rotating frame
+        x[k] = re[0];
+        y[k] = re[1];
+        z[k] = re[2];
+        vx[k] = ve[0] + SIDEREAL_RATE * re[1];
+        vy[k] = ve[1] - SIDEREAL_RATE * re[0];
+        vz[k] = ve[2];
+    }
+
+    for (std::size_t s = 0; s < m_stations.size(); ++s)
+    {
+        const Station &station = m_stations[s];
+        const double *p = station.position();
+        const double *east = station.east();
+        const double *north = station.north();
+        const double *up = station.up();
+        const std::size_t row = s * columns + first;
+        double *azimuth = &m_azimuth[row];
+        double *elevation = &m_elevation[row];
+        double *range = &m_range[row];
+        double *rangeRate = &m_rangeRate[row];
+
+        for (std::size_t k = 0; k < count; ++k)
+        {
+            double dx = x[k] - p[0];
+            double dy = y[k] - p[1];
+            double dz = z[k] - p[2];
+            double d = sqrt(dx * dx + dy * dy + dz * dz);
+            double e = dx * east[0] + dy * east[1] + dz * east[2];
+            double n = dx * north[0] + dy * north[1] + dz * north[2];
+            double u = dx * up[0] + dy * up[1] + dz * up[2];
+
+            double a = atan2(e, n);
+            azimuth[k] = a < 0 ? a + MAX_ANGLE : a;
+            elevation[k] = atan2(u, sqrt(e * e + n * n));
+            range[k] = d;
+            rangeRate[k] = (dx * vx[k] + dy * vy[k] + dz * vz[k]) / d;
+        }
+    }
+}
+//------------------------------------------------------------------------------
+
+}  // namespace quicktle
@@ -87,6 +87,13 @@ Node::Node(const Node &node)
     m_fileType = node.m_fileType;
     m_lastError = node.m_lastError;
     m_initList = node.m_initList;
+    m_a = node.m_a;
+    m_p = node.m_p;
+    m_v0 = node.m_v0;
+    for (int k = 0; k < 9; ++k)
+        m_orientation[k] = node.m_orientation[k];
+    m_E = node.m_E;
+    m_nu = node.m_nu;
 }
 //------------------------------------------------------------------------------
 
@@ -118,6 +125,14 @@ void Node::swap(Node& node)
 
     std::swap(m_lastError, node.m_lastError);
     std::swap(m_initList, node.m_initList);
+
+    std::swap(m_a, node.m_a);
+    std::swap(m_p, node.m_p);
+    std::swap(m_v0, node.m_v0);
+    for (int k = 0; k < 9; ++k)
+        std::swap(m_orientation[k], node.m_orientation[k]);
+    std::swap(m_E, node.m_E);
+    std::swap(m_nu, node.m_nu);
 }
 //------------------------------------------------------------------------------
 
@@ -152,6 +167,8 @@ void Node::init()
     m_date = 0;
     m_lastError = NoError;
     m_initList.reset();
+    updateOrbitConstants();
+    updateAnomalies();
 }
 //------------------------------------------------------------------------------
 
@@ -194,6 +211,12 @@ bool Node::assign(const std::string &line1, const std::string &line2,
     // Parse
     if (forceParsing)
         parseAll();
+    // The derived values need the orbit elements; their parsing errors
+    // are reported, when the fields are read
+    error = m_lastError;
+    updateOrbitConstants();
+    updateAnomalies();
+    m_lastError = error;
 
     return (m_lastError == NoError);
 }
@@ -224,6 +247,12 @@ bool Node::assign(const std::string &line2, const std::string &line3,
     // Parse
     if (forceParsing)
         parseAll();
+    // The derived values need the orbit elements; their parsing errors
+    // are reported, when the fields are read
+    error = m_lastError;
+    updateOrbitConstants();
+    updateAnomalies();
+    m_lastError = error;
 
     return (m_lastError == NoError);
 }
@@ -398,6 +427,7 @@ void Node::set_n(double n)
 {
     m_n = n;
     m_initList.set(Field_n);
+    updateOrbitConstants();
 }
 //------------------------------------------------------------------------------
 
@@ -471,6 +501,10 @@ double Node::i() const
         m_lastError = error;
         m_i = 0;
     }
+    else
+    {
+        m_initList.set(Field_i);
+    }
 
     return m_i;
 }
@@ -480,6 +514,7 @@ void Node::set_i(double i)
 {
     m_i = deg2rad(i);
     m_initList.set(Field_i);
+    updateOrbitConstants();
 }
 double Node::getInclination()
 {
@@ -514,6 +549,7 @@ void Node::set_Omega(double Omega)
 {
     m_Omega = deg2rad(Omega);
     m_initList.set(Field_Omega);
+    updateOrbitConstants();
 }
 double Node::getRightAscensionAscendingNode()
 {
@@ -550,6 +586,7 @@ void Node::set_omega(double omega)
 {
     m_omega = deg2rad(omega);
     m_initList.set(Field_omega);
+    updateOrbitConstants();
 }
 //------------------------------------------------------------------------------
 
@@ -578,6 +615,7 @@ void Node::set_M(double M)
 {
     m_M = deg2rad(M);
     m_initList.set(Field_M);
+    updateAnomalies();
 }
 //------------------------------------------------------------------------------
 
@@ -633,6 +671,8 @@ void Node::set_e(double e)
 {
     m_e = e;
     m_initList.set(Field_e);
+    updateOrbitConstants();
+    updateAnomalies();
 }
 
 double Node::getEccentricity()
@@ -645,6 +685,26 @@ void Node::setEccentricity(double e)
 }
 //------------------------------------------------------------------------------
 
+void Node::setElements(double n, double e, double i, double Omega,
+                       double omega, double M)
+{
+    m_n = n;
+    m_e = e;
+    m_i = i;
+    m_Omega = Omega;
+    m_omega = omega;
+    m_M = M;
+    m_initList.set(Field_n);
+    m_initList.set(Field_e);
+    m_initList.set(Field_i);
+    m_initList.set(Field_Omega);
+    m_initList.set(Field_omega);
+    m_initList.set(Field_M);
+    updateOrbitConstants();
+    updateAnomalies();
+}
+//------------------------------------------------------------------------------
+
 char Node::classification() const
 {
     if (m_initList.test(Field_Classification) || m_line2.empty())
@@ -878,7 +938,32 @@ std::ostream& operator<<(std::ostream& stream, const Node& node)
 }
 //------------------------------------------------------------------------------
 
-double Node::E() const
+void Node::updateOrbitConstants()
+{
+    m_a = cbrt(GM / (n() * n()));
+    m_p = m_a * (1 - pow(e(), 2));
+    m_v0 = sqrt(GM / m_p);
+
+    double sinO = sin(Omega());
+    double cosO = cos(Omega());
+    double sinw = sin(omega());
+    double cosw = cos(omega());
+    double sini = sin(i());
+    double cosi = cos(i());
+
+    m_orientation[0] = cosO * cosw - sinO * sinw * cosi;
+    m_orientation[1] = -cosO * sinw - sinO * cosw * cosi;
+    m_orientation[2] = sinO * sini;
+    m_orientation[3] = sinO * cosw + cosO * sinw * cosi;
+    m_orientation[4] = -sinO * sinw + cosO * cosw * cosi;
+    m_orientation[5] = -cosO * sini;
+    m_orientation[6] = sinw * sini;
+    m_orientation[7] = cosw * sini;
+    m_orientation[8] = cosi;
+}
+//------------------------------------------------------------------------------
+
+void Node::updateAnomalies()
 {
     double E = M();
     double oldE;
@@ -889,7 +974,14 @@ double Node::E() const
     }
     while (fabs((oldE - E) / E) > E_RELATIVE_ERROR);
 
-    return E;
+    m_E = E;
+    m_nu = 2 * atan(sqrt( (1 + e()) / (1 - e()) ) * tan(E / 2) );
+}
+//------------------------------------------------------------------------------
+
+double Node::E() const
+{
+    return m_E;
 }
 //------------------------------------------------------------------------------
 
@@ -901,7 +993,7 @@ void Node::set_E(double value)
 
 double Node::nu() const
 {
-    return 2 * atan(sqrt( (1 + e()) / (1 - e()) ) * tan(E() / 2) );
+    return m_nu;
 }
 //------------------------------------------------------------------------------
 
@@ -913,13 +1005,13 @@ void Node::set_nu(double value)
 
 double Node::a() const
 {
-    return pow(GM / pow(n(), 2), 1./3.);
+    return m_a;
 }
 //------------------------------------------------------------------------------
 
 double Node::p() const
 {
-    return a() * (1 - pow(e(), 2));
+    return m_p;
 }
 //------------------------------------------------------------------------------
 
@@ -929,69 +1021,57 @@ double Node::r() const
 }
 //------------------------------------------------------------------------------
 
+const double* Node::orientation() const
+{
+    return m_orientation;
+}
+//------------------------------------------------------------------------------
+
 double Node::x() const
 {
     double nu = Node::nu();
-    return r() * (cos(Omega()) * cos(omega() + nu)
-                  - sin(Omega()) * sin(omega() + nu) * cos(i()));
+    const double *R = orientation();
+    return r() * (R[0] * cos(nu) + R[1] * sin(nu));
 }
 //------------------------------------------------------------------------------
 
 double Node::y() const
 {
     double nu = Node::nu();
-    return r() * (sin(Omega()) * cos(omega() + nu)
-                  + cos(Omega()) * sin(omega() + nu) * cos(i()));
+    const double *R = orientation();
+    return r() * (R[3] * cos(nu) + R[4] * sin(nu));
 }
 //------------------------------------------------------------------------------
 
 double Node::z() const
 {
-    return r() * sin(omega() + nu()) * sin(i());
+    double nu = Node::nu();
+    const double *R = orientation();
+    return r() * (R[6] * cos(nu) + R[7] * sin(nu));
 }
 //------------------------------------------------------------------------------
 
 double Node::vx() const
 {
     double nu = Node::nu();
-    double v0 = sqrt(GM/p());
-    double r_dot = v0 * e() * sin(nu);
-    double r_nu_dot = v0 * (1 + e() * cos(nu));
-    double omega_nu = omega() + nu;
-
-    return (
-            (r_dot * cos(omega_nu) - r_nu_dot * sin(omega_nu)) * cos(Omega())
-            - (r_dot * sin(omega_nu) + r_nu_dot * cos(omega_nu))
-                * sin(Omega()) * cos(i())
-    );
+    const double *R = orientation();
+    return m_v0 * (-R[0] * sin(nu) + R[1] * (e() + cos(nu)));
 }
 //------------------------------------------------------------------------------
 
 double Node::vy() const
 {
     double nu = Node::nu();
-    double v0 = sqrt(GM/p());
-    double r_dot = v0 * e() * sin(nu);
-    double r_nu_dot = v0 * (1 + e() * cos(nu));
-    double omega_nu = omega() + nu;
-
-    return (
-            (r_dot * cos(omega_nu) - r_nu_dot * sin(omega_nu)) * sin(Omega())
-            + (r_dot * sin(omega_nu) + r_nu_dot * cos(omega_nu))
-              * cos(Omega()) * cos(i())
-    );
+    const double *R = orientation();
+    return m_v0 * (-R[3] * sin(nu) + R[4] * (e() + cos(nu)));
 }
 //------------------------------------------------------------------------------
 
 double Node::vz() const
 {
     double nu = Node::nu();
-    double v0 = sqrt(GM/p());
-    double r_dot = v0 * e() * sin(nu);
-    double r_nu_dot = v0 * (1 + e() * cos(nu));
-    double omega_nu = omega() + nu;
-
-    return ( (r_dot * sin(omega_nu) + r_nu_dot * cos(omega_nu)) * sin(i()) );
+    const double *R = orientation();
+    return m_v0 * (-R[6] * sin(nu) + R[7] * (e() + cos(nu)));
 }
 //------------------------------------------------------------------------------
 
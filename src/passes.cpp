@@ -0,0 +1,452 @@
+/*-----------------------------------------------------------------------------+
+ | QuickTle                                                                    |
+ | Copyright 2011-2015 Sergei Fundaev                                          |
+ +-----------------------------------------------------------------------------+
+ | This file is part of QuickTle library.                                      |
+ |                                                                             |
+ | QuickTle is free software: you can redistribute it and/or modify            |
+ | it under the terms of the GNU Lesser General Public License as published by |
+ | the Free Software Foundation, either version 3 of the License, or           |
+ | (at your option) any later version.                                         |
+ |                                                                             |
+ | QuickTle is distributed in the hope that it will be useful,                 |
+ | but WITHOUT ANY WARRANTY; without even the implied warranty of              |
+ | MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               |
+ | GNU Lesser General Public License for more details.                         |
+ |                                                                             |
+ | You should have received a copy of the GNU Lesser General Public License    |
+ | along with QuickTle. If not, see <http://www.gnu.org/licenses/>.            |
+ +----------------------------------------------------------------------------*/
+/*!
+    \file passes.cpp
+    \brief File contains the realization of methods of quicktle::PassPredictor
+           class.
+*/
+
+#define SIDEREAL_RATE 7.2921158553e-5  //!< Earth rotation rate [rad/s]
+#define COARSE_SAMPLES_PER_REV 90
+#define MAX_COARSE_STEP 120.
+#define DEFAULT_TOLERANCE 0.1
+//! Bound of the angle between geodetic and geocentric zenith directions
+#define ELEVATION_MARGIN (0.5 * M_PI / 180)
+#define GOLDEN_RATIO 0.6180339887498949
+
+#include <cmath>
+#include <algorithm>
+#include <quicktle/passes.h>
+#include <quicktle/threadpool.h>
+#include <quicktle/coordinates.h>
+
+namespace quicktle
+{
+
+namespace
+{
+
+//! Elevation of the satellite over the station as a function of time
+class Elevation
+{
+public:
+    Elevation(const Propagator &propagator, const Station &station)
+        : m_propagator(propagator), m_station(station)
+    {
+    }
+    double operator()(double t) const
+    {
+        double eci[3], ecef[3];
+        m_propagator.state(t, eci);
+        EarthRotation(t).eci2ecef(eci, ecef);
+        return m_station.elevation(ecef);
+    }
+
+private:
+    const Propagator &m_propagator;
+    const Station &m_station;
+};
+//------------------------------------------------------------------------------
+
+//! Time grid with uniform step, which last sample is at the end of interval
+struct Grid
+{
+    Grid(double start, double step, double stop, std::size_t count)
+        : start(start), step(step), stop(stop), count(count)
+    {
+    }
+    double time(std::size_t k) const
+    {
+        return k + 1 == count ? stop : start + k * step;
+    }
+
+    double start;
+    double step;
+    double stop;
+    std::size_t count;
+};
+//------------------------------------------------------------------------------
+
+} // namespace
+
+/*!
+    \brief Find the time, when the elevation crosses the given level,
+           by bisection. The crossing should be bracketed by [a, b].
+*/
+static double findCrossing(const Elevation &elevation, double level,
+                           double a, double b, double tolerance)
+{
+    const bool visibleA = elevation(a) >= level;
+    while (b - a > tolerance)
+    {
+        double middle = (a + b) / 2;
+        if ((elevation(middle) >= level) == visibleA)
+            a = middle;
+        else
+            b = middle;
+    }
+
+    return (a + b) / 2;
+}
+//------------------------------------------------------------------------------
+
+//! Find the maximum of elevation on [a, b] by golden section search
+static void findMaximum(const Elevation &elevation, double a, double b,
+                        double tolerance, double &t, double &value)
+{
+    double c = b - GOLDEN_RATIO * (b - a);
+    double d = a + GOLDEN_RATIO * (b - a);
+    double fc = elevation(c);
+    double fd = elevation(d);
+    while (b - a > tolerance)
+    {
+        if (fc > fd)
+        {
+            b = d;
+            d = c;
+            fd = fc;
+            c = b - GOLDEN_RATIO * (b - a);
+            fc = elevation(c);
+        }
+        else
+        {
+            a = c;
+            c = d;
+            fc = fd;
+            d = a + GOLDEN_RATIO * (b - a);
+            fd = elevation(d);
+        }
+    }
+
+    t = (a + b) / 2;
+    value = elevation(t);
+}
+//------------------------------------------------------------------------------
+
+//! Create the Pass object
+static Pass makePass(std::size_t station, std::size_t satellite, double rise,
+                     double culmination, double set, double maxElevation)
+{
+    Pass pass;
+    pass.station = station;
+    pass.satellite = satellite;
+    pass.rise = rise;
+    pass.culmination = culmination;
+    pass.set = set;
+    pass.maxElevation = maxElevation;
+    return pass;
+}
+//------------------------------------------------------------------------------
+
+//! Order of passes: by rise time, then by station and satellite
+static bool earlierPass(const Pass &pass1, const Pass &pass2)
+{
+    if (pass1.rise != pass2.rise)
+        return pass1.rise < pass2.rise;
+    if (pass1.station != pass2.station)
+        return pass1.station < pass2.station;
+    return pass1.satellite < pass2.satellite;
+}
+//------------------------------------------------------------------------------
+
+PassPredictor::PassPredictor()
+    : m_tolerance(DEFAULT_TOLERANCE), m_threads(0)
+{
+}
+//------------------------------------------------------------------------------
+
+PassPredictor::PassPredictor(const std::vector<Station> &stations,
+                             const std::vector<Node> &satellites)
+    : m_tolerance(DEFAULT_TOLERANCE), m_threads(0)
+{
+    setStations(stations);
+    setSatellites(satellites);
+}
+//------------------------------------------------------------------------------
+
+void PassPredictor::setStations(const std::vector<Station> &stations)
+{
+    m_stations = stations;
+}
+//------------------------------------------------------------------------------
+
+void PassPredictor::setSatellites(const std::vector<Node> &satellites)
+{
+    // The nodes are parsed here, so the threads use the propagators only
+    m_propagators.resize(satellites.size());
+    m_orbits.resize(satellites.size());
+    for (std::size_t k = 0; k < satellites.size(); ++k)
+    {
+        const Node &node = satellites[k];
+        m_propagators[k].assign(node);
+
+        double e = node.e();
+        Orbit &orbit = m_orbits[k];
+        orbit.apogee = node.a() * (1 + e);
+        orbit.inclination = node.i() <= M_PI_2 ? node.i() : M_PI - node.i();
+        orbit.maxRate = node.n() * (1 + e) * (1 + e) / pow(1 - e * e, 1.5)
+                      + SIDEREAL_RATE;
+        orbit.period = 2 * M_PI / node.n();
+    }
+}
+//------------------------------------------------------------------------------
+
+double PassPredictor::tolerance() const
+{
+    return m_tolerance;
+}
+//------------------------------------------------------------------------------
+
+void PassPredictor::setTolerance(double tolerance)
+{
+    m_tolerance = tolerance;
+}
+//------------------------------------------------------------------------------
+
+unsigned PassPredictor::threads() const
+{
+    return m_threads;
+}
+//------------------------------------------------------------------------------
+
+void PassPredictor::setThreads(unsigned threads)
+{
+    m_threads = threads;
+}
+//------------------------------------------------------------------------------
+
+std::vector<Pass> PassPredictor::predict(double start, double stop) const
+{
+    const std::size_t count = m_propagators.size();
+    std::vector< std::vector<Pass> > results(count);
+
+    // Satellites are stolen by the idle threads one by one, so the orbits
+    // of different cost are balanced automatically.
+    ThreadPool &pool = ThreadPool::instance();
+    pool.parallelFor(count, 1, [&](std::size_t first, std::size_t last)
+    {
+        std::vector<double> buffer;
+        for (std::size_t s = first; s < last; ++s)
+            predictSatellite(s, start, stop, buffer, results[s]);
+    }, m_threads);
+
+    std::vector<Pass> passes;
+    for (std::size_t k = 0; k < count; ++k)
+        passes.insert(passes.end(), results[k].begin(), results[k].end());
+    std::sort(passes.begin(), passes.end(), earlierPass);
+
+    return passes;
+}
+//------------------------------------------------------------------------------
+
+void PassPredictor::predictSatellite(std::size_t satellite,
+                                     double start, double stop,
+                                     std::vector<double> &buffer,
+                                     std::vector<Pass> &passes) const
+{
+    const Propagator &propagator = m_propagators[satellite];
+    const Orbit &orbit = m_orbits[satellite];
+
+    // Coarse grid, shared by all stations; the last sample is at stop
+    const double step = std::min(orbit.period / COARSE_SAMPLES_PER_REV,
+                                 MAX_COARSE_STEP);
+    std::size_t gridCount = Propagator::samples(start, stop, step);
+    if (!gridCount)
+        return;
+    const bool tail = start + (gridCount - 1) * step < stop;
+    const std::size_t count = gridCount + (tail ? 1 : 0);
+
+    buffer.resize(4 * count);
+    double *x = &buffer[0];
+    double *y = x + count;
+    double *z = y + count;
+    double *r = z + count;
+    propagator.propagate(start, step, gridCount, x, y, z);
+    eci2ecef(start, step, gridCount, x, y, z, x, y, z);
+    if (tail)
+    {
+        double eci[3], ecef[3];
+        propagator.state(stop, eci);
+        EarthRotation(stop).eci2ecef(eci, ecef);
+        x[count - 1] = ecef[0];
+        y[count - 1] = ecef[1];
+        z[count - 1] = ecef[2];
+    }
+    for (std::size_t k = 0; k < count; ++k)
+        r[k] = sqrt(x[k] * x[k] + y[k] * y[k] + z[k] * z[k]);
+    const Grid grid(start, step, stop, count);
+
+    for (std::size_t s = 0; s < m_stations.size(); ++s)
+    {
+        const Station &station = m_stations[s];
+        const double *p = station.position();
+        const double R = sqrt(p[0] * p[0] + p[1] * p[1] + p[2] * p[2]);
+        const double u[3] = {p[0] / R, p[1] / R, p[2] / R};
+        const double minElevation = station.minElevation();
+
+        // Maximal angular distance between the station and the visible
+        // sub-satellite point (the satellite is at apogee)
+        const double elevationBound = minElevation - ELEVATION_MARGIN;
+        const double c = R * cos(elevationBound) / orbit.apogee;
+        if (c >= 1)
+            continue;
+        const double lambda = acos(c) - elevationBound;
+        if (fabs(asin(u[2])) > orbit.inclination + lambda)
+            continue;
+
+        // Any visible moment is closer than half of step to some sample,
+        // which is inside the threshold
+        const double threshold = lambda + orbit.maxRate * step;
+        const double cosThreshold = threshold < M_PI ? cos(threshold) : -1;
+        const double skipRate = orbit.maxRate * step;
+
+        Elevation elevation(propagator, station);
+        std::size_t k = 0;
+        while (k < count)
+        {
+            double cosAngle = (u[0] * x[k] + u[1] * y[k] + u[2] * z[k]) / r[k];
+            if (cosAngle < cosThreshold)
+            {
+                // The angle can not reach the threshold faster than
+                // at the maximal rate
+                double skip = (acos(cosAngle) - threshold) / skipRate;
+                k += skip > 1 ? static_cast<std::size_t>(skip) : 1;
+                continue;
+            }
+
+            // Window of candidate samples with one guard sample at each side
+            std::size_t k1 = k;
+            while (k1 + 1 < count && (u[0] * x[k1 + 1] + u[1] * y[k1 + 1]
+                                    + u[2] * z[k1 + 1]) / r[k1 + 1]
+                                     >= cosThreshold)
+            {
+                ++k1;
+            }
+            std::size_t k0 = k > 0 ? k - 1 : 0;
+            k = k1 + 1;
+            if (k1 + 1 < count)
+                ++k1;
+
+            double point[3] = {x[k0], y[k0], z[k0]};
+            double elPrev = 0;
+            double elCur = station.elevation(point);
+            bool open = false;
+            double rise = 0, culmination = 0, maxElevation = 0;
+            if (elCur >= minElevation)
+            {
+                open = true;
+                rise = k0 ? findCrossing(elevation, minElevation,
+                                         grid.time(k0 - 1), grid.time(k0),
+                                         m_tolerance)
+                          : start;
+                culmination = grid.time(k0);
+                maxElevation = elCur;
+            }
+
+            for (std::size_t j = k0; j <= k1; ++j)
+            {
+                const double t = grid.time(j);
+                if (j > k0)
+                {
+                    bool wasVisible = elPrev >= minElevation;
+                    bool visible = elCur >= minElevation;
+                    if (!wasVisible && visible)
+                    {
+                        rise = findCrossing(elevation, minElevation,
+                                            grid.time(j - 1), t,
+                                            m_tolerance);
+                        open = true;
+                        culmination = rise;
+                        maxElevation = minElevation;
+                    }
+                    else if (wasVisible && !visible)
+                    {
+                        double set = findCrossing(elevation, minElevation,
+                                                  grid.time(j - 1), t,
+                                                  m_tolerance);
+                        passes.push_back(makePass(s, satellite, rise,
+                                                  culmination, set,
+                                                  maxElevation));
+                        open = false;
+                    }
+                }
+                if (open && elCur > maxElevation)
+                {
+                    maxElevation = elCur;
+                    culmination = t;
+                }
+
+                double elNext = 0;
+                if (j < k1)
+                {
+                    point[0] = x[j + 1];
+                    point[1] = y[j + 1];
+                    point[2] = z[j + 1];
+                    elNext = station.elevation(point);
+                }
+
+                // Refine the local maximum; it may reveal the short pass
+                // between two invisible samples.
+                if (j > k0 && j < k1 && elCur >= elPrev && elCur >= elNext)
+                {
+                    double tMax, elMax;
+                    findMaximum(elevation, grid.time(j - 1),
+                                grid.time(j + 1), m_tolerance, tMax, elMax);
+                    if (open)
+                    {
+                        if (elMax > maxElevation)
+                        {
+                            maxElevation = elMax;
+                            culmination = tMax;
+                        }
+                    }
+                    else if (elMax >= minElevation)
+                    {
+                        double a = findCrossing(elevation, minElevation,
+                                                grid.time(j - 1), tMax,
+                                                m_tolerance);
+                        double b = findCrossing(elevation, minElevation,
+                                                tMax, grid.time(j + 1),
+                                                m_tolerance);
+                        passes.push_back(makePass(s, satellite, a, tMax, b,
+                                                  elMax));
+                    }
+                }
+
+                elPrev = elCur;
+                elCur = elNext;
+            }
+
+            if (open)
+            {
+                double set = k1 + 1 < count
+                        ? findCrossing(elevation, minElevation,
+                                       grid.time(k1), grid.time(k1 + 1),
+                                       m_tolerance)
+                        : stop;
+                passes.push_back(makePass(s, satellite, rise, culmination,
+                                          set, maxElevation));
+            }
+        }
+    }
+}
+//------------------------------------------------------------------------------
+
+}  // namespace quicktle
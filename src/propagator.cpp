@@ -0,0 +1,444 @@
+/*-----------------------------------------------------------------------------+
+ | QuickTle                                                                    |
+ | Copyright 2011-2015 Sergei Fundaev                                          |
+ +-----------------------------------------------------------------------------+
+ | This file is part of QuickTle library.                                      |
+ |                                                                             |
+ | QuickTle is free software: you can redistribute it and/or modify            |
+ | it under the terms of the GNU Lesser General Public License as published by |
+ | the Free Software Foundation, either version 3 of the License, or           |
+ | (at your option) any later version.                                         |
+ |                                                                             |
+ | QuickTle is distributed in the hope that it will be useful,                 |
+ | but WITHOUT ANY WARRANTY; without even the implied warranty of              |
+ | MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               |
+ | GNU Lesser General Public License for more details.                         |
+ |                                                                             |
+ | You should have received a copy of the GNU Lesser General Public License    |
+ | along with QuickTle. If not, see <http://www.gnu.org/licenses/>.            |
+ +----------------------------------------------------------------------------*/
+/*!
+    \file propagator.cpp
+    \brief File contains the realization of methods of
+           quicktle::BasicPropagator class and the functions for dense
+           ephemeris generation.
+*/
+
+#define GM 3.986004418e14
+#define MAX_ANGLE (2 * M_PI)
+#define J2 1.08262668e-3              //!< Second zonal harmonic of the Earth
+#define EARTH_RADIUS 6378137.         //!< Equatorial radius of the Earth [m]
+
+#include <cmath>
+#include <quicktle/propagator.h>
+#include <quicktle/dataset.h>
+#include <quicktle/func.h>
+#include "kepler.h"
+
+namespace quicktle
+{
+
+template <typename Real>
+BasicPropagator<Real>::BasicPropagator()
+    : m_mathMode(AccurateMath), m_model(TwoBody)
+{
+    m_epoch = m_M0 = m_n = m_n0 = 0;
+    m_dM = m_dOmega = m_domega = 0;
+    m_Omega0 = m_omega0 = m_sini = m_cosi = 0;
+    m_e = m_an = m_bn = m_a = m_b = 0;
+    for (int k = 0; k < 3; ++k)
+        m_P[k] = m_Q[k] = 0;
+}
+//------------------------------------------------------------------------------
+
+template <typename Real>
+BasicPropagator<Real>::BasicPropagator(const Node &node, MathMode mode,
+                                       OrbitModel model)
+    : m_mathMode(mode), m_model(model)
+{
+    assign(node);
+}
+//------------------------------------------------------------------------------
+
+template <typename Real>
+void BasicPropagator<Real>::assign(const Node &node)
+{
+    m_epoch = node.preciseEpoch();
+    m_M0 = node.M();
+    m_n0 = node.n();
+
+    double e = node.e();
+    double a = node.a();
+    double b = a * sqrt(1 - e * e);
+    m_e = static_cast<Real>(e);
+    m_a = static_cast<Real>(a);
+    m_b = static_cast<Real>(b);
+
+    const double *R = node.orientation();
+    for (int k = 0; k < 3; ++k)
+    {
+        m_P[k] = static_cast<Real>(R[3 * k]);
+        m_Q[k] = static_cast<Real>(R[3 * k + 1]);
+    }
+
+    // First-order secular rates of J2 (Vallado, "Fundamentals of
+    // Astrodynamics and Applications", 9.6)
+    m_Omega0 = node.Omega();
+    m_omega0 = node.omega();
+    m_sini = sin(node.i());
+    m_cosi = cos(node.i());
+    double p = a * (1 - e * e);
+    double k = 1.5 * J2 * m_n0 * (EARTH_RADIUS / p) * (EARTH_RADIUS / p);
+    double cos2i = m_cosi * m_cosi;
+    m_dOmega = -k * m_cosi;
+    m_domega = 0.5 * k * (5 * cos2i - 1);
+    m_dM = 0.5 * k * sqrt(1 - e * e) * (3 * cos2i - 1);
+
+    updateModel();
+}
+//------------------------------------------------------------------------------
+
+template <typename Real>
+void BasicPropagator<Real>::updateModel()
+{
+    m_n = m_model == J2Secular ? m_n0 + m_dM : m_n0;
+    m_an = static_cast<Real>(m_a * m_n);
+    m_bn = static_cast<Real>(m_b * m_n);
+}
+//------------------------------------------------------------------------------
+
+template <typename Real>
+double BasicPropagator<Real>::epoch() const
+{
+    return m_epoch;
+}
+//------------------------------------------------------------------------------
+
+template <typename Real>
+MathMode BasicPropagator<Real>::mathMode() const
+{
+    return m_mathMode;
+}
+//------------------------------------------------------------------------------
+
+template <typename Real>
+void BasicPropagator<Real>::setMathMode(MathMode mode)
+{
+    m_mathMode = mode;
+}
+//------------------------------------------------------------------------------
+
+template <typename Real>
+OrbitModel BasicPropagator<Real>::orbitModel() const
+{
+    return m_model;
+}
+//------------------------------------------------------------------------------
+
+template <typename Real>
+void BasicPropagator<Real>::setOrbitModel(OrbitModel model)
+{
+    m_model = model;
+    updateModel();
+}
+//------------------------------------------------------------------------------
+
+template <typename Real>
+double BasicPropagator<Real>::OmegaRate() const
+{
+    return m_model == J2Secular ? m_dOmega : 0;
+}
+//------------------------------------------------------------------------------
+
+template <typename Real>
+double BasicPropagator<Real>::omegaRate() const
+{
+    return m_model == J2Secular ? m_domega : 0;
+}
+//------------------------------------------------------------------------------
+
+template <typename Real>
+double BasicPropagator<Real>::meanAnomalyRate() const
+{
+    return m_n;
+}
+//------------------------------------------------------------------------------
+
+template <typename Real>
+template <typename SinCos>
+void BasicPropagator<Real>::driftedAxes(double dt, Real *P, Real *Q) const
+{
+    Real sinO, cosO, sinw, cosw;
+    SinCos::compute(static_cast<Real>(normalizeAngle(m_Omega0 + m_dOmega * dt)),
+                    sinO, cosO);
+    SinCos::compute(static_cast<Real>(normalizeAngle(m_omega0 + m_domega * dt)),
+                    sinw, cosw);
+    Real sini = static_cast<Real>(m_sini);
+    Real cosi = static_cast<Real>(m_cosi);
+
+    // Columns of the orientation matrix of Node::orientation()
+    P[0] = cosO * cosw - sinO * sinw * cosi;
+    P[1] = sinO * cosw + cosO * sinw * cosi;
+    P[2] = sinw * sini;
+    Q[0] = -cosO * sinw - sinO * cosw * cosi;
+    Q[1] = -sinO * sinw + cosO * cosw * cosi;
+    Q[2] = cosw * sini;
+}
+//------------------------------------------------------------------------------
+
+template <typename Real>
+double BasicPropagator<Real>::meanAnomaly(double t) const
+{
+    return normalizeAngle(m_M0 + m_n * (t - m_epoch));
+}
+//------------------------------------------------------------------------------
+
+template <typename Real>
+void BasicPropagator<Real>::state(double t, Real *position,
+                                  Real *velocity) const
+{
+    state(t, position, velocity, m_mathMode);
+}
+//------------------------------------------------------------------------------
+
+template <typename Real>
+void BasicPropagator<Real>::state(double t, Real *position, Real *velocity,
+                                  MathMode mode) const
+{
+    if (mode == FastMath)
+        computeState<FastSinCos>(t, position, velocity);
+    else
+        computeState<AccurateSinCos>(t, position, velocity);
+}
+//------------------------------------------------------------------------------
+
+template <typename Real>
+template <typename SinCos>
+void BasicPropagator<Real>::computeState(double t, Real *position,
+                                         Real *velocity) const
+{
+    Real M = static_cast<Real>(meanAnomaly(t));
+    Real sinE, cosE;
+    solveKepler<SinCos>(M, m_e, keplerGuess(M, m_e), sinE, cosE);
+
+    const bool secular = m_model == J2Secular;
+    Real axes[6];
+    const Real *P = m_P;
+    const Real *Q = m_Q;
+    if (secular)
+    {
+        driftedAxes<SinCos>(t - m_epoch, axes, axes + 3);
+        P = axes;
+        Q = axes + 3;
+    }
+
+    Real xp = m_a * (cosE - m_e);
+    Real yp = m_b * sinE;
+    for (int k = 0; k < 3; ++k)
+        position[k] = xp * P[k] + yp * Q[k];
+
+    if (!velocity)
+        return;
+
+    Real f = 1 / (1 - m_e * cosE);
+    Real vxp = -m_an * sinE * f;
+    Real vyp = m_bn * cosE * f;
+    if (secular)
+    {
+        // Rotation of the perigee in the plane and of the plane about Z
+        Real domega = static_cast<Real>(m_domega);
+        vxp -= domega * yp;
+        vyp += domega * xp;
+    }
+    for (int k = 0; k < 3; ++k)
+        velocity[k] = vxp * P[k] + vyp * Q[k];
+    if (secular)
+    {
+        Real dOmega = static_cast<Real>(m_dOmega);
+        velocity[0] -= dOmega * position[1];
+        velocity[1] += dOmega * position[0];
+    }
+}
+//------------------------------------------------------------------------------
+
+template <typename Real>
+std::size_t BasicPropagator<Real>::samples(double start, double stop,
+                                           double step)
+{
+    if (!(step > 0) || stop < start)
+        return 0;
+
+    // Allow the rounding error in the last sample
+    return static_cast<std::size_t>(floor((stop - start) / step + 1e-9)) + 1;
+}
+//------------------------------------------------------------------------------
+
+template <typename Real>
+std::size_t BasicPropagator<Real>::ephemeris(double start, double stop,
+                                             double step,
+                                             Real *x, Real *y, Real *z,
+                                             Real *vx, Real *vy,
+                                             Real *vz) const
+{
+    std::size_t count = samples(start, stop, step);
+    propagate(start, step, count, x, y, z, vx, vy, vz);
+    return count;
+}
+//------------------------------------------------------------------------------
+
+template <typename Real>
+void BasicPropagator<Real>::propagate(double start, double step,
+                                      std::size_t count,
+                                      Real *x, Real *y, Real *z,
+                                      Real *vx, Real *vy, Real *vz) const
+{
+    if (m_mathMode == FastMath)
+        computeGrid<FastSinCos>(start, step, count, x, y, z, vx, vy, vz);
+    else
+        computeGrid<AccurateSinCos>(start, step, count, x, y, z, vx, vy, vz);
+}
+//------------------------------------------------------------------------------
+
+template <typename Real>
+template <typename SinCos>
+void BasicPropagator<Real>::computeGrid(double start, double step,
+                                        std::size_t count,
+                                        Real *x, Real *y, Real *z,
+                                        Real *vx, Real *vy, Real *vz) const
+{
+    if (!count)
+        return;
+
+    const bool withVelocity = vx && vy && vz;
+    const bool secular = m_model == J2Secular;
+    const double M0 = meanAnomaly(start);
+    const double dM = m_n * step;
+    const Real maxAngle = static_cast<Real>(MAX_ANGLE);
+    const Real domega = static_cast<Real>(m_domega);
+    const Real dOmega = static_cast<Real>(m_dOmega);
+
+    Real axes[6];
+    const Real *P = m_P;
+    const Real *Q = m_Q;
+    if (secular)
+    {
+        P = axes;
+        Q = axes + 3;
+    }
+
+    // M is computed as M0 + k * dM minus the completed turns, so the rounding
+    // error does not accumulate; E is warm-started from the previous sample.
+    double turns = 0;
+    double M = M0;
+    Real sinE, cosE;
+    Real E = solveKepler<SinCos>(static_cast<Real>(M), m_e,
+                         keplerGuess(static_cast<Real>(M), m_e), sinE, cosE);
+
+    for (std::size_t k = 0; ; )
+    {
+        if (secular)
+            driftedAxes<SinCos>(start - m_epoch + k * step, axes, axes + 3);
+
+        Real xp = m_a * (cosE - m_e);
+        Real yp = m_b * sinE;
+        x[k] = xp * P[0] + yp * Q[0];
+        y[k] = xp * P[1] + yp * Q[1];
+        z[k] = xp * P[2] + yp * Q[2];
+
+        Real f = 1 / (1 - m_e * cosE);
+        if (withVelocity)
+        {
+            Real vxp = -m_an * sinE * f;
+            Real vyp = m_bn * cosE * f;
+            if (secular)
+            {
+                vxp -= domega * yp;
+                vyp += domega * xp;
+            }
+            vx[k] = vxp * P[0] + vyp * Q[0];
+            vy[k] = vxp * P[1] + vyp * Q[1];
+            vz[k] = vxp * P[2] + vyp * Q[2];
+            if (secular)
+            {
+                vx[k] -= dOmega * y[k];
+                vy[k] += dOmega * x[k];
+            }
+        }
+
+        if (++k == count)
+            break;
+
+        M = M0 + k * dM - turns * MAX_ANGLE;
+        E += static_cast<Real>(dM) * f;
+        while (M >= MAX_ANGLE)
+        {
+            M -= MAX_ANGLE;
+            E -= maxAngle;
+            turns += 1;
+        }
+        while (M < 0)
+        {
+            M += MAX_ANGLE;
+            E += maxAngle;
+            turns -= 1;
+        }
+        E = solveKepler<SinCos>(static_cast<Real>(M), m_e, E, sinE, cosE);
+    }
+}
+//------------------------------------------------------------------------------
+
+template class BasicPropagator<double>;
+template class BasicPropagator<float>;
+//------------------------------------------------------------------------------
+
+//! ephemeris() for a DataSet in the given precision
+template <typename Real>
+static std::size_t dataSetEphemeris(const DataSet &dataSet,
+                                    double start, double stop, double step,
+                                    Real *x, Real *y, Real *z,
+                                    Real *vx, Real *vy, Real *vz)
+{
+    std::size_t count = Propagator::samples(start, stop, step);
+    if (!count || !dataSet.size())
+        return 0;
+
+    DataSet::Cursor cursor;
+    const bool withVelocity = vx && vy && vz;
+    for (std::size_t k = 0; k < count; ++k)
+    {
+        double r[3], v[3];
+        dataSet.stateAt(cursor, start + k * step, r, withVelocity ? v : 0);
+        x[k] = static_cast<Real>(r[0]);
+        y[k] = static_cast<Real>(r[1]);
+        z[k] = static_cast<Real>(r[2]);
+        if (withVelocity)
+        {
+            vx[k] = static_cast<Real>(v[0]);
+            vy[k] = static_cast<Real>(v[1]);
+            vz[k] = static_cast<Real>(v[2]);
+        }
+    }
+
+    return count;
+}
+//------------------------------------------------------------------------------
+
+std::size_t ephemeris(const DataSet &dataSet,
+                      double start, double stop, double step,
+                      double *x, double *y, double *z,
+                      double *vx, double *vy, double *vz)
+{
+    return dataSetEphemeris(dataSet, start, stop, step, x, y, z, vx, vy, vz);
+}
+//------------------------------------------------------------------------------
+
+std::size_t ephemeris(const DataSet &dataSet,
+                      double start, double stop, double step,
+                      float *x, float *y, float *z,
+                      float *vx, float *vy, float *vz)
+{
+    return dataSetEphemeris(dataSet, start, stop, step, x, y, z, vx, vy, vz);
+}
+//------------------------------------------------------------------------------
+
+}  // namespace quicktle
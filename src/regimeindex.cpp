@@ -0,0 +1,229 @@
+/*-----------------------------------------------------------------------------+
+ | QuickTle                                                                    |
+ | Copyright 2011-2015 Sergei Fundaev                                          |
+ +-----------------------------------------------------------------------------+
+ | This file is part of QuickTle library.                                      |
+ |                                                                             |
+ | QuickTle is free software: you can redistribute it and/or modify            |
+ | it under the terms of the GNU Lesser General Public License as published by |
+ | the Free Software Foundation, either version 3 of the License, or           |
+ | (at your option) any later version.                                         |
+ |                                                                             |
+ | QuickTle is distributed in the hope that it will be useful,                 |
+ | but WITHOUT ANY WARRANTY; without even the implied warranty of              |
+ | MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               |
+ | GNU Lesser General Public License for more details.                         |
+ |                                                                             |
+ | You should have received a copy of the GNU Lesser General Public License    |
+ | along with QuickTle. If not, see <http://www.gnu.org/licenses/>.            |
+ +----------------------------------------------------------------------------*/
+/*!
+    \file regimeindex.cpp
+    \brief File contains the realization of methods of
+           quicktle::RegimeIndex class.
+*/
+
+#define EARTH_RADIUS 6378137.         //!< Equatorial radius of the Earth [m]
+
+#include <cmath>
+#include <algorithm>
+#include <limits>
+#include <quicktle/regimeindex.h>
+
+namespace quicktle
+{
+
+RegimeIndex::RegimeIndex()
+{
+}
+//------------------------------------------------------------------------------
+
+RegimeIndex::RegimeIndex(const std::vector<Node> &catalog)
+{
+    setCatalog(catalog);
+}
+//------------------------------------------------------------------------------
+
+RegimeIndex::Band RegimeIndex::band(std::size_t k, const Node &node)
+{
+    Band band;
+    double a = node.a();
+    band.perigee = a * (1 - node.e()) - EARTH_RADIUS;
+    band.apogee = a * (1 + node.e()) - EARTH_RADIUS;
+    band.inclination = node.i();
+    band.satellite = static_cast<std::uint32_t>(k);
+    return band;
+}
+//------------------------------------------------------------------------------
+
+void RegimeIndex::setCatalog(const std::vector<Node> &catalog)
+{
+    const std::size_t count = catalog.size();
+    m_bands.resize(count);
+    for (std::size_t k = 0; k < count; ++k)
+        m_bands[k] = band(k, catalog[k]);
+    std::sort(m_bands.begin(), m_bands.end());
+
+    m_positions.resize(count);
+    for (std::size_t j = 0; j < count; ++j)
+        m_positions[m_bands[j].satellite] = j;
+
+    m_max.resize(count);
+    buildMax(0, count);
+}
+//------------------------------------------------------------------------------
+
+void RegimeIndex::update(std::size_t k, const Node &node)
+{
+    const std::size_t count = m_bands.size();
+    Band updated = band(k, node);
+    std::size_t position = m_positions[k];
+
+    // The order is kept: only the maxima on the path to the band change
+    if ((position == 0 || m_bands[position - 1] < updated)
+        && (position + 1 == count || updated < m_bands[position + 1]))
+    {
+        m_bands[position] = updated;
+        refreshMax(0, count, position);
+        return;
+    }
+
+    m_bands.erase(m_bands.begin() + position);
+    std::vector<Band>::iterator it = std::lower_bound(m_bands.begin(),
+                                                      m_bands.end(), updated);
+    std::size_t target = it - m_bands.begin();
+    m_bands.insert(it, updated);
+
+    std::size_t first = std::min(position, target);
+    std::size_t last = std::max(position, target);
+    for (std::size_t j = first; j <= last; ++j)
+        m_positions[m_bands[j].satellite] = j;
+    buildMax(0, count);
+}
+//------------------------------------------------------------------------------
+
+std::size_t RegimeIndex::size() const
+{
+    return m_bands.size();
+}
+//------------------------------------------------------------------------------
+
+double RegimeIndex::perigee(std::size_t k) const
+{
+    return m_bands[m_positions[k]].perigee;
+}
+//------------------------------------------------------------------------------
+
+double RegimeIndex::apogee(std::size_t k) const
+{
+    return m_bands[m_positions[k]].apogee;
+}
+//------------------------------------------------------------------------------
+
+double RegimeIndex::inclination(std::size_t k) const
+{
+    return m_bands[m_positions[k]].inclination;
+}
+//------------------------------------------------------------------------------
+
+void RegimeIndex::overlapping(double lower, double upper,
+                              std::vector<std::size_t> &result) const
+{
+    result.clear();
+    auto add = [&](const Band &band)
+    {
+        result.push_back(band.satellite);
+    };
+    query(0, m_bands.size(), lower, upper, add);
+}
+//------------------------------------------------------------------------------
+
+void RegimeIndex::overlapping(double lower, double upper,
+                              double minInclination, double maxInclination,
+                              std::vector<std::size_t> &result) const
+{
+    result.clear();
+    auto add = [&](const Band &band)
+    {
+        if (band.inclination >= minInclination
+            && band.inclination <= maxInclination)
+        {
+            result.push_back(band.satellite);
+        }
+    };
+    query(0, m_bands.size(), lower, upper, add);
+}
+//------------------------------------------------------------------------------
+
+void RegimeIndex::containing(double altitude,
+                             std::vector<std::size_t> &result) const
+{
+    overlapping(altitude, altitude, result);
+}
+//------------------------------------------------------------------------------
+
+void RegimeIndex::containing(double altitude, double minInclination,
+                             double maxInclination,
+                             std::vector<std::size_t> &result) const
+{
+    overlapping(altitude, altitude, minInclination, maxInclination, result);
+}
+//------------------------------------------------------------------------------
+
+double RegimeIndex::rangeMax(std::size_t first, std::size_t last) const
+{
+    if (first >= last)
+        return -std::numeric_limits<double>::infinity();
+    return m_max[(first + last) / 2];
+}
+//------------------------------------------------------------------------------
+
+double RegimeIndex::buildMax(std::size_t first, std::size_t last)
+{
+    if (first >= last)
+        return -std::numeric_limits<double>::infinity();
+    std::size_t middle = (first + last) / 2;
+    double left = buildMax(first, middle);
+    double right = buildMax(middle + 1, last);
+    m_max[middle] = std::max(m_bands[middle].apogee, std::max(left, right));
+    return m_max[middle];
+}
+//------------------------------------------------------------------------------
+
+void RegimeIndex::refreshMax(std::size_t first, std::size_t last,
+                             std::size_t position)
+{
+    std::size_t middle = (first + last) / 2;
+    if (position < middle)
+        refreshMax(first, middle, position);
+    else if (position > middle)
+        refreshMax(middle + 1, last, position);
+    m_max[middle] = std::max(m_bands[middle].apogee,
+                             std::max(rangeMax(first, middle),
+                                      rangeMax(middle + 1, last)));
+}
+//------------------------------------------------------------------------------
+
+template <typename Function>
+void RegimeIndex::query(std::size_t first, std::size_t last, double lower,
+                        double upper, Function &function) const
+{
+    while (first < last)
+    {
+        std::size_t middle = (first + last) / 2;
+        if (m_max[middle] < lower)
+            return;
+        query(first, middle, lower, upper, function);
+
+        // The perigees of the right part are not lower
+        const Band &band = m_bands[middle];
+        if (band.perigee > upper)
+            return;
+        if (band.apogee >= lower)
+            function(band);
+        first = middle + 1;
+    }
+}
+//------------------------------------------------------------------------------
+
+}  // namespace quicktle
@@ -0,0 +1,157 @@
+/*-----------------------------------------------------------------------------+
+ | QuickTle                                                                    |
+ | Copyright 2011-2015 Sergei Fundaev                                          |
+ +-----------------------------------------------------------------------------+
+ | This file is part of QuickTle library.                                      |
+ |                                                                             |
+ | QuickTle is free software: you can redistribute it and/or modify            |
+ | it under the terms of the GNU Lesser General Public License as published by |
+ | the Free Software Foundation, either version 3 of the License, or           |
+ | (at your option) any later version.                                         |
+ |                                                                             |
+ | QuickTle is distributed in the hope that it will be useful,                 |
+ | but WITHOUT ANY WARRANTY; without even the implied warranty of              |
+ | MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               |
+ | GNU Lesser General Public License for more details.                         |
+ |                                                                             |
+ | You should have received a copy of the GNU Lesser General Public License    |
+ | along with QuickTle. If not, see <http://www.gnu.org/licenses/>.            |
+ +----------------------------------------------------------------------------*/
+/*!
+    \file relativemotion.cpp
+    \brief File contains the realization of the functions for the relative
+           motion of the satellites.
+*/
+
+#define BLOCK_SAMPLES 256
+
+#include <cmath>
+#include <quicktle/propagator.h>
+#include <quicktle/relativemotion.h>
+
+namespace quicktle
+{
+
+namespace
+{
+
+//! Orbital frame of the primary satellite at one sample
+struct Frame
+{
+    double position[3];
+    double velocity[3];
+    double axes[9];      //!< Rows: R, I, C unit vectors
+    double rate;         //!< Angular rate of the frame about C [rad/s]
+};
+//------------------------------------------------------------------------------
+
+} // namespace
+
+//! Compute the RIC frame of the primary satellite by its state vector
+static inline void computeFrame(const double *r, const double *v,
+                                Frame &frame)
+{
+    for (int i = 0; i < 3; ++i)
+    {
+        frame.position[i] = r[i];
+        frame.velocity[i] = v[i];
+    }
+
+    double h[3] = {r[1] * v[2] - r[2] * v[1],
+                   r[2] * v[0] - r[0] * v[2],
+                   r[0] * v[1] - r[1] * v[0]};
+    double r2 = r[0] * r[0] + r[1] * r[1] + r[2] * r[2];
+    double rLength = sqrt(r2);
+    double hLength = sqrt(h[0] * h[0] + h[1] * h[1] + h[2] * h[2]);
+
+    double *R = frame.axes;
+    double *I = frame.axes + 3;
+    double *C = frame.axes + 6;
+    for (int i = 0; i < 3; ++i)
+    {
+        R[i] = r[i] / rLength;
+        C[i] = h[i] / hLength;
+    }
+    I[0] = C[1] * R[2] - C[2] * R[1];
+    I[1] = C[2] * R[0] - C[0] * R[2];
+    I[2] = C[0] * R[1] - C[1] * R[0];
+    frame.rate = hLength / r2;
+}
+//------------------------------------------------------------------------------
+
+void relativeMotion(const Node &primary, const std::vector<Node> &secondaries,
+                    double start, double step, std::size_t count,
+                    double *positions, double *velocities, unsigned threads)
+{
+    if (!count || secondaries.empty())
+        return;
+
+    std::vector<Frame> frames(count);
+    const Propagator propagator(primary);
+    for (std::size_t j = 0; j < count; ++j)
+    {
+        double r[3], v[3];
+        propagator.state(start + j * step, r, v);
+        computeFrame(r, v, frames[j]);
+    }
+
+    ThreadPool &pool = ThreadPool::instance();
+    pool.parallelFor(secondaries.size(), 1,
+                     [&](std::size_t first, std::size_t last)
+    {
+        double x[BLOCK_SAMPLES], y[BLOCK_SAMPLES], z[BLOCK_SAMPLES];
+        double vx[BLOCK_SAMPLES], vy[BLOCK_SAMPLES], vz[BLOCK_SAMPLES];
+        for (std::size_t k = first; k < last; ++k)
+        {
+            const Propagator secondary(secondaries[k]);
+            for (std::size_t block = 0; block < count; block += BLOCK_SAMPLES)
+            {
+                std::size_t size = count - block;
+                if (size > BLOCK_SAMPLES)
+                    size = BLOCK_SAMPLES;
+                secondary.propagate(start + block * step, step, size,
+                                    x, y, z, vx, vy, vz);
+
+                for (std::size_t j = 0; j < size; ++j)
+                {
+                    const Frame &frame = frames[block + j];
+                    const double *axes = frame.axes;
+                    double d[3] = {x[j] - frame.position[0],
+                                   y[j] - frame.position[1],
+                                   z[j] - frame.position[2]};
+                    double rho[3];
+                    for (int i = 0; i < 3; ++i)
+                    {
+                        rho[i] = axes[3 * i] * d[0] + axes[3 * i + 1] * d[1] +
+                                 axes[3 * i + 2] * d[2];
+                    }
+
+                    const std::size_t index = 3 * (k * count + block + j);
+                    positions[index] = rho[0];
+                    positions[index + 1] = rho[1];
+                    positions[index + 2] = rho[2];
+                    if (!velocities)
+                        continue;
+
+                    double dv[3] = {vx[j] - frame.velocity[0],
+                                    vy[j] - frame.velocity[1],
+                                    vz[j] - frame.velocity[2]};
+                    double w[3];
+                    for (int i = 0; i < 3; ++i)
+                    {
+                        w[i] = axes[3 * i] * dv[0] + axes[3 * i + 1] * dv[1] +
+                               axes[3 * i + 2] * dv[2];
+                    }
+
+                    // Subtract the transport velocity of the rotating frame
+                    velocities[index] = w[0] + frame.rate * rho[1];
+                    velocities[index + 1] = w[1] - frame.rate * rho[0];
+                    velocities[index + 2] = w[2];
+                }
+            }
+        }
+    }, threads);
+}
+//------------------------------------------------------------------------------
+
+}  // namespace quicktle
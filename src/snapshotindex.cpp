@@ -0,0 +1,312 @@
+/*-----------------------------------------------------------------------------+
+ | QuickTle                                                                    |
+ | Copyright 2011-2015 Sergei Fundaev                                          |
+ +-----------------------------------------------------------------------------+
+ | This file is part of QuickTle library.                                      |
+ |                                                                             |
+ | QuickTle is free software: you can redistribute it and/or modify            |
+ | it under the terms of the GNU Lesser General Public License as published by |
+ | the Free Software Foundation, either version 3 of the License, or           |
+ | (at your option) any later version.                                         |
+ |                                                                             |
+ | QuickTle is distributed in the hope that it will be useful,                 |
+ | but WITHOUT ANY WARRANTY; without even the implied warranty of              |
+ | MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               |
+ | GNU Lesser General Public License for more details.                         |
+ |                                                                             |
+ | You should have received a copy of the GNU Lesser General Public License    |
+ | along with QuickTle. If not, see <http://www.gnu.org/licenses/>.            |
+ +----------------------------------------------------------------------------*/
+/*!
+    \file snapshotindex.cpp
+    \brief File contains the realization of methods of
+           quicktle::SnapshotIndex class.
+*/
+
+#define DEFAULT_CELL_SIZE 500e3
+#define SATELLITES_GRAIN 1024
+
+#include <cmath>
+#include <algorithm>
+#include <quicktle/snapshotindex.h>
+#include <quicktle/threadpool.h>
+#include "celltable.h"
+
+namespace quicktle
+{
+
+//! Cell index of the coordinate
+static inline std::int64_t cellIndex(double x, double cellSize)
+{
+    return static_cast<std::int64_t>(floor(x / cellSize));
+}
+//------------------------------------------------------------------------------
+
+SnapshotIndex::SnapshotIndex()
+    : m_table(new CellTable), m_t(0), m_cellSize(DEFAULT_CELL_SIZE),
+      m_threads(0), m_valid(false)
+{
+}
+//------------------------------------------------------------------------------
+
+SnapshotIndex::SnapshotIndex(const std::vector<Node> &catalog)
+    : m_table(new CellTable), m_t(0), m_cellSize(DEFAULT_CELL_SIZE),
+      m_threads(0), m_valid(false)
+{
+    setCatalog(catalog);
+}
+//------------------------------------------------------------------------------
+
+SnapshotIndex::~SnapshotIndex()
+{
+}
+//------------------------------------------------------------------------------
+
+void SnapshotIndex::setCatalog(const std::vector<Node> &catalog)
+{
+    m_propagators.resize(catalog.size());
+    for (std::size_t k = 0; k < catalog.size(); ++k)
+        m_propagators[k].assign(catalog[k]);
+    m_positions.clear();
+    m_keys.clear();
+    m_entries.clear();
+    m_table->build(m_entries);
+    m_valid = false;
+}
+//------------------------------------------------------------------------------
+
+std::size_t SnapshotIndex::size() const
+{
+    return m_propagators.size();
+}
+//------------------------------------------------------------------------------
+
+double SnapshotIndex::cellSize() const
+{
+    return m_cellSize;
+}
+//------------------------------------------------------------------------------
+
+void SnapshotIndex::setCellSize(double cellSize)
+{
+    m_cellSize = cellSize;
+    if (m_valid)
+    {
+        for (std::size_t k = 0; k < m_keys.size(); ++k)
+            m_keys[k] = key(&m_positions[3 * k]);
+        rebuild();
+    }
+}
+//------------------------------------------------------------------------------
+
+unsigned SnapshotIndex::threads() const
+{
+    return m_threads;
+}
+//------------------------------------------------------------------------------
+
+void SnapshotIndex::setThreads(unsigned threads)
+{
+    m_threads = threads;
+}
+//------------------------------------------------------------------------------
+
+double SnapshotIndex::time() const
+{
+    return m_t;
+}
+//------------------------------------------------------------------------------
+
+const double* SnapshotIndex::position(std::size_t k) const
+{
+    return &m_positions[3 * k];
+}
+//------------------------------------------------------------------------------
+
+std::uint64_t SnapshotIndex::key(const double *position) const
+{
+    return cellKey(cellIndex(position[0], m_cellSize),
+                   cellIndex(position[1], m_cellSize),
+                   cellIndex(position[2], m_cellSize));
+}
+//------------------------------------------------------------------------------
+
+void SnapshotIndex::rebuild()
+{
+    m_entries.resize(m_keys.size());
+    for (std::size_t k = 0; k < m_keys.size(); ++k)
+        m_entries[k] = CellEntry(m_keys[k], static_cast<std::uint32_t>(k));
+    std::sort(m_entries.begin(), m_entries.end());
+    m_table->build(m_entries);
+}
+//------------------------------------------------------------------------------
+
+void SnapshotIndex::update(double t)
+{
+    const std::size_t n = m_propagators.size();
+    m_t = t;
+    m_positions.resize(3 * n);
+    m_keys.resize(n);
+
+    ThreadPool &pool = ThreadPool::instance();
+    pool.parallelFor(n, SATELLITES_GRAIN,
+                     [&](std::size_t first, std::size_t last)
+                     {
+                         for (std::size_t k = first; k < last; ++k)
+                         {
+                             m_propagators[k].state(t, &m_positions[3 * k]);
+                             m_keys[k] = key(&m_positions[3 * k]);
+                         }
+                     }, m_threads);
+
+    if (!m_valid)
+    {
+        rebuild();
+        m_valid = true;
+        return;
+    }
+
+    // Keep the sorted order of the satellites, which stay in their cells,
+    // and merge the moved ones into it
+    std::vector<CellEntry>::iterator stay = std::stable_partition(
+                m_entries.begin(), m_entries.end(),
+                [this](const CellEntry &entry)
+                {
+                    return m_keys[entry.second] == entry.first;
+                });
+    if (stay == m_entries.end())
+        return;
+    for (std::vector<CellEntry>::iterator it = stay; it != m_entries.end();
+         ++it)
+    {
+        it->first = m_keys[it->second];
+    }
+    std::sort(stay, m_entries.end());
+    std::inplace_merge(m_entries.begin(), stay, m_entries.end());
+    m_table->build(m_entries);
+}
+//------------------------------------------------------------------------------
+
+template <typename Function>
+void SnapshotIndex::forEachCandidate(const double *lower, const double *upper,
+                                     Function function) const
+{
+    std::int64_t first[3], last[3];
+    double cells = 1;
+    for (int i = 0; i < 3; ++i)
+    {
+        first[i] = cellIndex(lower[i], m_cellSize);
+        last[i] = cellIndex(upper[i], m_cellSize);
+        if (last[i] < first[i])
+            return;
+        cells *= double(last[i] - first[i] + 1);
+    }
+
+    // The region is larger than the catalog: scan all satellites
+    if (cells >= double(m_entries.size()))
+    {
+        for (std::size_t k = 0; k < m_entries.size(); ++k)
+            function(m_entries[k].second);
+        return;
+    }
+
+    for (std::int64_t ix = first[0]; ix <= last[0]; ++ix)
+    {
+        for (std::int64_t iy = first[1]; iy <= last[1]; ++iy)
+        {
+            for (std::int64_t iz = first[2]; iz <= last[2]; ++iz)
+            {
+                std::uint32_t begin, end;
+                if (!m_table->find(cellKey(ix, iy, iz), begin, end))
+                    continue;
+                for (std::uint32_t k = begin; k < end; ++k)
+                    function(m_entries[k].second);
+            }
+        }
+    }
+}
+//------------------------------------------------------------------------------
+
+void SnapshotIndex::radius(const double *center, double radius,
+                           std::vector<std::size_t> &result) const
+{
+    result.clear();
+    double lower[3], upper[3];
+    for (int i = 0; i < 3; ++i)
+    {
+        lower[i] = center[i] - radius;
+        upper[i] = center[i] + radius;
+    }
+
+    const double radius2 = radius * radius;
+    forEachCandidate(lower, upper, [&](std::uint32_t k)
+    {
+        const double *p = &m_positions[3 * k];
+        double dx = p[0] - center[0];
+        double dy = p[1] - center[1];
+        double dz = p[2] - center[2];
+        if (dx * dx + dy * dy + dz * dz <= radius2)
+            result.push_back(k);
+    });
+}
+//------------------------------------------------------------------------------
+
+void SnapshotIndex::cone(const double *apex, const double *axis,
+                         double halfAngle, double range,
+                         std::vector<std::size_t> &result) const
+{
+    result.clear();
+    double length = sqrt(axis[0] * axis[0] + axis[1] * axis[1] +
+                         axis[2] * axis[2]);
+    if (length <= 0)
+        return;
+    double a[3] = {axis[0] / length, axis[1] / length, axis[2] / length};
+
+    // Bounding box: the extreme component of the directions within
+    // halfAngle from the axis is reached at the angle, closest to the
+    // coordinate axis
+    double lower[3], upper[3];
+    for (int i = 0; i < 3; ++i)
+    {
+        double toPlus = acos(std::max(-1., std::min(1., a[i])));
+        double toMinus = M_PI - toPlus;
+        double maxPlus = cos(std::max(0., toPlus - halfAngle));
+        double maxMinus = cos(std::max(0., toMinus - halfAngle));
+        upper[i] = apex[i] + range * std::max(0., maxPlus);
+        lower[i] = apex[i] - range * std::max(0., maxMinus);
+    }
+
+    const double range2 = range * range;
+    const double cosHalfAngle = cos(halfAngle);
+    forEachCandidate(lower, upper, [&](std::uint32_t k)
+    {
+        const double *p = &m_positions[3 * k];
+        double d[3] = {p[0] - apex[0], p[1] - apex[1], p[2] - apex[2]};
+        double d2 = d[0] * d[0] + d[1] * d[1] + d[2] * d[2];
+        if (d2 > range2)
+            return;
+        double projection = d[0] * a[0] + d[1] * a[1] + d[2] * a[2];
+        if (projection >= sqrt(d2) * cosHalfAngle)
+            result.push_back(k);
+    });
+}
+//------------------------------------------------------------------------------
+
+void SnapshotIndex::box(const double *lower, const double *upper,
+                        std::vector<std::size_t> &result) const
+{
+    result.clear();
+    forEachCandidate(lower, upper, [&](std::uint32_t k)
+    {
+        const double *p = &m_positions[3 * k];
+        if (p[0] >= lower[0] && p[0] <= upper[0] &&
+            p[1] >= lower[1] && p[1] <= upper[1] &&
+            p[2] >= lower[2] && p[2] <= upper[2])
+        {
+            result.push_back(k);
+        }
+    });
+}
+//------------------------------------------------------------------------------
+
+}  // namespace quicktle
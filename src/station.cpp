@@ -0,0 +1,146 @@
+/*-----------------------------------------------------------------------------+
+ | QuickTle                                                                    |
+ | Copyright 2011-2015 Sergei Fundaev                                          |
+ +-----------------------------------------------------------------------------+
+ | This file is part of QuickTle library.                                      |
+ |                                                                             |
+ | QuickTle is free software: you can redistribute it and/or modify            |
+ | it under the terms of the GNU Lesser General Public License as published by |
+ | the Free Software Foundation, either version 3 of the License, or           |
+ | (at your option) any later version.                                         |
+ |                                                                             |
+ | QuickTle is distributed in the hope that it will be useful,                 |
+ | but WITHOUT ANY WARRANTY; without even the implied warranty of              |
+ | MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               |
+ | GNU Lesser General Public License for more details.                         |
+ |                                                                             |
+ | You should have received a copy of the GNU Lesser General Public License    |
+ | along with QuickTle. If not, see <http://www.gnu.org/licenses/>.            |
+ +----------------------------------------------------------------------------*/
+/*!
+    \file station.cpp
+    \brief File contains the realization of methods of quicktle::Station class.
+*/
+
+#define MAX_ANGLE (2 * M_PI)
+
+#include <cmath>
+#include <quicktle/station.h>
+#include <quicktle/coordinates.h>
+
+namespace quicktle
+{
+
+Station::Station()
+    : m_latitude(0), m_longitude(0), m_altitude(0), m_minElevation(0)
+{
+    init();
+}
+//------------------------------------------------------------------------------
+
+Station::Station(double latitude, double longitude, double altitude,
+                 double minElevation)
+    : m_latitude(latitude), m_longitude(longitude), m_altitude(altitude),
+      m_minElevation(minElevation)
+{
+    init();
+}
+//------------------------------------------------------------------------------
+
+void Station::init()
+{
+    geodetic2ecef(m_latitude, m_longitude, m_altitude, m_position);
+
+    double sphi = sin(m_latitude);
+    double cphi = cos(m_latitude);
+    double slam = sin(m_longitude);
+    double clam = cos(m_longitude);
+
+    m_up[0] = cphi * clam;
+    m_up[1] = cphi * slam;
+    m_up[2] = sphi;
+    m_east[0] = -slam;
+    m_east[1] = clam;
+    m_east[2] = 0;
+    m_north[0] = -sphi * clam;
+    m_north[1] = -sphi * slam;
+    m_north[2] = cphi;
+}
+//------------------------------------------------------------------------------
+
+double Station::latitude() const
+{
+    return m_latitude;
+}
+//------------------------------------------------------------------------------
+
+double Station::longitude() const
+{
+    return m_longitude;
+}
+//------------------------------------------------------------------------------
+
+double Station::altitude() const
+{
+    return m_altitude;
+}
+//------------------------------------------------------------------------------
+
+double Station::minElevation() const
+{
+    return m_minElevation;
+}
+//------------------------------------------------------------------------------
+
+const double* Station::position() const
+{
+    return m_position;
+}
+//------------------------------------------------------------------------------
+
+const double* Station::up() const
+{
+    return m_up;
+}
+//------------------------------------------------------------------------------
+
+const double* Station::east() const
+{
+    return m_east;
+}
+//------------------------------------------------------------------------------
+
+const double* Station::north() const
+{
+    return m_north;
+}
+//------------------------------------------------------------------------------
+
+double Station::elevation(const double *ecef) const
+{
+    double d[3] = {ecef[0] - m_position[0], ecef[1] - m_position[1],
+                   ecef[2] - m_position[2]};
+    double range = sqrt(d[0] * d[0] + d[1] * d[1] + d[2] * d[2]);
+    return asin((d[0] * m_up[0] + d[1] * m_up[1] + d[2] * m_up[2]) / range);
+}
+//------------------------------------------------------------------------------
+
+void Station::lookAngles(const double *ecef, double &azimuth,
+                         double &elevation, double &range) const
+{
+    double d[3] = {ecef[0] - m_position[0], ecef[1] - m_position[1],
+                   ecef[2] - m_position[2]};
+    range = sqrt(d[0] * d[0] + d[1] * d[1] + d[2] * d[2]);
+
+    double e = d[0] * m_east[0] + d[1] * m_east[1];
+    double n = d[0] * m_north[0] + d[1] * m_north[1] + d[2] * m_north[2];
+    double u = d[0] * m_up[0] + d[1] * m_up[1] + d[2] * m_up[2];
+
+    elevation = asin(u / range);
+    azimuth = atan2(e, n);
+    if (azimuth < 0)
+        azimuth += MAX_ANGLE;
+}
+//------------------------------------------------------------------------------
+
+}  // namespace quicktle
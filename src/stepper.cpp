@@ -0,0 +1,316 @@
+/*-----------------------------------------------------------------------------+
+ | QuickTle                                                                    |
+ | Copyright 2011-2015 Sergei Fundaev                                          |
+ +-----------------------------------------------------------------------------+
+ | This file is part of QuickTle library.                                      |
+ |                                                                             |
+ | QuickTle is free software: you can redistribute it and/or modify            |
+ | it under the terms of the GNU Lesser General Public License as published by |
+ | the Free Software Foundation, either version 3 of the License, or           |
+ | (at your option) any later version.                                         |
+ |                                                                             |
+ | QuickTle is distributed in the hope that it will be useful,                 |
+ | but WITHOUT ANY WARRANTY; without even the implied warranty of              |
+ | MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               |
+ | GNU Lesser General Public License for more details.                         |
+ |                                                                             |
+ | You should have received a copy of the GNU Lesser General Public License    |
+ | along with QuickTle. If not, see <http://www.gnu.org/licenses/>.            |
+ +----------------------------------------------------------------------------*/
+/*!
+    \file stepper.cpp
+    \brief File contains the realization of methods of
+           quicktle::CatalogStepper class.
+*/
+
+#define MAX_ANGLE (2 * M_PI)
+#define CHUNK_SATELLITES 1024  //!< Satellites in one task of the pool
+
+#include <cmath>
+#include <quicktle/stepper.h>
+#include <quicktle/threadpool.h>
+#include <quicktle/func.h>
+#include "kepler.h"
+
+namespace quicktle
+{
+
+CatalogStepper::Buffer::Buffer()
+    : tick(0), t(0), readers(0)
+{
+}
+//------------------------------------------------------------------------------
+
+CatalogStepper::CatalogStepper()
+    : m_start(0), m_step(1), m_startTick(0), m_mathMode(AccurateMath),
+      m_threads(0)
+{
+    m_buffers.emplace_back();
+    m_published.store(&m_buffers.back());
+}
+//------------------------------------------------------------------------------
+
+CatalogStepper::CatalogStepper(const std::vector<Node> &catalog, double start,
+                               double step)
+    : m_start(0), m_step(step), m_startTick(0), m_mathMode(AccurateMath),
+      m_threads(0)
+{
+    setCatalog(catalog, start);
+}
+//------------------------------------------------------------------------------
+
+void CatalogStepper::setCatalog(const std::vector<Node> &catalog, double start)
+{
+    std::size_t count = catalog.size();
+    m_M.resize(count);
+    m_E.resize(count);
+    m_dE.resize(count);
+    m_n.resize(count);
+    m_e.resize(count);
+    m_a.resize(count);
+    m_b.resize(count);
+    for (int j = 0; j < 3; ++j)
+    {
+        m_P[j].resize(count);
+        m_Q[j].resize(count);
+    }
+
+    for (std::size_t k = 0; k < count; ++k)
+    {
+        const Node &node = catalog[k];
+        double e = node.e();
+        double a = node.a();
+        m_n[k] = node.n();
+        m_e[k] = e;
+        m_a[k] = a;
+        m_b[k] = a * sqrt(1 - e * e);
+        m_M[k] = normalizeAngle(node.M()
+                                + node.n() * (start - node.preciseEpoch()));
+
+        const double *R = node.orientation();
+        for (int j = 0; j < 3; ++j)
+        {
+            m_P[j][k] = R[3 * j];
+            m_Q[j][k] = R[3 * j + 1];
+        }
+    }
+
+    m_start = start;
+    m_startTick = 0;
+    m_buffers.clear();
+    m_buffers.emplace_back();
+    Buffer &buffer = m_buffers.back();
+    buffer.x.resize(count);
+    buffer.y.resize(count);
+    buffer.z.resize(count);
+    compute(true, buffer);
+    buffer.t = start;
+    m_published.store(&buffer);
+}
+//------------------------------------------------------------------------------
+
+std::size_t CatalogStepper::size() const
+{
+    return m_M.size();
+}
+//------------------------------------------------------------------------------
+
+double CatalogStepper::step() const
+{
+    return m_step;
+}
+//------------------------------------------------------------------------------
+
+void CatalogStepper::setStep(double step)
+{
+    m_start = time();
+    m_startTick = tick();
+    m_step = step;
+}
+//------------------------------------------------------------------------------
+
+MathMode CatalogStepper::mathMode() const
+{
+    return m_mathMode;
+}
+//------------------------------------------------------------------------------
+
+void CatalogStepper::setMathMode(MathMode mode)
+{
+    m_mathMode = mode;
+}
+//------------------------------------------------------------------------------
+
+unsigned CatalogStepper::threads() const
+{
+    return m_threads;
+}
+//------------------------------------------------------------------------------
+
+void CatalogStepper::setThreads(unsigned threads)
+{
+    m_threads = threads;
+}
+//------------------------------------------------------------------------------
+
+void CatalogStepper::advance()
+{
+    const Buffer &last = *m_published.load(std::memory_order_relaxed);
+    Buffer &buffer = freeBuffer();
+    buffer.tick = last.tick + 1;
+    buffer.t = m_start + static_cast<double>(buffer.tick - m_startTick)
+                       * m_step;
+    compute(false, buffer);
+
+    // Sequentially consistent with the counts of acquire(): a reader, which
+    // raised the count after freeBuffer() had read it, sees the new buffer
+    m_published.store(&buffer);
+}
+//------------------------------------------------------------------------------
+
+std::uint64_t CatalogStepper::tick() const
+{
+    Buffer &buffer = acquire();
+    std::uint64_t tick = buffer.tick;
+    buffer.readers.fetch_sub(1);
+    return tick;
+}
+//------------------------------------------------------------------------------
+
+double CatalogStepper::time() const
+{
+    Buffer &buffer = acquire();
+    double t = buffer.t;
+    buffer.readers.fetch_sub(1);
+    return t;
+}
+//------------------------------------------------------------------------------
+
+CatalogStepper::Snapshot CatalogStepper::snapshot() const
+{
+    Buffer &buffer = acquire();
+    Snapshot snapshot;
+    snapshot.tick = buffer.tick;
+    snapshot.t = buffer.t;
+    bool empty = buffer.x.empty();
+    snapshot.x = empty ? 0 : &buffer.x[0];
+    snapshot.y = empty ? 0 : &buffer.y[0];
+    snapshot.z = empty ? 0 : &buffer.z[0];
+    snapshot.buffer = &buffer;
+    return snapshot;
+}
+//------------------------------------------------------------------------------
+
+void CatalogStepper::release(const Snapshot &snapshot) const
+{
+    static_cast<const Buffer*>(snapshot.buffer)->readers.fetch_sub(1);
+}
+//------------------------------------------------------------------------------
+
+CatalogStepper::Buffer& CatalogStepper::acquire() const
+{
+    while (true)
+    {
+        // The buffer is held, if it is still published after the count is
+        // raised; otherwise advance() may be writing it already
+        Buffer *buffer = m_published.load();
+        buffer->readers.fetch_add(1);
+        if (m_published.load() == buffer)
+            return *buffer;
+        buffer->readers.fetch_sub(1);
+    }
+}
+//------------------------------------------------------------------------------
+
+CatalogStepper::Buffer& CatalogStepper::freeBuffer()
+{
+    const Buffer *published = m_published.load(std::memory_order_relaxed);
+    for (std::size_t k = 0; k < m_buffers.size(); ++k)
+    {
+        Buffer &buffer = m_buffers[k];
+        if (&buffer != published && !buffer.readers.load())
+            return buffer;
+    }
+
+    m_buffers.emplace_back();
+    Buffer &buffer = m_buffers.back();
+    buffer.x.resize(size());
+    buffer.y.resize(size());
+    buffer.z.resize(size());
+    return buffer;
+}
+//------------------------------------------------------------------------------
+
+void CatalogStepper::compute(bool initial, Buffer &buffer)
+{
+    std::size_t count = size();
+    if (!count)
+        return;
+
+    ThreadPool &pool = ThreadPool::instance();
+
+    pool.parallelFor(count, CHUNK_SATELLITES,
+                     [&](std::size_t first, std::size_t last)
+    {
+        if (m_mathMode == FastMath)
+            advanceChunk<FastSinCos>(first, last, initial, buffer);
+        else
+            advanceChunk<AccurateSinCos>(first, last, initial, buffer);
+    }, m_threads);
+}
+//------------------------------------------------------------------------------
+
+template <typename SinCos>
+void CatalogStepper::advanceChunk(std::size_t first, std::size_t last,
+                                  bool initial, Buffer &buffer)
+{
+    double *x = &buffer.x[0];
+    double *y = &buffer.y[0];
+    double *z = &buffer.z[0];
+    const double step = m_step;
+
+    for (std::size_t k = first; k < last; ++k)
+    {
+        double e = m_e[k];
+        double M = m_M[k];
+        double guess;
+        if (initial)
+        {
+            guess = keplerGuess(M, e);
+        }
+        else
+        {
+            // The previous increment of E is the second-order prediction
+            guess = m_E[k] + m_dE[k];
+            M += m_n[k] * step;
+            while (M >= MAX_ANGLE)
+            {
+                M -= MAX_ANGLE;
+                guess -= MAX_ANGLE;
+            }
+            while (M < 0)
+            {
+                M += MAX_ANGLE;
+                guess += MAX_ANGLE;
+            }
+        }
+
+        double sinE, cosE;
+        double E = solveKepler<SinCos>(M, e, guess, sinE, cosE);
+        if (initial)
+            m_dE[k] = m_n[k] * step / (1 - e * cosE);
+        else
+            m_dE[k] += E - guess;
+        m_M[k] = M;
+        m_E[k] = E;
+
+        double xp = m_a[k] * (cosE - e);
+        double yp = m_b[k] * sinE;
+        x[k] = xp * m_P[0][k] + yp * m_Q[0][k];
+        y[k] = xp * m_P[1][k] + yp * m_Q[1][k];
+        z[k] = xp * m_P[2][k] + yp * m_Q[2][k];
+    }
+}
+//------------------------------------------------------------------------------
+
+}  // namespace quicktle
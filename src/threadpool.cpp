@@ -0,0 +1,291 @@
+/*-----------------------------------------------------------------------------+
+ | QuickTle                                                                    |
+ | Copyright 2011-2015 Sergei Fundaev                                          |
+ +-----------------------------------------------------------------------------+
+ | This file is part of QuickTle library.                                      |
+ |                                                                             |
+ | QuickTle is free software: you can redistribute it and/or modify            |
+ | it under the terms of the GNU Lesser General Public License as published by |
+ | the Free Software Foundation, either version 3 of the License, or           |
+ | (at your option) any later version.                                         |
+ |                                                                             |
+ | QuickTle is distributed in the hope that it will be useful,                 |
+ | but WITHOUT ANY WARRANTY; without even the implied warranty of              |
+ | MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               |
+ | GNU Lesser General Public License for more details.                         |
+ |                                                                             |
+ | You should have received a copy of the GNU Lesser General Public License    |
+ | along with QuickTle. If not, see <http://www.gnu.org/licenses/>.            |
+ +----------------------------------------------------------------------------*/
+/*!
+    \file threadpool.cpp
+    \brief File contains the realization of methods of quicktle::ThreadPool
+           class and the functions for parallel processing of catalogs.
+*/
+
+#define CHUNK_BYTES (256 * 1024)  //!< Output size of one chunk of satellites
+#define SATELLITES_GRAIN 4
+
+#include <algorithm>
+#include <atomic>
+#include <quicktle/threadpool.h>
+#include <quicktle/propagator.h>
+
+namespace quicktle
+{
+
+//! The parallelFor() call, waiting for completion of its chunks
+struct ThreadPool::Job
+{
+    const Task *task;
+    std::size_t remaining;   //!< Number of the queued chunks (or workers)
+    std::mutex mutex;
+    std::condition_variable done;
+    std::size_t count;
+    std::size_t grain;
+    std::atomic<std::size_t> next;   //!< Next chunk to take by a worker
+};
+
+namespace
+{
+
+//! The pool, which owns the current thread
+thread_local const ThreadPool *currentPool = 0;
+
+} // namespace
+
+ThreadPool::ThreadPool(unsigned threads)
+    : m_pending(0), m_stop(false)
+{
+    if (!threads)
+        threads = std::thread::hardware_concurrency();
+    if (!threads)
+        threads = 1;
+
+    for (unsigned k = 0; k < threads; ++k)
+        m_queues.push_back(std::unique_ptr<Queue>(new Queue));
+    for (unsigned k = 0; k < threads; ++k)
+        m_threads.push_back(std::thread(&ThreadPool::run, this, k));
+}
+//------------------------------------------------------------------------------
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_wakeup.notify_all();
+    for (std::size_t k = 0; k < m_threads.size(); ++k)
+        m_threads[k].join();
+}
+//------------------------------------------------------------------------------
+
+unsigned ThreadPool::size() const
+{
+    return static_cast<unsigned>(m_threads.size());
+}
+//------------------------------------------------------------------------------
+
+ThreadPool& ThreadPool::instance()
+{
+    static ThreadPool pool;
+    return pool;
+}
+//------------------------------------------------------------------------------
+
+void ThreadPool::parallelFor(std::size_t count, std::size_t grain,
+                             const Task &task, unsigned workers)
+{
+    if (!count)
+        return;
+
+    // Waiting for the own threads would dead-lock
+    if (currentPool == this || workers == 1)
+    {
+        task(0, count);
+        return;
+    }
+
+    if (!grain)
+        grain = 1;
+    const std::size_t chunks = (count + grain - 1) / grain;
+    const std::size_t queues = m_queues.size();
+
+    Job job;
+    job.task = &task;
+    job.count = count;
+    job.grain = grain;
+    job.next = 0;
+
+    // The limited job is queued as its workers, one per queue
+    const bool limited = workers && workers < queues && workers < chunks;
+    job.remaining = limited ? workers : chunks;
+
+    // The chunks are counted before a thread can take them
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_pending += job.remaining;
+        for (std::size_t q = 0; q < queues; ++q)
+        {
+            std::lock_guard<std::mutex> queueLock(m_queues[q]->mutex);
+            if (limited)
+            {
+                if (q < workers)
+                {
+                    Chunk worker;
+                    worker.job = &job;
+                    worker.first = worker.last = 0;
+                    m_queues[q]->chunks.push_back(worker);
+                }
+                continue;
+            }
+
+            // Contiguous block of chunks for each thread
+            std::size_t first = chunks * q / queues;
+            std::size_t last = chunks * (q + 1) / queues;
+            for (std::size_t c = first; c < last; ++c)
+            {
+                Chunk chunk;
+                chunk.job = &job;
+                chunk.first = c * grain;
+                chunk.last = std::min((c + 1) * grain, count);
+                m_queues[q]->chunks.push_back(chunk);
+            }
+        }
+    }
+    m_wakeup.notify_all();
+
+    std::unique_lock<std::mutex> lock(job.mutex);
+    while (job.remaining)
+        job.done.wait(lock);
+}
+//------------------------------------------------------------------------------
+
+bool ThreadPool::take(unsigned index, Chunk &chunk)
+{
+    {
+        Queue &own = *m_queues[index];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.chunks.empty())
+        {
+            chunk = own.chunks.front();
+            own.chunks.pop_front();
+            return true;
+        }
+    }
+
+    // Steal from the far end of the other queues
+    const std::size_t queues = m_queues.size();
+    for (std::size_t offset = 1; offset < queues; ++offset)
+    {
+        Queue &other = *m_queues[(index + offset) % queues];
+        std::lock_guard<std::mutex> lock(other.mutex);
+        if (!other.chunks.empty())
+        {
+            chunk = other.chunks.back();
+            other.chunks.pop_back();
+            return true;
+        }
+    }
+
+    return false;
+}
+//------------------------------------------------------------------------------
+
+void ThreadPool::execute(const Chunk &chunk)
+{
+    Job &job = *chunk.job;
+    if (chunk.first < chunk.last)
+        (*job.task)(chunk.first, chunk.last);
+    else
+    {
+        // The worker of a limited job takes its chunks in turn
+        for (std::size_t c = job.next++; c * job.grain < job.count;
+             c = job.next++)
+        {
+            (*job.task)(c * job.grain,
+                        std::min((c + 1) * job.grain, job.count));
+        }
+    }
+
+    // The job object may be destroyed right after the mutex is released
+    std::lock_guard<std::mutex> lock(job.mutex);
+    if (!--job.remaining)
+        job.done.notify_all();
+}
+//------------------------------------------------------------------------------
+
+void ThreadPool::run(unsigned index)
+{
+    currentPool = this;
+    while (true)
+    {
+        Chunk chunk;
+        if (take(index, chunk))
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                --m_pending;
+            }
+            execute(chunk);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(m_mutex);
+        while (!m_stop && !m_pending)
+            m_wakeup.wait(lock);
+        if (m_stop && !m_pending)
+            return;
+    }
+}
+//------------------------------------------------------------------------------
+
+void forEachSatellite(const std::vector<Node> &catalog,
+                      const std::function<void (std::size_t,
+                                                const Node&)> &function,
+                      unsigned threads)
+{
+    ThreadPool &pool = ThreadPool::instance();
+    pool.parallelFor(catalog.size(), SATELLITES_GRAIN,
+                     [&](std::size_t first, std::size_t last)
+                     {
+                         for (std::size_t k = first; k < last; ++k)
+                             function(k, catalog[k]);
+                     }, threads);
+}
+//------------------------------------------------------------------------------
+
+void propagateAll(const std::vector<Node> &catalog,
+                  const std::vector<double> &times,
+                  std::vector<double> &positions,
+                  std::vector<double> *velocities, unsigned threads)
+{
+    const std::size_t count = times.size();
+    positions.resize(3 * catalog.size() * count);
+    if (velocities)
+        velocities->resize(3 * catalog.size() * count);
+    if (!count)
+        return;
+
+    const std::size_t bytes = 3 * count * sizeof(double) * (velocities ? 2 : 1);
+    const std::size_t grain = std::max<std::size_t>(1, CHUNK_BYTES / bytes);
+    ThreadPool &pool = ThreadPool::instance();
+    pool.parallelFor(catalog.size(), grain,
+                     [&](std::size_t first, std::size_t last)
+    {
+        for (std::size_t k = first; k < last; ++k)
+        {
+            Propagator propagator(catalog[k]);
+            for (std::size_t j = 0; j < count; ++j)
+            {
+                std::size_t offset = 3 * (k * count + j);
+                propagator.state(times[j], &positions[offset],
+                                 velocities ? &(*velocities)[offset] : 0);
+            }
+        }
+    }, threads);
+}
+//------------------------------------------------------------------------------
+
+}  // namespace quicktle
@@ -19,10 +19,32 @@
  +----------------------------------------------------------------------------*/
 
 #include <gtest/gtest.h>
+#include "test_catalogs.h"
 #include "test_func.h"
 #include "test_node.h"
 #include "test_stream.h"
 #include "test_dataset.h"
+#include "test_propagator.h"
+#include "test_coordinates.h"
+#include "test_station.h"
+#include "test_passes.h"
+#include "test_conjunction.h"
+#include "test_threadpool.h"
+#include "test_ephemeriscache.h"
+#include "test_fastmath.h"
+#include "test_elements.h"
+#include "test_lookangles.h"
+#include "test_relativemotion.h"
+#include "test_groundtrack.h"
+#include "test_snapshotindex.h"
+#include "test_coverage.h"
+#include "test_eclipse.h"
+#include "test_doppler.h"
+#include "test_frames.h"
+#include "test_stepper.h"
+#include "test_lineofsight.h"
+#include "test_events.h"
+#include "test_regimeindex.h"
 
 /**
   function: main
@@ -0,0 +1,116 @@
+/*-----------------------------------------------------------------------------+
+ | QuickTle                                                                    |
+ | Copyright 2011-2015 Sergei Fundaev                                          |
+ +-----------------------------------------------------------------------------+
+ | This file is part of QuickTle library.                                      |
+ |                                                                             |
+ | QuickTle is free software: you can redistribute it and/or modify            |
+ | it under the terms of the GNU Lesser General Public License as published by |
+ | the Free Software Foundation, either version 3 of the License, or           |
+ | (at your option) any later version.                                         |
+ |                                                                             |
+ | QuickTle is distributed in the hope that it will be useful,                 |
+ | but WITHOUT ANY WARRANTY; without even the implied warranty of              |
+ | MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               |
+ | GNU Lesser General Public License for more details.                         |
+ |                                                                             |
+ | You should have received a copy of the GNU Lesser General Public License    |
+ | along with QuickTle. If not, see <http://www.gnu.org/licenses/>.            |
+ +----------------------------------------------------------------------------*/
+
+#ifndef TEST_CATALOGS_H
+#define TEST_CATALOGS_H
+
+#include <cmath>
+#include <cstddef>
+#include <vector>
+#include <quicktle/node.h>
+
+using namespace quicktle;
+
+//
+//---- CATALOGS ----------------------------------------------------------------
+
+//! Node of Mir station: the low orbit, which the test catalogs start from
+static Node mirNode()
+{
+    std::string line2 = "1 16609U 86017A   86053.30522506  .00057349"
+            "  00000-0  31166-3 0   112";
+    std::string line3 = "2 16609  51.6129 108.0599 0012107 160.8295"
+            " 196.0076 15.79438158   394";
+    return Node(line2, line3);
+}
+//------------------------------------------------------------------------------
+
+//! Make the orbit of the node highly elliptical (Molniya-like)
+static void setMolniya(Node &node)
+{
+    node.set_e(0.7);
+    node.set_n(2 * M_PI / 43082.);
+}
+//------------------------------------------------------------------------------
+
+//! Make the orbit of the node nearly geostationary
+static void setGeostationary(Node &node)
+{
+    node.set_e(0.0002);
+    node.set_n(2 * M_PI / 86164.);
+}
+//------------------------------------------------------------------------------
+
+//! Low, highly elliptical and geostationary orbits with the spread anomalies
+static std::vector<Node> mixedCatalog(std::size_t count)
+{
+    std::vector<Node> catalog(count, mirNode());
+    for (std::size_t k = 0; k < count; ++k)
+    {
+        if (k % 3 == 1)
+            setMolniya(catalog[k]);
+        else if (k % 3 == 2)
+            setGeostationary(catalog[k]);
+        catalog[k].set_M(360. * k / count);
+        catalog[k].set_Omega(7. * k);
+    }
+    return catalog;
+}
+//------------------------------------------------------------------------------
+
+//! Low orbits of different heights and planes and some high ones
+static std::vector<Node> lowOrbitCatalog(std::size_t count)
+{
+    std::vector<Node> catalog(count, mirNode());
+    for (std::size_t k = 0; k < count; ++k)
+    {
+        catalog[k].set_M(137.5 * k);
+        catalog[k].set_Omega(29. * k);
+        catalog[k].set_i(10. + (k * 17) % 90);
+        catalog[k].set_n(2 * M_PI / (5400. + 40. * (k % 50)));
+        if (k % 10 == 9)
+            setMolniya(catalog[k]);
+    }
+    return catalog;
+}
+//------------------------------------------------------------------------------
+
+//! Orbits of the ISS, which differ in plane, phase and height slightly
+static std::vector<Node> closeOrbitCatalog(std::size_t count)
+{
+    Node base("1 25544U 98067A   98325.70495433 -.00030123  11429-4"
+              " -58797-4 0   131",
+              "2 25544  51.5959 160.7754 0074891  99.0987 261.5489"
+              " 15.92210234   236");
+    std::vector<Node> catalog(count, base);
+    for (std::size_t k = 0; k < count; ++k)
+    {
+        catalog[k].set_i(51 + 7.3 * k);
+        catalog[k].set_Omega(160 + 37.1 * k);
+        catalog[k].set_omega(99 + 13.7 * k);
+        catalog[k].set_M(261 + 61.3 * k);
+        catalog[k].set_e(0.001 * (k % 5));
+        catalog[k].set_n(base.n() * (1 + 0.0003 * (k % 7)));
+    }
+    return catalog;
+}
+//------------------------------------------------------------------------------
+
+#endif // TEST_CATALOGS_H
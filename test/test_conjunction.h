@@ -0,0 +1,149 @@
+/*-----------------------------------------------------------------------------+
+ | QuickTle                                                                    |
+ | Copyright 2011-2015 Sergei Fundaev                                          |
+ +-----------------------------------------------------------------------------+
+ | This file is part of QuickTle library.                                      |
+ |                                                                             |
+ | QuickTle is free software: you can redistribute it and/or modify            |
+ | it under the terms of the GNU Lesser General Public License as published by |
+ | the Free Software Foundation, either version 3 of the License, or           |
+ | (at your option) any later version.                                         |
+ |                                                                             |
+ | QuickTle is distributed in the hope that it will be useful,                 |
+ | but WITHOUT ANY WARRANTY; without even the implied warranty of              |
+ | MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               |
+ | GNU Lesser General Public License for more details.                         |
+ |                                                                             |
+ | You should have received a copy of the GNU Lesser General Public License    |
+ | along with QuickTle. If not, see <http://www.gnu.org/licenses/>.            |
+ +----------------------------------------------------------------------------*/
+
+#include <cmath>
+#include <vector>
+#include <gtest/gtest.h>
+#include <quicktle/node.h>
+#include <quicktle/conjunction.h>
+#include <quicktle/propagator.h>
+#include "test_catalogs.h"
+
+using namespace quicktle;
+
+//
+//---- TESTS -------------------------------------------------------------------
+
+TEST(ConjunctionTest, collision)
+{
+    Node node1;
+    node1.set_n(0.0011);
+    node1.set_e(0);
+    node1.setPreciseEpoch(1e9);
+    Node node2(node1);
+    node2.set_i(60);
+    Node node3(node1);
+    node3.set_n(0.0005);  // Far away shell
+
+    std::vector<Node> catalog;
+    catalog.push_back(node1);
+    catalog.push_back(node3);
+    catalog.push_back(node2);
+
+    ConjunctionScreener screener(catalog);
+    screener.setThreshold(1000);
+    std::vector<Conjunction> conjunctions = screener.screen(1e9 - 1000,
+                                                            1e9 + 1000);
+    ASSERT_EQ(1, conjunctions.size());
+    EXPECT_EQ(0, conjunctions[0].primary);
+    EXPECT_EQ(2, conjunctions[0].secondary);
+    EXPECT_NEAR(1e9, conjunctions[0].tca, 1e-2);
+    EXPECT_NEAR(0, conjunctions[0].distance, 1);
+    double v = pow(3.986004418e14 * 0.0011, 1./3.);
+    EXPECT_NEAR(2 * v * sin(M_PI / 6), conjunctions[0].relativeSpeed, 1e-2);
+
+    // The interval, which starts or stops after the collision, is
+    // closest at its bound
+    screener.setThreshold(100e3);
+    conjunctions = screener.screen(1e9 + 10, 1e9 + 1000);
+    ASSERT_EQ(1, conjunctions.size());
+    EXPECT_EQ(1e9 + 10, conjunctions[0].tca);
+    EXPECT_NEAR(10 * v, conjunctions[0].distance, 100);
+    conjunctions = screener.screen(1e9 - 1000, 1e9 - 10);
+    ASSERT_EQ(1, conjunctions.size());
+    EXPECT_EQ(1e9 - 10, conjunctions[0].tca);
+    EXPECT_NEAR(10 * v, conjunctions[0].distance, 100);
+}
+//------------------------------------------------------------------------------
+
+TEST(ConjunctionTest, bruteForce)
+{
+    std::vector<Node> catalog = closeOrbitCatalog(16);
+    const double threshold = 300e3;
+    double start = catalog[0].preciseEpoch();
+    double stop = start + 4 * 3600;
+
+    ConjunctionScreener screener(catalog);
+    screener.setThreshold(threshold);
+    screener.setThreads(3);
+    std::vector<Conjunction> conjunctions = screener.screen(start, stop);
+
+    // Local minima of distance, scanned with 1 second step
+    std::size_t expected = 0;
+    for (std::size_t k1 = 0; k1 < catalog.size(); ++k1)
+    {
+        Propagator propagator1(catalog[k1]);
+        for (std::size_t k2 = k1 + 1; k2 < catalog.size(); ++k2)
+        {
+            Propagator propagator2(catalog[k2]);
+            double d[3] = {0, 0, 0};
+            for (double t = start; t <= stop; t += 1)
+            {
+                double r1[3], r2[3];
+                propagator1.state(t, r1);
+                propagator2.state(t, r2);
+                d[0] = d[1];
+                d[1] = d[2];
+                d[2] = sqrt(pow(r1[0] - r2[0], 2) + pow(r1[1] - r2[1], 2)
+                            + pow(r1[2] - r2[2], 2));
+                if (t < start + 2 || !(d[1] < d[0] && d[1] <= d[2])
+                    || d[1] > threshold - 1e3)
+                {
+                    continue;
+                }
+
+                ++expected;
+                bool found = false;
+                for (std::size_t k = 0; k < conjunctions.size(); ++k)
+                {
+                    const Conjunction &c = conjunctions[k];
+                    if (c.primary == k1 && c.secondary == k2
+                        && fabs(c.tca - (t - 1)) < 1)
+                    {
+                        found = true;
+                        EXPECT_LE(c.distance, d[1] + 1e-3);
+                        EXPECT_NEAR(d[1], c.distance, 500);
+                    }
+                }
+                EXPECT_TRUE(found) << k1 << " " << k2 << " " << t - 1;
+            }
+        }
+    }
+    EXPECT_LT(0, expected);
+    EXPECT_LE(expected, conjunctions.size());
+
+    // Ranked by the miss distance
+    for (std::size_t k = 1; k < conjunctions.size(); ++k)
+        EXPECT_LE(conjunctions[k - 1].distance, conjunctions[k].distance);
+    for (std::size_t k = 0; k < conjunctions.size(); ++k)
+        EXPECT_LE(conjunctions[k].distance, threshold);
+
+    // The result does not depend on the number of threads
+    screener.setThreads(1);
+    std::vector<Conjunction> conjunctions1 = screener.screen(start, stop);
+    ASSERT_EQ(conjunctions.size(), conjunctions1.size());
+    for (std::size_t k = 0; k < conjunctions.size(); ++k)
+    {
+        EXPECT_EQ(conjunctions[k].primary, conjunctions1[k].primary);
+        EXPECT_EQ(conjunctions[k].secondary, conjunctions1[k].secondary);
+        EXPECT_DOUBLE_EQ(conjunctions[k].tca, conjunctions1[k].tca);
+    }
+}
+//------------------------------------------------------------------------------
@@ -0,0 +1,200 @@
+/*-----------------------------------------------------------------------------+
+ | QuickTle                                                                    |
+ | Copyright 2011-2015 Sergei Fundaev                                          |
+ +-----------------------------------------------------------------------------+
+ | This file is part of QuickTle library.                                      |
+ |                                                                             |
+ | QuickTle is free software: you can redistribute it and/or modify            |
+ | it under the terms of the GNU Lesser General Public License as published by |
+ | the Free Software Foundation, either version 3 of the License, or           |
+ | (at your option) any later version.                                         |
+ |                                                                             |
+ | QuickTle is distributed in the hope that it will be useful,                 |
+ | but WITHOUT ANY WARRANTY; without even the implied warranty of              |
+ | MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               |
+ | GNU Lesser General Public License for more details.                         |
+ |                                                                             |
+ | You should have received a copy of the GNU Lesser General Public License    |
+ | along with QuickTle. If not, see <http://www.gnu.org/licenses/>.            |
+ +----------------------------------------------------------------------------*/
+
+#include <cmath>
+#include <vector>
+#include <gtest/gtest.h>
+#include <quicktle/coordinates.h>
+#include <quicktle/func.h>
+
+using namespace quicktle;
+
+//
+//---- TESTS -------------------------------------------------------------------
+
+TEST(CoordinatesTest, julianDate)
+{
+    EXPECT_DOUBLE_EQ(2440587.5, julianDate(0));
+    // Jan 1, 2000 12:00:00
+    EXPECT_DOUBLE_EQ(2451545.0, julianDate(946728000));
+}
+//------------------------------------------------------------------------------
+
+TEST(CoordinatesTest, gmst)
+{
+    // Jan 1, 2000 12:00:00
+    EXPECT_NEAR(280.46061837, rad2deg(gmst(946728000)), 1e-6);
+    // Vallado, example 3-5: Aug 20, 1992 12:14 UT1
+    double t = (2448855.009722 - 2440587.5) * 86400;
+    EXPECT_NEAR(152.578787810, rad2deg(gmst(t)), 1e-3);
+
+    EarthRotation rotation(t);
+    EXPECT_DOUBLE_EQ(t, rotation.time());
+    EXPECT_DOUBLE_EQ(gmst(t), rotation.gmst());
+}
+//------------------------------------------------------------------------------
+
+TEST(CoordinatesTest, eci2ecef)
+{
+    EarthRotation rotation(946728000);
+    double theta = rotation.gmst();
+    double eci[3] = {7e6, 0, 1e6};
+    double ecef[3];
+    rotation.eci2ecef(eci, ecef);
+    EXPECT_NEAR(7e6 * cos(theta), ecef[0], 1e-6);
+    EXPECT_NEAR(-7e6 * sin(theta), ecef[1], 1e-6);
+    EXPECT_DOUBLE_EQ(1e6, ecef[2]);
+
+    // Batch conversion in place
+    double x[2] = {7e6, 0};
+    double y[2] = {0, 7e6};
+    double z[2] = {1e6, 2e6};
+    rotation.eci2ecef(2, x, y, z, x, y, z);
+    EXPECT_DOUBLE_EQ(ecef[0], x[0]);
+    EXPECT_DOUBLE_EQ(ecef[1], y[0]);
+    EXPECT_NEAR(7e6 * sin(theta), x[1], 1e-6);
+    EXPECT_NEAR(7e6 * cos(theta), y[1], 1e-6);
+    EXPECT_DOUBLE_EQ(2e6, z[1]);
+}
+//------------------------------------------------------------------------------
+
+TEST(CoordinatesTest, geodetic)
+{
+    const double altitudes[] = {-100, 0, 400e3, 2e4, 2e7, 3.6e7};
+    std::vector<double> x, y, z, latitude, longitude, altitude;
+    for (int a = 0; a < 6; ++a)
+    {
+        for (int lat = -90; lat <= 90; lat += 15)
+        {
+            for (int lon = -165; lon <= 180; lon += 45)
+            {
+                double ecef[3];
+                geodetic2ecef(deg2rad(lat), deg2rad(lon), altitudes[a], ecef);
+                x.push_back(ecef[0]);
+                y.push_back(ecef[1]);
+                z.push_back(ecef[2]);
+                latitude.push_back(deg2rad(lat));
+                longitude.push_back(deg2rad(lon));
+                altitude.push_back(altitudes[a]);
+            }
+        }
+    }
+
+    std::size_t count = x.size();
+    std::vector<double> lat(count), lon(count), alt(count);
+    ecef2geodetic(count, &x[0], &y[0], &z[0], &lat[0], &lon[0], &alt[0]);
+    for (std::size_t k = 0; k < count; ++k)
+    {
+        EXPECT_NEAR(latitude[k], lat[k], 1e-10);
+        if (fabs(latitude[k]) < M_PI_2 - 1e-9)
+        {
+            EXPECT_NEAR(longitude[k], lon[k], 1e-10);
+        }
+        EXPECT_NEAR(altitude[k], alt[k], 1e-3);
+    }
+
+    // Equatorial radius and pole
+    double X = 6378137, Y = 0, Z = 0;
+    ecef2geodetic(1, &X, &Y, &Z, &lat[0], &lon[0], &alt[0]);
+    EXPECT_NEAR(0, lat[0], 1e-12);
+    EXPECT_NEAR(0, alt[0], 1e-6);
+    X = 0;
+    Z = 6356752.314245;
+    ecef2geodetic(1, &X, &Y, &Z, &lat[0], &lon[0], &alt[0]);
+    EXPECT_NEAR(M_PI_2, lat[0], 1e-12);
+    EXPECT_NEAR(0, alt[0], 1e-6);
+}
+//------------------------------------------------------------------------------
+
+TEST(CoordinatesTest, eci2geodetic)
+{
+    const std::size_t count = 100;
+    double start = 946728000;
+    double step = 864;
+    std::vector<double> x(count), y(count), z(count);
+    for (std::size_t k = 0; k < count; ++k)
+    {
+        double angle = 0.1 * k;
+        x[k] = 7e6 * cos(angle);
+        y[k] = 7e6 * sin(angle) * cos(0.9);
+        z[k] = 7e6 * sin(angle) * sin(0.9);
+    }
+
+    std::vector<double> lat1(count), lon1(count), alt1(count);
+    std::vector<double> lat2(count), lon2(count), alt2(count);
+    eci2geodetic(start, step, count, &x[0], &y[0], &z[0],
+                 &lat1[0], &lon1[0], &alt1[0]);
+    for (std::size_t k = 0; k < count; ++k)
+    {
+        EarthRotation rotation(start + k * step);
+        rotation.eci2geodetic(1, &x[k], &y[k], &z[k],
+                              &lat2[k], &lon2[k], &alt2[k]);
+        EXPECT_NEAR(lat2[k], lat1[k], 1e-9);
+        EXPECT_NEAR(0, normalizeAngle(lon2[k] - lon1[k] + M_PI) - M_PI, 1e-9);
+        EXPECT_NEAR(alt2[k], alt1[k], 1e-3);
+    }
+}
+//------------------------------------------------------------------------------
+
+TEST(CoordinatesTest, singlePrecision)
+{
+    const std::size_t count = 100;
+    double start = 946728000;
+    double step = 864;
+    std::vector<double> x(count), y(count), z(count);
+    std::vector<float> xf(count), yf(count), zf(count);
+    for (std::size_t k = 0; k < count; ++k)
+    {
+        double angle = 0.1 * k;
+        double radius = k % 2 ? 7e6 : 4.2e7;
+        x[k] = radius * cos(angle);
+        y[k] = radius * sin(angle) * cos(0.9);
+        z[k] = radius * sin(angle) * sin(0.9);
+        xf[k] = static_cast<float>(x[k]);
+        yf[k] = static_cast<float>(y[k]);
+        zf[k] = static_cast<float>(z[k]);
+    }
+
+    std::vector<double> lat(count), lon(count), alt(count);
+    std::vector<float> latf(count), lonf(count), altf(count);
+    eci2geodetic(start, step, count, &x[0], &y[0], &z[0],
+                 &lat[0], &lon[0], &alt[0]);
+    eci2geodetic(start, step, count, &xf[0], &yf[0], &zf[0],
+                 &latf[0], &lonf[0], &altf[0]);
+    for (std::size_t k = 0; k < count; ++k)
+    {
+        EXPECT_NEAR(lat[k], latf[k], 1e-6);
+        EXPECT_NEAR(0, normalizeAngle(lonf[k] - lon[k] + M_PI) - M_PI, 1e-6);
+        EXPECT_NEAR(alt[k], altf[k], 5e-7 * (k % 2 ? 7e6 : 4.2e7));
+    }
+
+    std::vector<float> xe(count), ye(count), ze(count);
+    EarthRotation rotation(start);
+    rotation.eci2ecef(count, &xf[0], &yf[0], &zf[0], &xe[0], &ye[0], &ze[0]);
+    for (std::size_t k = 0; k < count; ++k)
+    {
+        double ecef[3], eci[3] = {x[k], y[k], z[k]};
+        rotation.eci2ecef(eci, ecef);
+        EXPECT_NEAR(ecef[0], xe[k], 10.);
+        EXPECT_NEAR(ecef[1], ye[k], 10.);
+        EXPECT_EQ(zf[k], ze[k]);
+    }
+}
+//------------------------------------------------------------------------------
@@ -0,0 +1,120 @@
+/*-----------------------------------------------------------------------------+
+ | QuickTle                                                                    |
+ | Copyright 2011-2015 Sergei Fundaev                                          |
+ +-----------------------------------------------------------------------------+
+ | This file is part of QuickTle library.                                      |
+ |                                                                             |
+ | QuickTle is free software: you can redistribute it and/or modify            |
+ | it under the terms of the GNU Lesser General Public License as published by |
+ | the Free Software Foundation, either version 3 of the License, or           |
+ | (at your option) any later version.                                         |
+ |                                                                             |
+ | QuickTle is distributed in the hope that it will be useful,                 |
+ | but WITHOUT ANY WARRANTY; without even the implied warranty of              |
+ | MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               |
+ | GNU Lesser General Public License for more details.                         |
+ |                                                                             |
+ | You should have received a copy of the GNU Lesser General Public License    |
+ | along with QuickTle. If not, see <http://www.gnu.org/licenses/>.            |
+ +----------------------------------------------------------------------------*/
+
+#include <cmath>
+#include <vector>
+#include <gtest/gtest.h>
+#include <quicktle/node.h>
+#include <quicktle/propagator.h>
+#include <quicktle/coordinates.h>
+#include <quicktle/coverage.h>
+#include "test_catalogs.h"
+
+using namespace quicktle;
+
+//
+//---- TESTS -------------------------------------------------------------------
+
+TEST(CoverageTest, compute)
+{
+    Node node = mirNode();
+
+    std::vector<Node> satellites(12, node);
+    for (std::size_t k = 0; k < satellites.size(); ++k)
+    {
+        satellites[k].set_M(k * 97.);
+        satellites[k].set_Omega(k * 30.);
+    }
+    satellites[1].set_i(90);
+    setMolniya(satellites[2]);
+
+    CoverageGrid grid(5 * M_PI / 180);
+    ASSERT_EQ(36u, grid.rows());
+    ASSERT_EQ(72u, grid.columns());
+    EXPECT_NEAR(-87.5 * M_PI / 180, grid.latitude(0), 1e-12);
+    EXPECT_NEAR(177.5 * M_PI / 180, grid.longitude(71), 1e-12);
+    grid.setSatellites(satellites);
+    grid.setMinElevation(10 * M_PI / 180);
+    grid.setStep(120);
+    grid.setThreads(3);
+
+    const double start = node.preciseEpoch();
+    const double stop = start + 6 * 3600 + 50;
+    grid.compute(start, stop);
+
+    // Brute force: elevation from the center of each cell
+    const std::size_t cells = grid.rows() * grid.columns();
+    std::vector<double> coverageTime(cells, 0), meanVisible(cells, 0);
+    std::vector<unsigned> maxVisible(cells, 0);
+    const double R = 6371e3;
+    for (double t = start; t < stop; t += grid.step())
+    {
+        double weight = std::min(grid.step(), stop - t);
+        std::vector<unsigned> visible(cells, 0);
+        for (std::size_t k = 0; k < satellites.size(); ++k)
+        {
+            double r[3], p[3];
+            Propagator(satellites[k]).state(t, r);
+            EarthRotation(t).eci2ecef(r, p);
+            double distance = sqrt(p[0] * p[0] + p[1] * p[1] + p[2] * p[2]);
+            for (std::size_t row = 0; row < grid.rows(); ++row)
+            {
+                double phi = grid.latitude(row);
+                for (std::size_t column = 0; column < grid.columns(); ++column)
+                {
+                    double lambda = grid.longitude(column);
+                    double u[3] = {cos(phi) * cos(lambda),
+                                   cos(phi) * sin(lambda), sin(phi)};
+                    double cosAngle = (u[0] * p[0] + u[1] * p[1] +
+                                       u[2] * p[2]) / distance;
+                    double elevation = atan2(cosAngle - R / distance,
+                                             sqrt(1 - cosAngle * cosAngle));
+                    if (elevation >= grid.minElevation())
+                        ++visible[row * grid.columns() + column];
+                }
+            }
+        }
+        for (std::size_t cell = 0; cell < cells; ++cell)
+        {
+            if (visible[cell])
+                coverageTime[cell] += weight;
+            meanVisible[cell] += visible[cell] * weight;
+            maxVisible[cell] = std::max(maxVisible[cell], visible[cell]);
+        }
+    }
+
+    // Cells on the edge of footprint may differ by the rounding
+    std::size_t mismatches = 0;
+    double covered = 0;
+    for (std::size_t cell = 0; cell < cells; ++cell)
+    {
+        meanVisible[cell] /= stop - start;
+        if (fabs(coverageTime[cell] - grid.coverageTime()[cell]) > 1e-6 ||
+            fabs(meanVisible[cell] - grid.meanVisible()[cell]) > 1e-9 ||
+            maxVisible[cell] != grid.maxVisible()[cell])
+        {
+            ++mismatches;
+        }
+        covered += grid.coverageTime()[cell];
+    }
+    EXPECT_LE(mismatches, cells / 1000);
+    EXPECT_GT(covered, 0);
+}
+//------------------------------------------------------------------------------
@@ -18,8 +18,11 @@
  | along with QuickTle. If not, see <http://www.gnu.org/licenses/>.            |
  +----------------------------------------------------------------------------*/
 
+#include <cmath>
+#include <vector>
 #include <gtest/gtest.h>
 #include <quicktle/dataset.h>
+#include <quicktle/propagator.h>
 
 using namespace quicktle;
 
@@ -225,3 +228,136 @@ TEST(DataSetTest, nearestNode)
     EXPECT_EQ(0, dataSet.size());
 }
 //------------------------------------------------------------------------------
+
+TEST(DataSetTest, stateAt)
+{
+    std::string line2 = "1 16609U 86017A   86053.30522506  .00057349"
+            "  00000-0  31166-3 0   112";
+    std::string line3 = "2 16609  51.6129 108.0599 0012107 160.8295"
+            " 196.0076 15.79438158   394";
+    Node node(line2, line3);
+
+    DataSet dataSet;
+    double position[3], velocity[3];
+    EXPECT_FALSE(dataSet.stateAt(node.preciseEpoch(), position));
+
+    for (int k = 0; k < 4; ++k)
+    {
+        Node next(node);
+        next.setPreciseEpoch(node.preciseEpoch() + k * 43200.5);
+        next.set_M(node.M() + 0.3 * k);
+        dataSet.append(next);
+    }
+
+    // Unsorted times, including the ones outside of the data set
+    std::vector<double> times;
+    for (int k = -20; k < 150; ++k)
+        times.push_back(node.preciseEpoch() + ((k * 7919) % 170) * 1000.);
+
+    std::vector<double> positions(3 * times.size());
+    std::vector<double> velocities(3 * times.size());
+    ASSERT_TRUE(dataSet.statesAt(times.size(), &times[0],
+                                 &positions[0], &velocities[0]));
+    for (std::size_t k = 0; k < times.size(); ++k)
+    {
+        double t = times[k];
+        std::size_t nearest = 0;
+        for (std::size_t j = 1; j < dataSet.size(); ++j)
+        {
+            if (fabs(dataSet.node(j).preciseEpoch() - t)
+                < fabs(dataSet.node(nearest).preciseEpoch() - t))
+            {
+                nearest = j;
+            }
+        }
+
+        double r[3], v[3];
+        Propagator(dataSet.node(nearest)).state(t, r, v);
+        ASSERT_TRUE(dataSet.stateAt(t, position, velocity));
+        for (int c = 0; c < 3; ++c)
+        {
+            EXPECT_EQ(r[c], position[c]);
+            EXPECT_EQ(v[c], velocity[c]);
+            EXPECT_EQ(r[c], positions[3 * k + c]);
+            EXPECT_EQ(v[c], velocities[3 * k + c]);
+        }
+    }
+
+    // The same states through a cursor
+    DataSet::Cursor cursor;
+    for (std::size_t k = 0; k < times.size(); ++k)
+    {
+        ASSERT_TRUE(dataSet.stateAt(cursor, times[k], position, velocity));
+        for (int c = 0; c < 3; ++c)
+        {
+            EXPECT_EQ(positions[3 * k + c], position[c]);
+            EXPECT_EQ(velocities[3 * k + c], velocity[c]);
+        }
+    }
+
+    // The orbit of the cursor is dropped, when the data set is changed
+    dataSet.stateAt(cursor, node.preciseEpoch() + 1e3, position);
+    Node replaced(dataSet.node(0));
+    replaced.set_M(2.);
+    dataSet.append(replaced);
+    double r[3];
+    Propagator(replaced).state(node.preciseEpoch() + 1e3, r);
+    dataSet.stateAt(cursor, node.preciseEpoch() + 1e3, position);
+    EXPECT_EQ(r[0], position[0]);
+}
+//------------------------------------------------------------------------------
+
+TEST(DataSetTest, hermiteBlend)
+{
+    std::string line2 = "1 16609U 86017A   86053.30522506  .00057349"
+            "  00000-0  31166-3 0   112";
+    std::string line3 = "2 16609  51.6129 108.0599 0012107 160.8295"
+            " 196.0076 15.79438158   394";
+    Node node(line2, line3);
+
+    // Element sets, which disagree by several kilometers
+    DataSet dataSet;
+    for (int k = 0; k < 4; ++k)
+    {
+        Node next(node);
+        next.setPreciseEpoch(node.preciseEpoch() + k * 43200.);
+        next.set_M(node.M() + 1e-3 * k);
+        dataSet.append(next);
+    }
+    dataSet.setInterpolation(DataSet::HermiteBlend);
+    EXPECT_EQ(DataSet::HermiteBlend, dataSet.interpolation());
+
+    // The node orbit is used at its epoch
+    for (std::size_t k = 0; k < dataSet.size(); ++k)
+    {
+        double t = dataSet.node(k).preciseEpoch();
+        double r[3], position[3];
+        Propagator(dataSet.node(k)).state(t, r);
+        dataSet.stateAt(t, position);
+        for (int c = 0; c < 3; ++c)
+            EXPECT_NEAR(r[c], position[c], 1e-6);
+    }
+
+    // No jumps at the midpoints; the velocity is the derivative
+    // of the position (the step is limited by the rounding of time)
+    const double h = 0.5;
+    for (double t = node.preciseEpoch() - 1000;
+         t < node.preciseEpoch() + 3 * 43200. + 1000; t += 997)
+    {
+        double r0[3], r1[3], v[3];
+        dataSet.stateAt(t - h, r0);
+        dataSet.stateAt(t + h, r1, v);
+        double r[3];
+        dataSet.stateAt(t, r, v);
+        for (int c = 0; c < 3; ++c)
+            EXPECT_NEAR(v[c], (r1[c] - r0[c]) / (2 * h), 2e-3);
+    }
+
+    double before[3], after[3];
+    double middle = node.preciseEpoch() + 21600.;
+    dataSet.stateAt(middle - h, before);
+    dataSet.stateAt(middle + h, after);
+    for (int c = 0; c < 3; ++c)
+        EXPECT_NEAR(before[c], after[c], 8e3 * 2 * h);
+}
+//------------------------------------------------------------------------------
@@ -0,0 +1,111 @@
+/*-----------------------------------------------------------------------------+
+ | QuickTle                                                                    |
+ | Copyright 2011-2015 Sergei Fundaev                                          |
+ +-----------------------------------------------------------------------------+
+ | This file is part of QuickTle library.                                      |
+ |                                                                             |
+ | QuickTle is free software: you can redistribute it and/or modify            |
+ | it under the terms of the GNU Lesser General Public License as published by |
+ | the Free Software Foundation, either version 3 of the License, or           |
+ | (at your option) any later version.                                         |
+ |                                                                             |
+ | QuickTle is distributed in the hope that it will be useful,                 |
+ | but WITHOUT ANY WARRANTY; without even the implied warranty of              |
+ | MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               |
+ | GNU Lesser General Public License for more details.                         |
+ |                                                                             |
+ | You should have received a copy of the GNU Lesser General Public License    |
+ | along with QuickTle. If not, see <http://www.gnu.org/licenses/>.            |
+ +----------------------------------------------------------------------------*/
+
+#include <cmath>
+#include <vector>
+#include <gtest/gtest.h>
+#include <quicktle/node.h>
+#include <quicktle/station.h>
+#include <quicktle/passes.h>
+#include <quicktle/propagator.h>
+#include <quicktle/coordinates.h>
+#include <quicktle/doppler.h>
+#include "test_catalogs.h"
+
+using namespace quicktle;
+
+//
+//---- TESTS -------------------------------------------------------------------
+
+TEST(DopplerTest, passProfiles)
+{
+    std::vector<Node> satellites(4, mirNode());
+    for (std::size_t k = 0; k < satellites.size(); ++k)
+        satellites[k].set_M(k * 90.);
+    std::vector<Station> stations;
+    stations.push_back(Station(0.97, 0.66, 150));
+    stations.push_back(Station(0.5, -1.3, 20));
+
+    const double start = satellites[0].preciseEpoch();
+    std::vector<Pass> passes = PassPredictor(stations, satellites)
+            .predict(start, start + 86400);
+    ASSERT_FALSE(passes.empty());
+
+    const double step = 1;
+    std::vector<std::size_t> offsets;
+    std::size_t total = passProfileOffsets(passes, step, offsets);
+    ASSERT_EQ(passes.size(), offsets.size());
+    std::vector<double> range(total), rangeRate(total), shift(total);
+    passProfiles(stations, satellites, passes, step, &range[0],
+                 &rangeRate[0]);
+    const double frequency = 437e6;
+    dopplerShift(total, &rangeRate[0], frequency, &shift[0]);
+
+    const double h = 0.1;
+    for (std::size_t p = 0; p < passes.size(); ++p)
+    {
+        const Pass &pass = passes[p];
+        std::size_t end = p + 1 < passes.size() ? offsets[p + 1] : total;
+        std::size_t count = end - offsets[p];
+        EXPECT_EQ(std::size_t(floor((pass.set - pass.rise) / step)) + 1, count);
+
+        // Approach, then recession
+        EXPECT_LT(rangeRate[offsets[p]], 0);
+        EXPECT_GT(rangeRate[end - 1], 0);
+        EXPECT_GT(shift[offsets[p]], 0);
+
+        const Station &station = stations[pass.station];
+        const Propagator propagator(satellites[pass.satellite]);
+        auto distance = [&](double t)
+        {
+            double r[3], ecef[3], azimuth, elevation, d;
+            propagator.state(t, r);
+            EarthRotation(t).eci2ecef(r, ecef);
+            station.lookAngles(ecef, azimuth, elevation, d);
+            return d;
+        };
+        for (std::size_t j = 0; j < count; j += 37)
+        {
+            double t = pass.rise + j * step;
+            EXPECT_NEAR(distance(t), range[offsets[p] + j], 1e-3);
+            EXPECT_NEAR((distance(t + h) - distance(t - h)) / (2 * h),
+                        rangeRate[offsets[p] + j], 1e-2);
+            EXPECT_NEAR(-frequency * rangeRate[offsets[p] + j] / 299792458.,
+                        shift[offsets[p] + j], 1e-6);
+        }
+
+        // The single profile gives the same values
+        std::vector<double> single(count);
+        rangeRateProfile(station, satellites[pass.satellite], pass.rise, step,
+                         count, 0, &single[0]);
+        for (std::size_t j = 0; j < count; ++j)
+            EXPECT_EQ(rangeRate[offsets[p] + j], single[j]);
+    }
+
+    // The nodes, shared by many passes, are parsed before the threads run
+    std::vector<Node> unparsed(satellites.size(), mirNode());
+    for (std::size_t k = 0; k < unparsed.size(); ++k)
+        unparsed[k].set_M(k * 90.);
+    std::vector<double> again(total);
+    passProfiles(stations, unparsed, passes, step, 0, &again[0]);
+    for (std::size_t j = 0; j < total; ++j)
+        EXPECT_EQ(rangeRate[j], again[j]);
+}
+//------------------------------------------------------------------------------
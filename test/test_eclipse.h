@@ -0,0 +1,185 @@
+/*-----------------------------------------------------------------------------+
+ | QuickTle                                                                    |
+ | Copyright 2011-2015 Sergei Fundaev                                          |
+ +-----------------------------------------------------------------------------+
+ | This file is part of QuickTle library.                                      |
+ |                                                                             |
+ | QuickTle is free software: you can redistribute it and/or modify            |
+ | it under the terms of the GNU Lesser General Public License as published by |
+ | the Free Software Foundation, either version 3 of the License, or           |
+ | (at your option) any later version.                                         |
+ |                                                                             |
+ | QuickTle is distributed in the hope that it will be useful,                 |
+ | but WITHOUT ANY WARRANTY; without even the implied warranty of              |
+ | MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               |
+ | GNU Lesser General Public License for more details.                         |
+ |                                                                             |
+ | You should have received a copy of the GNU Lesser General Public License    |
+ | along with QuickTle. If not, see <http://www.gnu.org/licenses/>.            |
+ +----------------------------------------------------------------------------*/
+
+#include <cmath>
+#include <vector>
+#include <gtest/gtest.h>
+#include <quicktle/node.h>
+#include <quicktle/propagator.h>
+#include <quicktle/eclipse.h>
+#include "test_catalogs.h"
+
+using namespace quicktle;
+
+//
+//---- TESTS -------------------------------------------------------------------
+
+TEST(EclipseTest, sunPosition)
+{
+    const double AU = 149597870700.;
+
+    // March equinox of 2000: 2000-03-20 07:35 UTC
+    double sun[3];
+    sunPosition(953537700, sun);
+    double distance = sqrt(sun[0] * sun[0] + sun[1] * sun[1] + sun[2] * sun[2]);
+    EXPECT_NEAR(0.996, distance / AU, 1e-3);
+    EXPECT_NEAR(0, atan2(sun[1], sun[0]), 3e-4);
+    EXPECT_NEAR(0, sun[2] / distance, 3e-4);
+
+    // June solstice of 2000: 2000-06-21 01:48 UTC
+    sunPosition(961552080, sun);
+    distance = sqrt(sun[0] * sun[0] + sun[1] * sun[1] + sun[2] * sun[2]);
+    EXPECT_NEAR(1.016, distance / AU, 1e-3);
+    EXPECT_NEAR(23.44 * M_PI / 180, asin(sun[2] / distance), 3e-4);
+}
+//------------------------------------------------------------------------------
+
+TEST(EclipseTest, shadow)
+{
+    const double sun[3] = {149597870700., 0, 0};
+    const double front[3] = {7e6, 0, 0};
+    const double behind[3] = {-7e6, 0, 0};
+    const double inside[3] = {-7e6, 6.3e6, 0};
+    const double outside[3] = {-7e6, 6.4e6, 0};
+    EXPECT_EQ(Sunlight, shadow(front, sun));
+    EXPECT_EQ(Umbra, shadow(behind, sun));
+    EXPECT_EQ(Umbra, shadow(inside, sun, CylindricalShadow));
+    EXPECT_EQ(Sunlight, shadow(outside, sun, CylindricalShadow));
+
+    // The penumbra near the edge of the cylinder
+    const double edge[3] = {-7e6, 6378137., 0};
+    EXPECT_EQ(Penumbra, shadow(edge, sun));
+}
+//------------------------------------------------------------------------------
+
+TEST(EclipseTest, predict)
+{
+    Node node = mirNode();
+    std::vector<Node> satellites(3, node);
+    setMolniya(satellites[1]);
+    setGeostationary(satellites[2]);
+    satellites[2].set_i(0);
+
+    const double start = node.preciseEpoch();
+    const double stop = start + 2 * 86400;
+    EclipsePredictor predictor(satellites);
+    predictor.setThreads(2);
+    std::vector<Eclipse> eclipses;
+
+    for (int model = CylindricalShadow; model <= ConicalShadow; ++model)
+    {
+        predictor.setModel(ShadowModel(model));
+        eclipses = predictor.predict(start, stop);
+
+        // Number of eclipses by the fine scan
+        std::vector<std::size_t> expected(satellites.size(), 0);
+        for (std::size_t k = 0; k < satellites.size(); ++k)
+        {
+            const Propagator propagator(satellites[k]);
+            bool previous = false;
+            for (double t = start; t <= stop; t += 5)
+            {
+                double r[3], sun[3];
+                propagator.state(t, r);
+                sunPosition(t, sun);
+                bool current = shadow(r, sun, ShadowModel(model)) != Sunlight;
+                if (current && !previous)
+                    ++expected[k];
+                previous = current;
+            }
+        }
+
+        std::vector<std::size_t> found(satellites.size(), 0);
+        for (std::size_t e = 0; e < eclipses.size(); ++e)
+        {
+            const Eclipse &eclipse = eclipses[e];
+            ASSERT_LT(eclipse.satellite, satellites.size());
+            ++found[eclipse.satellite];
+            if (e > 0 && eclipses[e - 1].satellite == eclipse.satellite)
+            {
+                EXPECT_LT(eclipses[e - 1].penumbraExit, eclipse.penumbraEntry);
+            }
+            EXPECT_LT(eclipse.penumbraEntry, eclipse.penumbraExit);
+            ASSERT_TRUE(eclipse.umbra);
+            EXPECT_LE(eclipse.penumbraEntry, eclipse.umbraEntry);
+            EXPECT_LT(eclipse.umbraEntry, eclipse.umbraExit);
+            EXPECT_LE(eclipse.umbraExit, eclipse.penumbraExit);
+            if (model == CylindricalShadow)
+            {
+                EXPECT_EQ(eclipse.penumbraEntry, eclipse.umbraEntry);
+                EXPECT_EQ(eclipse.penumbraExit, eclipse.umbraExit);
+            }
+
+            // Illumination around the boundaries
+            const Propagator propagator(satellites[eclipse.satellite]);
+            auto illumination = [&](double t)
+            {
+                double r[3], sun[3];
+                propagator.state(t, r);
+                sunPosition(t, sun);
+                return shadow(r, sun, ShadowModel(model));
+            };
+            const double d = 0.01;
+            if (eclipse.penumbraEntry > start)
+            {
+                EXPECT_EQ(Sunlight, illumination(eclipse.penumbraEntry - d));
+            }
+            if (eclipse.penumbraExit < stop)
+            {
+                EXPECT_EQ(Sunlight, illumination(eclipse.penumbraExit + d));
+            }
+            EXPECT_EQ(Umbra, illumination(eclipse.umbraEntry + d));
+            EXPECT_EQ(Umbra, illumination(eclipse.umbraExit - d));
+        }
+        EXPECT_EQ(expected, found);
+        EXPECT_GT(found[0], 20u);
+    }
+}
+//------------------------------------------------------------------------------
+
+TEST(EclipseTest, betaAngles)
+{
+    std::vector<Node> catalog(20, mirNode());
+    for (std::size_t k = 0; k < catalog.size(); ++k)
+    {
+        catalog[k].set_Omega(k * 18.);
+        catalog[k].set_i(k * 9.);
+    }
+
+    const double t = catalog[0].preciseEpoch();
+    std::vector<double> beta(catalog.size());
+    betaAngles(catalog, t, &beta[0]);
+
+    double sun[3];
+    sunPosition(t, sun);
+    double s = sqrt(sun[0] * sun[0] + sun[1] * sun[1] + sun[2] * sun[2]);
+    for (std::size_t k = 0; k < catalog.size(); ++k)
+    {
+        double r[3], v[3];
+        Propagator(catalog[k]).state(t, r, v);
+        double h[3] = {r[1] * v[2] - r[2] * v[1], r[2] * v[0] - r[0] * v[2],
+                       r[0] * v[1] - r[1] * v[0]};
+        double length = sqrt(h[0] * h[0] + h[1] * h[1] + h[2] * h[2]);
+        double expected = asin((h[0] * sun[0] + h[1] * sun[1] +
+                                h[2] * sun[2]) / (length * s));
+        EXPECT_NEAR(expected, beta[k], 1e-9);
+    }
+}
+//------------------------------------------------------------------------------
@@ -0,0 +1,103 @@
+/*-----------------------------------------------------------------------------+
+ | QuickTle                                                                    |
+ | Copyright 2011-2015 Sergei Fundaev                                          |
+ +-----------------------------------------------------------------------------+
+ | This file is part of QuickTle library.                                      |
+ |                                                                             |
+ | QuickTle is free software: you can redistribute it and/or modify            |
+ | it under the terms of the GNU Lesser General Public License as published by |
+ | the Free Software Foundation, either version 3 of the License, or           |
+ | (at your option) any later version.                                         |
+ |                                                                             |
+ | QuickTle is distributed in the hope that it will be useful,                 |
+ | but WITHOUT ANY WARRANTY; without even the implied warranty of              |
+ | MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               |
+ | GNU Lesser General Public License for more details.                         |
+ |                                                                             |
+ | You should have received a copy of the GNU Lesser General Public License    |
+ | along with QuickTle. If not, see <http://www.gnu.org/licenses/>.            |
+ +----------------------------------------------------------------------------*/
+
+#include <cmath>
+#include <vector>
+#include <gtest/gtest.h>
+#include <quicktle/node.h>
+#include <quicktle/propagator.h>
+#include <quicktle/elements.h>
+#include "test_catalogs.h"
+
+using namespace quicktle;
+
+//
+//---- TESTS -------------------------------------------------------------------
+
+TEST(ElementsTest, roundTrip)
+{
+    Node node = mirNode();
+
+    // Low, highly elliptical, retrograde, equatorial and circular orbits
+    std::vector<Node> nodes(5, node);
+    setMolniya(nodes[1]);
+    nodes[2].set_i(98.7);
+    nodes[3].set_i(0);
+    nodes[4].set_e(0);
+
+    const double t0 = node.preciseEpoch();
+    std::vector<double> times, positions, velocities;
+    for (std::size_t k = 0; k < nodes.size(); ++k)
+    {
+        for (int j = 0; j < 10; ++j)
+        {
+            double t = t0 + 1234.5 * j;
+            double r[3], v[3];
+            Propagator(nodes[k]).state(t, r, v);
+            times.push_back(t);
+            positions.insert(positions.end(), r, r + 3);
+            velocities.insert(velocities.end(), v, v + 3);
+        }
+    }
+
+    const std::size_t count = times.size();
+    std::vector<double> n(count), e(count), i(count), Omega(count),
+                        omega(count), M(count);
+    rv2coe(count, &positions[0], &velocities[0], &n[0], &e[0], &i[0],
+           &Omega[0], &omega[0], &M[0]);
+    std::vector<Node> converted(count);
+    rv2coe(count, &times[0], &positions[0], &velocities[0], &converted[0]);
+
+    for (std::size_t k = 0; k < count; ++k)
+    {
+        const Node &original = nodes[k / 10];
+        EXPECT_NEAR(original.n(), n[k], 1e-12);
+        EXPECT_NEAR(original.e(), e[k], 1e-9);
+        EXPECT_NEAR(original.i(), i[k], 1e-9);
+        EXPECT_DOUBLE_EQ(n[k], converted[k].n());
+        EXPECT_DOUBLE_EQ(M[k], converted[k].M());
+        EXPECT_DOUBLE_EQ(times[k], converted[k].preciseEpoch());
+        if (original.e() > 0.001 && sin(original.i()) > 0.1)
+        {
+            EXPECT_NEAR(original.Omega(), Omega[k], 1e-9);
+            EXPECT_NEAR(original.omega(), omega[k], 1e-6);
+        }
+
+        // The same orbit in any case
+        double r1[3], r2[3];
+        Propagator(original).state(times[k] + 5000, r1);
+        Propagator(converted[k]).state(times[k] + 5000, r2);
+        for (int c = 0; c < 3; ++c)
+            EXPECT_NEAR(r1[c], r2[c], 1e-2);
+    }
+}
+//------------------------------------------------------------------------------
+
+TEST(ElementsTest, hyperbolic)
+{
+    double r[3] = {7e6, 0, 0};
+    double v[3] = {0, 12e3, 1e3};
+    double n = 1, e = 0, M = 1;
+    rv2coe(1, r, v, &n, &e, 0, 0, 0, &M);
+    EXPECT_EQ(0, n);
+    EXPECT_EQ(0, M);
+    EXPECT_LT(1, e);
+}
+//------------------------------------------------------------------------------
@@ -0,0 +1,161 @@
+/*-----------------------------------------------------------------------------+
+ | QuickTle                                                                    |
+ | Copyright 2011-2015 Sergei Fundaev                                          |
+ +-----------------------------------------------------------------------------+
+ | This file is part of QuickTle library.                                      |
+ |                                                                             |
+ | QuickTle is free software: you can redistribute it and/or modify            |
+ | it under the terms of the GNU Lesser General Public License as published by |
+ | the Free Software Foundation, either version 3 of the License, or           |
+ | (at your option) any later version.                                         |
+ |                                                                             |
+ | QuickTle is distributed in the hope that it will be useful,                 |
+ | but WITHOUT ANY WARRANTY; without even the implied warranty of              |
+ | MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               |
+ | GNU Lesser General Public License for more details.                         |
+ |                                                                             |
+ | You should have received a copy of the GNU Lesser General Public License    |
+ | along with QuickTle. If not, see <http://www.gnu.org/licenses/>.            |
+ +----------------------------------------------------------------------------*/
+
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+#include <gtest/gtest.h>
+#include <quicktle/node.h>
+#include <quicktle/propagator.h>
+#include <quicktle/ephemeriscache.h>
+#include "test_catalogs.h"
+
+using namespace quicktle;
+
+//
+//---- TESTS -------------------------------------------------------------------
+
+TEST(EphemerisCacheTest, accuracy)
+{
+    Node node = mirNode();
+
+    // Circular and highly elliptical orbits
+    std::vector<Node> catalog(2, node);
+    setMolniya(catalog[1]);
+
+    EphemerisCache cache(catalog);
+    cache.setTolerance(0.1);
+    EXPECT_LT(cache.segmentLength(1), cache.segmentLength(0));
+
+    std::srand(1);
+    for (std::size_t k = 0; k < catalog.size(); ++k)
+    {
+        Propagator propagator(catalog[k]);
+        for (int j = 0; j < 1000; ++j)
+        {
+            double t = node.preciseEpoch() + 86400. * std::rand() / RAND_MAX;
+            double r[3], v[3], exact[3], exactV[3];
+            double bound = cache.state(k, t, r, v);
+            propagator.state(t, exact, exactV);
+            EXPECT_LE(bound, 0.1);
+
+            double d = 0, dv = 0;
+            for (int c = 0; c < 3; ++c)
+            {
+                d += (r[c] - exact[c]) * (r[c] - exact[c]);
+                dv += (v[c] - exactV[c]) * (v[c] - exactV[c]);
+            }
+            EXPECT_LT(sqrt(d), 0.2);
+            EXPECT_LT(sqrt(dv), 5e-3);
+        }
+    }
+}
+//------------------------------------------------------------------------------
+
+TEST(EphemerisCacheTest, memoryBudget)
+{
+    Node node = mirNode();
+
+    std::vector<Node> catalog(10, node);
+    EphemerisCache cache(catalog);
+    double t0 = node.preciseEpoch();
+    double r[3];
+    cache.state(0, t0, r);
+    std::size_t segmentBytes = cache.memoryUsage();
+    ASSERT_EQ(1u, cache.segments());
+
+    // The repeated query uses the same segment
+    cache.state(0, t0 + 1, r);
+    EXPECT_EQ(1u, cache.segments());
+
+    cache.setMemoryBudget(5 * segmentBytes);
+    for (int j = 0; j < 100; ++j)
+    {
+        cache.state(j % 10, t0 + j * cache.segmentLength(0), r);
+        EXPECT_LE(cache.memoryUsage(), cache.memoryBudget());
+    }
+    EXPECT_EQ(5u, cache.segments());
+
+    cache.setMemoryBudget(2 * segmentBytes);
+    EXPECT_EQ(2u, cache.segments());
+    cache.clear();
+    EXPECT_EQ(0u, cache.segments());
+}
+//------------------------------------------------------------------------------
+
+TEST(EphemerisCacheTest, refit)
+{
+    Node node = mirNode();
+
+    std::vector<Node> catalog;
+    for (int k = 0; k < 10; ++k)
+    {
+        Node satellite(node);
+        satellite.set_e(0.09 * k);
+        satellite.set_M(0.7 * k);
+        catalog.push_back(satellite);
+    }
+
+    // The perigee fits are within the tolerance, but some segments
+    // of these orbits are not
+    const double tolerance = 7e-4;
+    EphemerisCache cache(catalog);
+    cache.setTolerance(tolerance);
+    for (std::size_t k = 0; k < catalog.size(); ++k)
+    {
+        Propagator propagator(catalog[k]);
+        for (int j = 0; j < 3000; ++j)
+        {
+            double t = node.preciseEpoch() + 29. * j;
+            double r[3], exact[3];
+            EXPECT_LE(cache.state(k, t, r), tolerance);
+            propagator.state(t, exact);
+            double d = 0;
+            for (int c = 0; c < 3; ++c)
+                d += (r[c] - exact[c]) * (r[c] - exact[c]);
+            EXPECT_LT(sqrt(d), 2 * tolerance);
+        }
+    }
+}
+//------------------------------------------------------------------------------
+
+TEST(EphemerisCacheTest, distantSegments)
+{
+    std::vector<Node> catalog(1, mirNode());
+    EphemerisCache cache(catalog);
+
+    // The tolerance is unreachable: the segments are halved to the limit
+    cache.setTolerance(1e-12);
+    const double epoch = Propagator(catalog[0]).epoch();
+    double r[3];
+    cache.state(0, epoch + 1000, r);
+    const double span = cache.segmentLength(0);
+    EXPECT_LT(span, 1e-3);
+
+    // The segment 2^32 segments later is another one
+    const double index = floor(1000 / span);
+    const double t = epoch + (index + 4294967296. + 0.5) * span;
+    double exact[3];
+    cache.state(0, t, r);
+    Propagator(catalog[0]).state(t, exact);
+    for (int c = 0; c < 3; ++c)
+        EXPECT_NEAR(exact[c], r[c], 1);
+}
+//------------------------------------------------------------------------------
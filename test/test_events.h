@@ -0,0 +1,165 @@
+/*-----------------------------------------------------------------------------+
+ | QuickTle                                                                    |
+ | Copyright 2011-2015 Sergei Fundaev                                          |
+ +-----------------------------------------------------------------------------+
+ | This file is part of QuickTle library.                                      |
+ |                                                                             |
+ | QuickTle is free software: you can redistribute it and/or modify            |
+ | it under the terms of the GNU Lesser General Public License as published by |
+ | the Free Software Foundation, either version 3 of the License, or           |
+ | (at your option) any later version.                                         |
+ |                                                                             |
+ | QuickTle is distributed in the hope that it will be useful,                 |
+ | but WITHOUT ANY WARRANTY; without even the implied warranty of              |
+ | MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               |
+ | GNU Lesser General Public License for more details.                         |
+ |                                                                             |
+ | You should have received a copy of the GNU Lesser General Public License    |
+ | along with QuickTle. If not, see <http://www.gnu.org/licenses/>.            |
+ +----------------------------------------------------------------------------*/
+
+#include <cmath>
+#include <vector>
+#include <gtest/gtest.h>
+#include <quicktle/node.h>
+#include <quicktle/propagator.h>
+#include <quicktle/events.h>
+#include "test_catalogs.h"
+
+using namespace quicktle;
+
+//
+//---- TESTS -------------------------------------------------------------------
+
+TEST(EventFinderTest, events)
+{
+    Node node = mirNode();
+
+    // Low and highly elliptical orbits
+    std::vector<Node> catalog(2, node);
+    setMolniya(catalog[1]);
+    catalog[1].set_i(63.4);
+
+    const double start = node.preciseEpoch() + 1000;
+    const double stop = start + 2 * 86400;
+    const double latitude = 30 * M_PI / 180;
+
+    EventFinder finder(catalog);
+    EXPECT_TRUE(finder.nodeCrossings());
+    EXPECT_TRUE(finder.apsides());
+    // 60 degrees is above the inclination of the first satellite
+    finder.setLatitudes(std::vector<double>{latitude, M_PI / 3});
+
+    const OrbitModel models[] = {TwoBody, J2Secular};
+    for (OrbitModel model : models)
+    {
+        finder.setOrbitModel(model);
+        std::vector<OrbitEvent> events = finder.find(start, stop);
+
+        std::vector<std::size_t> counts(2 * 6, 0);
+        std::size_t north60First = 0;
+        for (std::size_t k = 0; k < events.size(); ++k)
+        {
+            const OrbitEvent &event = events[k];
+            if (k)
+            {
+                // By satellite, then by time
+                const OrbitEvent &previous = events[k - 1];
+                EXPECT_LE(previous.satellite, event.satellite);
+                if (previous.satellite == event.satellite)
+                {
+                    EXPECT_LE(previous.t, event.t);
+                }
+            }
+            EXPECT_GE(event.t, start);
+            EXPECT_LE(event.t, stop);
+            ++counts[6 * event.satellite + event.type];
+
+            Propagator propagator(catalog[event.satellite], AccurateMath,
+                                  model);
+            double r[3], v[3];
+            propagator.state(event.t, r, v);
+            double radius = sqrt(r[0] * r[0] + r[1] * r[1] + r[2] * r[2]);
+            double radialRate = (r[0] * v[0] + r[1] * v[1] + r[2] * v[2])
+                              / radius;
+            switch (event.type)
+            {
+            case AscendingNode:
+            case DescendingNode:
+                EXPECT_NEAR(0., r[2], 1.);
+                EXPECT_EQ(event.type == AscendingNode, v[2] > 0);
+                break;
+            case NorthwardLatitude:
+            case SouthwardLatitude:
+                EXPECT_NEAR(sin(event.latitude), r[2] / radius, 1e-7);
+                EXPECT_EQ(event.type == NorthwardLatitude,
+                          v[2] * radius - r[2] * radialRate > 0);
+                break;
+            case Perigee:
+            case Apogee:
+                // The radial velocity changes its sign in 1 ms
+                EXPECT_NEAR(0., radialRate, 1e-2);
+                double before[3], after[3];
+                propagator.state(event.t - 60, before);
+                propagator.state(event.t + 60, after);
+                double r1 = sqrt(before[0] * before[0] + before[1] * before[1]
+                                 + before[2] * before[2]);
+                double r2 = sqrt(after[0] * after[0] + after[1] * after[1]
+                                 + after[2] * after[2]);
+                if (event.type == Perigee)
+                    EXPECT_TRUE(r1 > radius && r2 > radius);
+                else
+                    EXPECT_TRUE(r1 < radius && r2 < radius);
+                break;
+            }
+        }
+
+        // Nodes and latitudes: compare with the sign changes on the grid
+        for (std::size_t satellite = 0; satellite < 2; ++satellite)
+        {
+            Propagator propagator(catalog[satellite], AccurateMath, model);
+            std::size_t ascending = 0, north = 0, north60 = 0;
+            double previous[3] = {0, 0, 0};
+            for (double t = start; t <= stop; t += 10)
+            {
+                double r[3];
+                propagator.state(t, r);
+                double s = r[2] / sqrt(r[0] * r[0] + r[1] * r[1]
+                                       + r[2] * r[2]);
+                if (t > start)
+                {
+                    double s0 = previous[2]
+                              / sqrt(previous[0] * previous[0]
+                                     + previous[1] * previous[1]
+                                     + previous[2] * previous[2]);
+                    ascending += s0 < 0 && s >= 0;
+                    north += s0 < sin(latitude) && s >= sin(latitude);
+                    north60 += s0 < sin(M_PI / 3) && s >= sin(M_PI / 3);
+                }
+                for (int k = 0; k < 3; ++k)
+                    previous[k] = r[k];
+            }
+            EXPECT_EQ(ascending, counts[6 * satellite + AscendingNode]);
+            if (!satellite)
+                north60First = north60;
+            EXPECT_EQ(north + north60,
+                      counts[6 * satellite + NorthwardLatitude]);
+            EXPECT_NEAR(double(counts[6 * satellite + AscendingNode]),
+                        double(counts[6 * satellite + DescendingNode]), 1.);
+            EXPECT_NEAR(double(counts[6 * satellite + NorthwardLatitude]),
+                        double(counts[6 * satellite + SouthwardLatitude]),
+                        2.);
+            EXPECT_NEAR(double(counts[6 * satellite + Perigee]),
+                        double(counts[6 * satellite + Apogee]), 1.);
+            EXPECT_LT(0u, counts[6 * satellite + Perigee]);
+        }
+        EXPECT_EQ(north60First, 0u);
+    }
+
+    finder.setNodeCrossings(false);
+    finder.setApsides(false);
+    finder.setLatitudes(std::vector<double>());
+    EXPECT_TRUE(finder.find(start, stop).empty());
+    EXPECT_TRUE(finder.find(stop, start).empty());
+}
+//------------------------------------------------------------------------------
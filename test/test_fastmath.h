@@ -0,0 +1,94 @@
+/*-----------------------------------------------------------------------------+
+ | QuickTle                                                                    |
+ | Copyright 2011-2015 Sergei Fundaev                                          |
+ +-----------------------------------------------------------------------------+
+ | This file is part of QuickTle library.                                      |
+ |                                                                             |
+ | QuickTle is free software: you can redistribute it and/or modify            |
+ | it under the terms of the GNU Lesser General Public License as published by |
+ | the Free Software Foundation, either version 3 of the License, or           |
+ | (at your option) any later version.                                         |
+ |                                                                             |
+ | QuickTle is distributed in the hope that it will be useful,                 |
+ | but WITHOUT ANY WARRANTY; without even the implied warranty of              |
+ | MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               |
+ | GNU Lesser General Public License for more details.                         |
+ |                                                                             |
+ | You should have received a copy of the GNU Lesser General Public License    |
+ | along with QuickTle. If not, see <http://www.gnu.org/licenses/>.            |
+ +----------------------------------------------------------------------------*/
+
+#include <cmath>
+#include <algorithm>
+#include <vector>
+#include <gtest/gtest.h>
+#include <quicktle/node.h>
+#include <quicktle/propagator.h>
+#include <quicktle/fastmath.h>
+#include "test_catalogs.h"
+
+using namespace quicktle;
+
+//
+//---- TESTS -------------------------------------------------------------------
+
+TEST(FastMathTest, sinCos)
+{
+    double maxError = 0;
+    for (double x = -1e4; x < 1e4; x += 0.0123)
+    {
+        double s, c;
+        fastSinCos(x, s, c);
+        maxError = std::max(maxError, fabs(s - sin(x)));
+        maxError = std::max(maxError, fabs(c - cos(x)));
+        ASSERT_EQ(s, fastSin(x));
+        ASSERT_EQ(c, fastCos(x));
+    }
+    EXPECT_LT(maxError, 2e-9);
+
+    float s, c;
+    fastSinCos(2.5f, s, c);
+    EXPECT_NEAR(sin(2.5), s, 1e-6);
+    EXPECT_NEAR(cos(2.5), c, 1e-6);
+}
+//------------------------------------------------------------------------------
+
+TEST(FastMathTest, propagator)
+{
+    Node node = mirNode();
+
+    std::vector<Node> nodes(3, node);
+    setMolniya(nodes[1]);
+    setGeostationary(nodes[2]);
+
+    const double t0 = node.preciseEpoch();
+    const std::size_t count = 3000;
+    const double step = 37;
+    for (std::size_t k = 0; k < nodes.size(); ++k)
+    {
+        Propagator accurate(nodes[k]);
+        Propagator fast(nodes[k], FastMath);
+        EXPECT_EQ(FastMath, fast.mathMode());
+
+        std::vector<double> x1(count), y1(count), z1(count);
+        std::vector<double> x2(count), y2(count), z2(count);
+        accurate.propagate(t0, step, count, &x1[0], &y1[0], &z1[0]);
+        fast.propagate(t0, step, count, &x2[0], &y2[0], &z2[0]);
+
+        // Documented bound: 1e-8 of the apogee radius
+        double apogee = nodes[k].a() * (1 + nodes[k].e());
+        for (std::size_t j = 0; j < count; ++j)
+        {
+            double d = sqrt((x2[j] - x1[j]) * (x2[j] - x1[j])
+                            + (y2[j] - y1[j]) * (y2[j] - y1[j])
+                            + (z2[j] - z1[j]) * (z2[j] - z1[j]));
+            EXPECT_LT(d, 1e-8 * apogee);
+
+            // Per call selection
+            double r[3];
+            accurate.state(t0 + j * step, r, 0, FastMath);
+            EXPECT_NEAR(x2[j], r[0], 1e-8 * apogee);
+        }
+    }
+}
+//------------------------------------------------------------------------------
@@ -0,0 +1,212 @@
+/*-----------------------------------------------------------------------------+
+ | QuickTle                                                                    |
+ | Copyright 2011-2015 Sergei Fundaev                                          |
+ +-----------------------------------------------------------------------------+
+ | This file is part of QuickTle library.                                      |
+ |                                                                             |
+ | QuickTle is free software: you can redistribute it and/or modify            |
+ | it under the terms of the GNU Lesser General Public License as published by |
+ | the Free Software Foundation, either version 3 of the License, or           |
+ | (at your option) any later version.                                         |
+ |                                                                             |
+ | QuickTle is distributed in the hope that it will be useful,                 |
+ | but WITHOUT ANY WARRANTY; without even the implied warranty of              |
+ | MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               |
+ | GNU Lesser General Public License for more details.                         |
+ |                                                                             |
+ | You should have received a copy of the GNU Lesser General Public License    |
+ | along with QuickTle. If not, see <http://www.gnu.org/licenses/>.            |
+ +----------------------------------------------------------------------------*/
+
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <gtest/gtest.h>
+#include <quicktle/node.h>
+#include <quicktle/propagator.h>
+#include <quicktle/frames.h>
+#include "test_catalogs.h"
+
+using namespace quicktle;
+
+//
+//---- TESTS -------------------------------------------------------------------
+
+TEST(FramesTest, earthOrientation)
+{
+    EarthOrientation eop;
+    EXPECT_FALSE(eop.load("nonexistent_finals.txt"));
+
+    // Two days in IERS "finals" format around the leap second of 2005
+    const char *fileName = "test_finals.txt";
+    {
+        std::ofstream file(fileName);
+        const double mjd[] = {53735, 53736};
+        const double dut1[] = {-0.6611, 0.3388};
+        for (int k = 0; k < 2; ++k)
+        {
+            std::string line(80, ' ');
+            char field[16];
+            std::sprintf(field, "%8.2f", mjd[k]);
+            line.replace(7, 8, field);
+            std::sprintf(field, "%9.6f", 0.05 + 0.01 * k);
+            line.replace(18, 9, field);
+            std::sprintf(field, "%9.6f", 0.38 - 0.02 * k);
+            line.replace(37, 9, field);
+            std::sprintf(field, "%10.7f", dut1[k]);
+            line.replace(58, 10, field);
+            file << line << std::endl;
+        }
+        file << "06 1 2 53737.00 I" << std::endl;
+    }
+    EXPECT_TRUE(eop.load(fileName));
+    std::remove(fileName);
+    ASSERT_EQ(2u, eop.size());
+
+    const double arcsec = M_PI / 180 / 3600;
+    const double t = (53735.25 - 40587) * 86400;
+    double xp, yp, dut1;
+    eop.parameters(t, xp, yp, dut1);
+    EXPECT_NEAR(0.0525 * arcsec, xp, 1e-15);
+    EXPECT_NEAR(0.375 * arcsec, yp, 1e-15);
+    EXPECT_NEAR(-0.6611 + 0.25 * -0.0001, dut1, 1e-9);
+
+    // Outside of the table
+    eop.parameters(t + 10 * 86400, xp, yp, dut1);
+    EXPECT_NEAR(0.3388, dut1, 1e-12);
+}
+//------------------------------------------------------------------------------
+
+TEST(FramesTest, rotations)
+{
+    // Example of Vallado et al., "Revisiting Spacetrack Report #3"
+    const double t = 1081237888.386009;
+    const double arcsec = M_PI / 180 / 3600;
+    EarthOrientation eop;
+    eop.append(53101, -0.140682 * arcsec, 0.333309 * arcsec, -0.4399619);
+    eop.append(53102, -0.140682 * arcsec, 0.333309 * arcsec, -0.4399619);
+    FrameConverter converter(&eop);
+    EXPECT_EQ(&eop, converter.earthOrientation());
+
+    const double teme[3] = {5094.18016210e3, 6127.64465950e3, 6380.34453270e3};
+    const double gcrf[3] = {5102.50895290e3, 6123.01139910e3, 6378.13693380e3};
+    const double itrf[3] = {-1033.47938300e3, 7901.29527540e3,
+                            6380.35659580e3};
+    double toGcrf[9], toItrf[9];
+    converter.rotations(t, toGcrf, toItrf);
+    for (int i = 0; i < 3; ++i)
+    {
+        double g = toGcrf[3 * i] * teme[0] + toGcrf[3 * i + 1] * teme[1] +
+                   toGcrf[3 * i + 2] * teme[2];
+        double e = toItrf[3 * i] * teme[0] + toItrf[3 * i + 1] * teme[1] +
+                   toItrf[3 * i + 2] * teme[2];
+        EXPECT_NEAR(gcrf[i], g, 2);
+        EXPECT_NEAR(itrf[i], e, 0.05);
+    }
+
+    // Orthogonality
+    for (int i = 0; i < 3; ++i)
+    {
+        for (int j = 0; j < 3; ++j)
+        {
+            double g = 0, e = 0;
+            for (int k = 0; k < 3; ++k)
+            {
+                g += toGcrf[3 * i + k] * toGcrf[3 * j + k];
+                e += toItrf[3 * i + k] * toItrf[3 * j + k];
+            }
+            EXPECT_NEAR(i == j ? 1 : 0, g, 1e-14);
+            EXPECT_NEAR(i == j ? 1 : 0, e, 1e-14);
+        }
+    }
+}
+//------------------------------------------------------------------------------
+
+TEST(FramesTest, grid)
+{
+    const Node node = mirNode();
+    const Propagator propagator(node);
+    const double start = node.preciseEpoch();
+    const double step = 7;
+    const std::size_t count = 2000;
+
+    EarthOrientation eop;
+    const double arcsec = M_PI / 180 / 3600;
+    eop.append(46485, 0.1 * arcsec, 0.2 * arcsec, 0.3);
+    eop.append(46486, 0.11 * arcsec, 0.19 * arcsec, 0.298);
+    FrameConverter converter(&eop);
+    converter.setInterval(1800);
+
+    std::vector<double> x(count), y(count), z(count), vx(count), vy(count),
+                        vz(count);
+    propagator.propagate(start, step, count, &x[0], &y[0], &z[0],
+                         &vx[0], &vy[0], &vz[0]);
+    std::vector<double> gx(x), gy(y), gz(z), ex(x), ey(y), ez(z),
+                        evx(vx), evy(vy), evz(vz);
+    converter.toGcrf(start, step, count, &gx[0], &gy[0], &gz[0]);
+    converter.toItrf(start, step, count, &ex[0], &ey[0], &ez[0],
+                     &evx[0], &evy[0], &evz[0]);
+
+    const double h = 0.5;
+    for (std::size_t k = 0; k < count; k += 13)
+    {
+        double t = start + k * step;
+        double toGcrf[9], toItrf[9];
+        converter.rotations(t, toGcrf, toItrf);
+        double r[3] = {x[k], y[k], z[k]};
+        double g[3] = {gx[k], gy[k], gz[k]};
+        double e[3] = {ex[k], ey[k], ez[k]};
+        for (int i = 0; i < 3; ++i)
+        {
+            EXPECT_NEAR(toGcrf[3 * i] * r[0] + toGcrf[3 * i + 1] * r[1] +
+                        toGcrf[3 * i + 2] * r[2], g[i], 1e-3);
+            EXPECT_NEAR(toItrf[3 * i] * r[0] + toItrf[3 * i + 1] * r[1] +
+                        toItrf[3 * i + 2] * r[2], e[i], 1e-3);
+        }
+
+        // Earth-fixed velocity is the derivative of the position
+        double before[3], after[3];
+        propagator.state(t - h, before);
+        propagator.state(t + h, after);
+        converter.toItrf(t - h, 1, 1, before, before + 1, before + 2);
+        converter.toItrf(t + h, 1, 1, after, after + 1, after + 2);
+        double v[3] = {evx[k], evy[k], evz[k]};
+        for (int i = 0; i < 3; ++i)
+            EXPECT_NEAR((after[i] - before[i]) / (2 * h), v[i], 2e-3);
+    }
+
+    // The grid over the leap second at the end of MJD 53735 agrees with
+    // the rotations at each sample
+    EarthOrientation leap;
+    leap.append(53735, 0.05 * arcsec, 0.38 * arcsec, -0.6611);
+    leap.append(53736, 0.06 * arcsec, 0.36 * arcsec, 0.3388);
+    converter.setEarthOrientation(&leap);
+    converter.setInterval(3600);
+    const double leapStart = (53735.9 - 40587) * 86400;
+    const double leapStep = 10;
+    const std::size_t leapCount = 1440;
+    x.resize(leapCount);
+    y.resize(leapCount);
+    z.resize(leapCount);
+    propagator.propagate(leapStart, leapStep, leapCount, &x[0], &y[0],
+                         &z[0]);
+    ex = x;
+    ey = y;
+    ez = z;
+    converter.toItrf(leapStart, leapStep, leapCount, &ex[0], &ey[0], &ez[0]);
+    for (std::size_t k = 0; k < leapCount; k += 7)
+    {
+        double toItrf[9];
+        converter.rotations(leapStart + k * leapStep, 0, toItrf);
+        double r[3] = {x[k], y[k], z[k]};
+        double e[3] = {ex[k], ey[k], ez[k]};
+        for (int i = 0; i < 3; ++i)
+        {
+            EXPECT_NEAR(toItrf[3 * i] * r[0] + toItrf[3 * i + 1] * r[1] +
+                        toItrf[3 * i + 2] * r[2], e[i], 1e-3);
+        }
+    }
+}
+//------------------------------------------------------------------------------
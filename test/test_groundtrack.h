@@ -0,0 +1,121 @@
+/*-----------------------------------------------------------------------------+
+ | QuickTle                                                                    |
+ | Copyright 2011-2015 Sergei Fundaev                                          |
+ +-----------------------------------------------------------------------------+
+ | This file is part of QuickTle library.                                      |
+ |                                                                             |
+ | QuickTle is free software: you can redistribute it and/or modify            |
+ | it under the terms of the GNU Lesser General Public License as published by |
+ | the Free Software Foundation, either version 3 of the License, or           |
+ | (at your option) any later version.                                         |
+ |                                                                             |
+ | QuickTle is distributed in the hope that it will be useful,                 |
+ | but WITHOUT ANY WARRANTY; without even the implied warranty of              |
+ | MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               |
+ | GNU Lesser General Public License for more details.                         |
+ |                                                                             |
+ | You should have received a copy of the GNU Lesser General Public License    |
+ | along with QuickTle. If not, see <http://www.gnu.org/licenses/>.            |
+ +----------------------------------------------------------------------------*/
+
+#include <cmath>
+#include <vector>
+#include <gtest/gtest.h>
+#include <quicktle/node.h>
+#include <quicktle/propagator.h>
+#include <quicktle/coordinates.h>
+#include <quicktle/groundtrack.h>
+#include "test_catalogs.h"
+
+using namespace quicktle;
+
+//
+//---- TESTS -------------------------------------------------------------------
+
+TEST(GroundTrackTest, compute)
+{
+    Node node = mirNode();
+    std::vector<Node> catalog(3, node);
+    setMolniya(catalog[1]);
+    catalog[2].set_i(98.7);
+
+    const double tolerance = 1e-2;
+    const double start = node.preciseEpoch();
+    const double stop = start + 4 * 86400;
+    std::vector< std::vector<Polyline> > tracks;
+    groundTracks(catalog, start, stop, tolerance, tracks);
+    ASSERT_EQ(catalog.size(), tracks.size());
+
+    for (std::size_t k = 0; k < catalog.size(); ++k)
+    {
+        const std::vector<Polyline> &polylines = tracks[k];
+        ASSERT_FALSE(polylines.empty());
+        EXPECT_EQ(start, polylines.front().front().t);
+        EXPECT_EQ(stop, polylines.back().back().t);
+
+        std::size_t points = 0;
+        for (std::size_t p = 0; p < polylines.size(); ++p)
+        {
+            const Polyline &polyline = polylines[p];
+            ASSERT_GE(polyline.size(), 2u);
+            points += polyline.size();
+            if (p > 0)
+            {
+                EXPECT_EQ(polylines[p - 1].back().t, polyline.front().t);
+                EXPECT_EQ(M_PI, fabs(polyline.front().longitude));
+                EXPECT_EQ(-polylines[p - 1].back().longitude,
+                          polyline.front().longitude);
+            }
+            for (std::size_t j = 0; j < polyline.size(); ++j)
+            {
+                EXPECT_LE(fabs(polyline[j].longitude), M_PI);
+                if (j > 0)
+                {
+                    EXPECT_LT(polyline[j - 1].t, polyline[j].t);
+                    EXPECT_LT(fabs(polyline[j].longitude -
+                                   polyline[j - 1].longitude), M_PI);
+                }
+            }
+        }
+
+        // Order of magnitude fewer points than the fine sampling
+        const double step = 10;
+        const std::size_t fine = std::size_t((stop - start) / step);
+        EXPECT_LT(10 * points, fine);
+
+        // The fine samples are close to the polylines
+        const Propagator propagator(catalog[k]);
+        std::size_t p = 0, j = 1;
+        for (std::size_t s = 0; s < fine; ++s)
+        {
+            double t = start + s * step;
+            while (polylines[p][j].t < t)
+            {
+                if (++j == polylines[p].size())
+                {
+                    ++p;
+                    j = 1;
+                }
+            }
+            const TrackPoint &a = polylines[p][j - 1];
+            const TrackPoint &b = polylines[p][j];
+
+            double r[3], latitude, longitude, altitude;
+            propagator.state(t, r);
+            EarthRotation(t).eci2geodetic(1, r, r + 1, r + 2,
+                                          &latitude, &longitude, &altitude);
+            longitude += 2 * M_PI * floor((a.longitude - longitude) /
+                                          (2 * M_PI) + 0.5);
+
+            double dx = b.longitude - a.longitude;
+            double dy = b.latitude - a.latitude;
+            double px = longitude - a.longitude;
+            double py = latitude - a.latitude;
+            double length2 = dx * dx + dy * dy;
+            double f = length2 > 0 ? (px * dx + py * dy) / length2 : 0;
+            f = f < 0 ? 0 : (f > 1 ? 1 : f);
+            EXPECT_LT(hypot(px - f * dx, py - f * dy), 1.5 * tolerance);
+        }
+    }
+}
+//------------------------------------------------------------------------------
@@ -0,0 +1,161 @@
+/*-----------------------------------------------------------------------------+
+ | QuickTle                                                                    |
+ | Copyright 2011-2015 Sergei Fundaev                                          |
+ +-----------------------------------------------------------------------------+
+ | This file is part of QuickTle library.                                      |
+ |                                                                             |
+ | QuickTle is free software: you can redistribute it and/or modify            |
+ | it under the terms of the GNU Lesser General Public License as published by |
+ | the Free Software Foundation, either version 3 of the License, or           |
+ | (at your option) any later version.                                         |
+ |                                                                             |
+ | QuickTle is distributed in the hope that it will be useful,                 |
+ | but WITHOUT ANY WARRANTY; without even the implied warranty of              |
+ | MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               |
+ | GNU Lesser General Public License for more details.                         |
+ |                                                                             |
+ | You should have received a copy of the GNU Lesser General Public License    |
+ | along with QuickTle. If not, see <http://www.gnu.org/licenses/>.            |
+ +----------------------------------------------------------------------------*/
+
+#include <cmath>
+#include <algorithm>
+#include <utility>
+#include <vector>
+#include <gtest/gtest.h>
+#include <quicktle/node.h>
+#include <quicktle/propagator.h>
+#include <quicktle/lineofsight.h>
+#include "test_catalogs.h"
+
+#define EARTH_RADIUS 6378137.
+
+using namespace quicktle;
+
+//
+//---- TESTS -------------------------------------------------------------------
+
+TEST(LineOfSightTest, bruteForce)
+{
+    std::vector<Node> catalog = lowOrbitCatalog(300);
+    const double t = catalog[0].preciseEpoch() + 5000;
+
+    LineOfSightMatrix matrix(catalog);
+    EXPECT_EQ(catalog.size(), matrix.size());
+    EXPECT_EQ(100e3, matrix.margin());
+
+    const double ranges[] = {0, 3000e3};
+    for (double maxRange : ranges)
+    {
+        matrix.setMaxRange(maxRange);
+        std::size_t links = matrix.compute(t);
+        EXPECT_EQ(t, matrix.time());
+        EXPECT_EQ(links, matrix.links());
+        EXPECT_LT(0u, links);
+
+        // Dense test of all pairs
+        const double radius = EARTH_RADIUS + matrix.margin();
+        std::size_t expected = 0;
+        const std::size_t *offsets = matrix.offsets();
+        for (std::size_t k = 0; k < catalog.size(); ++k)
+        {
+            std::vector<std::size_t> neighbours;
+            std::vector<double> distances;
+            for (std::size_t j = 0; j < catalog.size(); ++j)
+            {
+                if (j == k)
+                    continue;
+                const double *a = matrix.position(k);
+                const double *b = matrix.position(j);
+                double d[3] = {b[0] - a[0], b[1] - a[1], b[2] - a[2]};
+                double dd = d[0] * d[0] + d[1] * d[1] + d[2] * d[2];
+                double s = -(a[0] * d[0] + a[1] * d[1] + a[2] * d[2]) / dd;
+                s = std::min(1., std::max(0., s));
+                double p[3] = {a[0] + s * d[0], a[1] + s * d[1],
+                               a[2] + s * d[2]};
+                if (sqrt(p[0] * p[0] + p[1] * p[1] + p[2] * p[2]) < radius)
+                    continue;
+                if (maxRange > 0 && sqrt(dd) > maxRange)
+                    continue;
+                neighbours.push_back(j);
+                distances.push_back(sqrt(dd));
+            }
+            expected += neighbours.size();
+
+            // The lists are in no particular order
+            ASSERT_EQ(neighbours.size(), offsets[k + 1] - offsets[k]);
+            std::vector< std::pair<std::size_t, double> > row;
+            for (std::size_t j = offsets[k]; j < offsets[k + 1]; ++j)
+            {
+                row.push_back(std::make_pair(matrix.neighbours()[j],
+                                             matrix.ranges()[j]));
+            }
+            std::sort(row.begin(), row.end());
+            for (std::size_t j = 0; j < neighbours.size(); ++j)
+            {
+                EXPECT_EQ(neighbours[j], row[j].first);
+                EXPECT_NEAR(distances[j], row[j].second, 1e-6);
+            }
+        }
+        EXPECT_EQ(expected, 2 * links);
+    }
+
+    // The result does not depend on the number of threads
+    std::vector<std::size_t> neighbours(matrix.neighbours(),
+                                        matrix.neighbours()
+                                        + 2 * matrix.links());
+    matrix.setThreads(3);
+    matrix.compute(t);
+    ASSERT_EQ(neighbours.size(), 2 * matrix.links());
+    for (std::size_t k = 0; k < neighbours.size(); ++k)
+        EXPECT_EQ(neighbours[k], matrix.neighbours()[k]);
+}
+//------------------------------------------------------------------------------
+
+TEST(LineOfSightTest, grazing)
+{
+    std::vector<Node> catalog = lowOrbitCatalog(2);
+
+    // Two satellites in one circular orbit: the line between them grazes
+    // the sphere, when the angle between them is 2 * acos(R / r)
+    for (std::size_t k = 0; k < 2; ++k)
+    {
+        catalog[k].set_e(0);
+        catalog[k].set_i(0);
+        catalog[k].set_Omega(0);
+        catalog[k].set_omega(0);
+        catalog[k].set_n(2 * M_PI / 5800.);
+    }
+    Propagator propagator(catalog[0]);
+    double r[3];
+    propagator.state(catalog[0].preciseEpoch(), r);
+    double radius = sqrt(r[0] * r[0] + r[1] * r[1] + r[2] * r[2]);
+    double margin = 80e3;
+    double angle = 2 * acos((EARTH_RADIUS + margin) / radius) * 180 / M_PI;
+
+    LineOfSightMatrix matrix;
+    matrix.setMargin(margin);
+    EXPECT_EQ(0u, matrix.compute(0));
+    EXPECT_EQ(0, matrix.neighbours());
+
+    catalog[0].set_M(0);
+    catalog[1].set_M(angle - 0.01);
+    matrix.setSatellites(catalog);
+    EXPECT_EQ(1u, matrix.compute(catalog[0].preciseEpoch()));
+    EXPECT_EQ(1u, matrix.neighbours()[0]);
+    EXPECT_EQ(0u, matrix.neighbours()[1]);
+    EXPECT_NEAR(2 * radius * sin((angle - 0.01) / 2 * M_PI / 180),
+                matrix.ranges()[0], 1.);
+
+    catalog[1].set_M(angle + 0.01);
+    matrix.setSatellites(catalog);
+    EXPECT_EQ(0u, matrix.compute(catalog[0].preciseEpoch()));
+    EXPECT_EQ(0u, matrix.offsets()[2]);
+
+    // The range limit cuts the link
+    catalog[1].set_M(angle - 0.01);
+    matrix.setSatellites(catalog);
+    matrix.setMaxRange(1000e3);
+    EXPECT_EQ(0u, matrix.compute(catalog[0].preciseEpoch()));
+}
+//------------------------------------------------------------------------------
@@ -0,0 +1,105 @@
+/*-----------------------------------------------------------------------------+
+ | QuickTle                                                                    |
+ | Copyright 2011-2015 Sergei Fundaev                                          |
+ +-----------------------------------------------------------------------------+
+ | This file is part of QuickTle library.                                      |
+ |                                                                             |
+ | QuickTle is free software: you can redistribute it and/or modify            |
+ | it under the terms of the GNU Lesser General Public License as published by |
+ | the Free Software Foundation, either version 3 of the License, or           |
+ | (at your option) any later version.                                         |
+ |                                                                             |
+ | QuickTle is distributed in the hope that it will be useful,                 |
+ | but WITHOUT ANY WARRANTY; without even the implied warranty of              |
+ | MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               |
+ | GNU Lesser General Public License for more details.                         |
+ |                                                                             |
+ | You should have received a copy of the GNU Lesser General Public License    |
+ | along with QuickTle. If not, see <http://www.gnu.org/licenses/>.            |
+ +----------------------------------------------------------------------------*/
+
+#include <cmath>
+#include <vector>
+#include <gtest/gtest.h>
+#include <quicktle/node.h>
+#include <quicktle/dataset.h>
+#include <quicktle/station.h>
+#include <quicktle/coordinates.h>
+#include <quicktle/propagator.h>
+#include <quicktle/lookangles.h>
+#include "test_catalogs.h"
+
+using namespace quicktle;
+
+//
+//---- TESTS -------------------------------------------------------------------
+
+TEST(LookAnglesTest, matrix)
+{
+    Node node = mirNode();
+
+    std::vector<Node> satellites(300, node);
+    for (std::size_t k = 0; k < satellites.size(); ++k)
+    {
+        satellites[k].set_M(1.2 * k);
+        satellites[k].set_Omega(0.7 * k);
+    }
+    setMolniya(satellites[1]);
+
+    std::vector<Station> stations;
+    stations.push_back(Station(0.97, 0.66, 150));
+    stations.push_back(Station(-0.5, -2.1, 20));
+    stations.push_back(Station(1.5, 3.0, 3000));
+
+    const double t = node.preciseEpoch() + 3600;
+    LookAngleMatrix matrix(stations, satellites);
+    ASSERT_EQ(stations.size(), matrix.stations());
+    ASSERT_EQ(satellites.size(), matrix.satellites());
+    matrix.setThreads(3);
+    matrix.compute(t);
+    EXPECT_EQ(t, matrix.time());
+
+    const double h = 0.1;
+    for (std::size_t s = 0; s < stations.size(); ++s)
+    {
+        for (std::size_t k = 0; k < satellites.size(); ++k)
+        {
+            const std::size_t index = s * satellites.size() + k;
+            Propagator propagator(satellites[k]);
+            double r[3], ecef[3], azimuth, elevation, range;
+            propagator.state(t, r);
+            EarthRotation(t).eci2ecef(r, ecef);
+            stations[s].lookAngles(ecef, azimuth, elevation, range);
+            EXPECT_NEAR(azimuth, matrix.azimuth()[index], 1e-9);
+            EXPECT_NEAR(elevation, matrix.elevation()[index], 1e-9);
+            EXPECT_NEAR(range, matrix.range()[index], 1e-6);
+
+            double before, after;
+            propagator.state(t - h, r);
+            EarthRotation(t - h).eci2ecef(r, ecef);
+            stations[s].lookAngles(ecef, azimuth, elevation, before);
+            propagator.state(t + h, r);
+            EarthRotation(t + h).eci2ecef(r, ecef);
+            stations[s].lookAngles(ecef, azimuth, elevation, after);
+            EXPECT_NEAR((after - before) / (2 * h),
+                        matrix.rangeRate()[index], 1e-2);
+        }
+    }
+
+    // The same satellites, specified by data sets
+    std::vector<DataSet> dataSets(satellites.size());
+    for (std::size_t k = 0; k < satellites.size(); ++k)
+        dataSets[k].append(satellites[k]);
+    LookAngleMatrix other;
+    other.setStations(stations);
+    other.setSatellites(dataSets);
+    other.compute(t);
+    for (std::size_t k = 0; k < stations.size() * satellites.size(); ++k)
+    {
+        EXPECT_DOUBLE_EQ(matrix.azimuth()[k], other.azimuth()[k]);
+        EXPECT_DOUBLE_EQ(matrix.elevation()[k], other.elevation()[k]);
+        EXPECT_DOUBLE_EQ(matrix.range()[k], other.range()[k]);
+        EXPECT_DOUBLE_EQ(matrix.rangeRate()[k], other.rangeRate()[k]);
+    }
+}
+//------------------------------------------------------------------------------
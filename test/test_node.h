@@ -468,4 +468,84 @@ TEST_F(NodeTest, vx_vy_vz)
     EXPECT_NEAR(0, vy(), dvy());
     EXPECT_NEAR(0, vz(), dvz());
 }
-//------------------------------------------------------------------------------
\ No newline at end of file
+//------------------------------------------------------------------------------
+TEST_F(NodeTest, orbitConstantsCache)
+{
+    std::string line2 = "1 16609U 86017A   86053.30522506  .00057349  00000-0"
+                                                            "  31166-3 0   112";
+    std::string line3 = "2 16609  51.6129 108.0599 0012107 160.8295 196.0076"
+                                                           " 15.79438158   394";
+    Node node(line2, line3);
+
+    EXPECT_DOUBLE_EQ(cbrt(GM / (node.n() * node.n())), node.a());
+    EXPECT_DOUBLE_EQ(node.a() * (1 - pow(node.e(), 2)), node.p());
+
+    // Orientation matrix is orthonormal
+    const double *R = node.orientation();
+    for (int row1 = 0; row1 < 3; ++row1)
+    {
+        for (int row2 = 0; row2 < 3; ++row2)
+        {
+            double product = 0;
+            for (int k = 0; k < 3; ++k)
+                product += R[3 * row1 + k] * R[3 * row2 + k];
+            EXPECT_NEAR(row1 == row2 ? 1 : 0, product, 1e-15);
+        }
+    }
+    EXPECT_DOUBLE_EQ(cos(node.i()), R[8]);
+
+    // Setters invalidate the cache
+    double n = node.n() / 2;
+    node.set_n(n);
+    EXPECT_DOUBLE_EQ(cbrt(GM / (n * n)), node.a());
+
+    node.set_e(0.1);
+    EXPECT_DOUBLE_EQ(node.a() * (1 - 0.01), node.p());
+
+    node.set_i(30);
+    EXPECT_DOUBLE_EQ(cos(deg2rad(30)), node.orientation()[8]);
+
+    node.set_Omega(45);
+    EXPECT_DOUBLE_EQ(sin(deg2rad(45)) * sin(deg2rad(30)),
+                     node.orientation()[2]);
+
+    node.set_omega(60);
+    EXPECT_DOUBLE_EQ(sin(deg2rad(60)) * sin(deg2rad(30)),
+                     node.orientation()[6]);
+
+    double E = node.E();
+    node.set_M(10);
+    EXPECT_NE(E, node.E());
+    EXPECT_NEAR(node.M(), node.E() - 0.1 * sin(node.E()), 1e-7);
+
+    double r = sqrt(pow(node.x(), 2) + pow(node.y(), 2) + pow(node.z(), 2));
+    EXPECT_NEAR(node.r(), r, 1e-6);
+
+    // Copy keeps the cached values consistent with the elements
+    Node copy(node);
+    EXPECT_DOUBLE_EQ(node.x(), copy.x());
+    EXPECT_DOUBLE_EQ(node.vz(), copy.vz());
+    copy.set_i(60);
+    EXPECT_DOUBLE_EQ(cos(deg2rad(60)), copy.orientation()[8]);
+    EXPECT_DOUBLE_EQ(cos(deg2rad(30)), node.orientation()[8]);
+
+    // All elements at once give the same values as the single setters
+    Node bulk(node);
+    bulk.setElements(n / 3, 0.2, deg2rad(40), deg2rad(50), deg2rad(70),
+                     deg2rad(80));
+    copy.set_n(n / 3);
+    copy.set_e(0.2);
+    copy.set_i(40);
+    copy.set_Omega(50);
+    copy.set_omega(70);
+    copy.set_M(80);
+    EXPECT_DOUBLE_EQ(copy.a(), bulk.a());
+    EXPECT_DOUBLE_EQ(copy.p(), bulk.p());
+    EXPECT_DOUBLE_EQ(copy.E(), bulk.E());
+    EXPECT_DOUBLE_EQ(copy.nu(), bulk.nu());
+    for (int k = 0; k < 9; ++k)
+        EXPECT_DOUBLE_EQ(copy.orientation()[k], bulk.orientation()[k]);
+    EXPECT_DOUBLE_EQ(copy.x(), bulk.x());
+    EXPECT_DOUBLE_EQ(copy.vz(), bulk.vz());
+}
+//------------------------------------------------------------------------------
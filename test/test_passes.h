@@ -0,0 +1,172 @@
+/*-----------------------------------------------------------------------------+
+ | QuickTle                                                                    |
+ | Copyright 2011-2015 Sergei Fundaev                                          |
+ +-----------------------------------------------------------------------------+
+ | This file is part of QuickTle library.                                      |
+ |                                                                             |
+ | QuickTle is free software: you can redistribute it and/or modify            |
+ | it under the terms of the GNU Lesser General Public License as published by |
+ | the Free Software Foundation, either version 3 of the License, or           |
+ | (at your option) any later version.                                         |
+ |                                                                             |
+ | QuickTle is distributed in the hope that it will be useful,                 |
+ | but WITHOUT ANY WARRANTY; without even the implied warranty of              |
+ | MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               |
+ | GNU Lesser General Public License for more details.                         |
+ |                                                                             |
+ | You should have received a copy of the GNU Lesser General Public License    |
+ | along with QuickTle. If not, see <http://www.gnu.org/licenses/>.            |
+ +----------------------------------------------------------------------------*/
+
+#include <cmath>
+#include <vector>
+#include <gtest/gtest.h>
+#include <quicktle/node.h>
+#include <quicktle/passes.h>
+#include <quicktle/propagator.h>
+#include <quicktle/coordinates.h>
+#include <quicktle/func.h>
+#include "test_catalogs.h"
+
+using namespace quicktle;
+
+//! Find the passes by the brute force scanning with 1 second step
+static std::vector<Pass> scanPasses(const std::vector<Station> &stations,
+                                    const std::vector<Node> &satellites,
+                                    double start, double stop)
+{
+    std::vector<Pass> passes;
+    for (std::size_t st = 0; st < stations.size(); ++st)
+    {
+        for (std::size_t sat = 0; sat < satellites.size(); ++sat)
+        {
+            Propagator propagator(satellites[sat]);
+            bool open = false;
+            Pass pass;
+            for (double t = start; t <= stop; t += 1)
+            {
+                double eci[3], ecef[3];
+                propagator.state(t, eci);
+                EarthRotation(t).eci2ecef(eci, ecef);
+                double elevation = stations[st].elevation(ecef);
+                bool visible = elevation >= stations[st].minElevation();
+                if (visible && !open)
+                {
+                    pass.station = st;
+                    pass.satellite = sat;
+                    pass.rise = t;
+                    pass.maxElevation = elevation;
+                    pass.culmination = t;
+                    open = true;
+                }
+                if (visible && elevation > pass.maxElevation)
+                {
+                    pass.maxElevation = elevation;
+                    pass.culmination = t;
+                }
+                if (!visible && open)
+                {
+                    pass.set = t;
+                    passes.push_back(pass);
+                    open = false;
+                }
+            }
+        }
+    }
+    return passes;
+}
+//------------------------------------------------------------------------------
+
+//
+//---- TESTS -------------------------------------------------------------------
+
+TEST(PassPredictorTest, bruteForce)
+{
+    std::vector<Node> satellites;
+    satellites.push_back(Node("1 25544U 98067A   98325.70495433 -.00030123"
+                              "  11429-4 -58797-4 0   131",
+                              "2 25544  51.5959 160.7754 0074891  99.0987"
+                              " 261.5489 15.92210234   236"));
+    satellites.push_back(mirNode());
+    satellites.push_back(satellites[1]);
+    satellites[2].set_e(0.6);
+    satellites[2].set_n(satellites[1].n() / 4);
+    satellites[2].set_i(98);
+
+    std::vector<Station> stations;
+    stations.push_back(Station(deg2rad(55.75), deg2rad(37.62), 150));
+    stations.push_back(Station(deg2rad(-33.9), deg2rad(18.4), 0, deg2rad(10)));
+    stations.push_back(Station(deg2rad(78.2), deg2rad(15.6), 0, deg2rad(5)));
+    stations.push_back(Station(deg2rad(-89), deg2rad(0)));
+
+    double start = satellites[0].preciseEpoch();
+    double stop = start + 86400;
+
+    PassPredictor predictor(stations, satellites);
+    predictor.setThreads(3);
+    std::vector<Pass> passes = predictor.predict(start, stop);
+    std::vector<Pass> expected = scanPasses(stations, satellites, start, stop);
+
+    ASSERT_LT(10, expected.size());
+    ASSERT_EQ(expected.size(), passes.size());
+    for (std::size_t k = 0; k < expected.size(); ++k)
+    {
+        // Find the matching pass
+        std::size_t j = 0;
+        while (j < passes.size()
+               && (passes[j].station != expected[k].station
+                   || passes[j].satellite != expected[k].satellite
+                   || fabs(passes[j].rise - expected[k].rise) > 1.5))
+        {
+            ++j;
+        }
+        ASSERT_LT(j, passes.size());
+        EXPECT_NEAR(expected[k].set, passes[j].set, 1.5);
+        EXPECT_NEAR(expected[k].maxElevation, passes[j].maxElevation, 1e-4);
+        EXPECT_LE(passes[j].rise, passes[j].culmination);
+        EXPECT_LE(passes[j].culmination, passes[j].set);
+    }
+
+    // Passes are ordered by the rise time
+    for (std::size_t k = 1; k < passes.size(); ++k)
+        EXPECT_LE(passes[k - 1].rise, passes[k].rise);
+
+    // The result does not depend on the number of threads
+    predictor.setThreads(1);
+    std::vector<Pass> passes1 = predictor.predict(start, stop);
+    ASSERT_EQ(passes.size(), passes1.size());
+    for (std::size_t k = 0; k < passes.size(); ++k)
+    {
+        EXPECT_EQ(passes[k].station, passes1[k].station);
+        EXPECT_EQ(passes[k].satellite, passes1[k].satellite);
+        EXPECT_DOUBLE_EQ(passes[k].rise, passes1[k].rise);
+        EXPECT_DOUBLE_EQ(passes[k].set, passes1[k].set);
+    }
+}
+//------------------------------------------------------------------------------
+
+TEST(PassPredictorTest, geostationary)
+{
+    Node node("1 40141U 14052A   14277.84589631 -.00000387  00000-0"
+              "  10000-3 0   362",
+              "2 40141   0.0409 337.4123 0002696 277.4110 182.9520"
+              "  1.00272844   312");
+    std::vector<Node> satellites(1, node);
+    std::vector<Station> stations;
+    // Sub-satellite point is near 119.8 E
+    stations.push_back(Station(0, deg2rad(120), 0, deg2rad(5)));
+    stations.push_back(Station(deg2rad(80), deg2rad(120), 0, deg2rad(5)));
+    stations.push_back(Station(0, deg2rad(-60), 0, deg2rad(5)));
+
+    double start = node.preciseEpoch();
+    PassPredictor predictor(stations, satellites);
+    std::vector<Pass> passes = predictor.predict(start, start + 3 * 86400);
+
+    // Permanently visible from the first station only
+    ASSERT_EQ(1, passes.size());
+    EXPECT_EQ(0, passes[0].station);
+    EXPECT_DOUBLE_EQ(start, passes[0].rise);
+    EXPECT_DOUBLE_EQ(start + 3 * 86400, passes[0].set);
+    EXPECT_LT(deg2rad(80), passes[0].maxElevation);
+}
+//------------------------------------------------------------------------------
@@ -0,0 +1,347 @@
+/*-----------------------------------------------------------------------------+
+ | QuickTle                                                                    |
+ | Copyright 2011-2015 Sergei Fundaev                                          |
+ +-----------------------------------------------------------------------------+
+ | This file is part of QuickTle library.                                      |
+ |                                                                             |
+ | QuickTle is free software: you can redistribute it and/or modify            |
+ | it under the terms of the GNU Lesser General Public License as published by |
+ | the Free Software Foundation, either version 3 of the License, or           |
+ | (at your option) any later version.                                         |
+ |                                                                             |
+ | QuickTle is distributed in the hope that it will be useful,                 |
+ | but WITHOUT ANY WARRANTY; without even the implied warranty of              |
+ | MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               |
+ | GNU Lesser General Public License for more details.                         |
+ |                                                                             |
+ | You should have received a copy of the GNU Lesser General Public License    |
+ | along with QuickTle. If not, see <http://www.gnu.org/licenses/>.            |
+ +----------------------------------------------------------------------------*/
+
+#include <cmath>
+#include <algorithm>
+#include <vector>
+#include <gtest/gtest.h>
+#include <quicktle/node.h>
+#include <quicktle/dataset.h>
+#include <quicktle/propagator.h>
+#include <quicktle/func.h>
+#include "test_catalogs.h"
+
+#define GM 3.986004418e14
+
+using namespace quicktle;
+
+//
+//---- TESTS -------------------------------------------------------------------
+
+TEST(PropagatorTest, stateAtEpoch)
+{
+    Node node = mirNode();
+    Propagator propagator(node);
+
+    double r[3], v[3];
+    propagator.state(node.preciseEpoch(), r, v);
+
+    // Node::E() is solved with the relative error 1e-7
+    EXPECT_NEAR(node.x(), r[0], 5.);
+    EXPECT_NEAR(node.y(), r[1], 5.);
+    EXPECT_NEAR(node.z(), r[2], 5.);
+    EXPECT_NEAR(node.vx(), v[0], 0.01);
+    EXPECT_NEAR(node.vy(), v[1], 0.01);
+    EXPECT_NEAR(node.vz(), v[2], 0.01);
+}
+//------------------------------------------------------------------------------
+
+TEST(PropagatorTest, period)
+{
+    Node node = mirNode();
+    Propagator propagator(node);
+
+    double t0 = node.preciseEpoch();
+    double T = 2 * M_PI / node.n();
+    double r0[3], v0[3], r1[3], v1[3];
+    propagator.state(t0, r0, v0);
+    propagator.state(t0 + 10 * T, r1, v1);
+    for (int k = 0; k < 3; ++k)
+    {
+        EXPECT_NEAR(r0[k], r1[k], 1e-3);
+        EXPECT_NEAR(v0[k], v1[k], 1e-6);
+    }
+
+    // Energy integral
+    propagator.state(t0 + T / 3, r1, v1);
+    double rr = sqrt(r1[0] * r1[0] + r1[1] * r1[1] + r1[2] * r1[2]);
+    double vv = v1[0] * v1[0] + v1[1] * v1[1] + v1[2] * v1[2];
+    EXPECT_NEAR(-GM / (2 * node.a()), vv / 2 - GM / rr, 1e-6);
+}
+//------------------------------------------------------------------------------
+
+TEST(PropagatorTest, ephemeris)
+{
+    std::string line2 = "1 40141U 14052A   14277.84589631 -.00000387"
+            "  00000-0  10000-3 0   362";
+    std::string line3 = "2 40141   0.0409 337.4123 0002696 277.4110"
+            " 182.9520  1.00272844   312";
+    Node node(line2, line3);
+    node.set_e(0.7);
+    Propagator propagator(node);
+
+    double start = node.preciseEpoch() - 3600;
+    double stop = start + 86400 * 2;
+    double step = 60;
+    std::size_t count = Propagator::samples(start, stop, step);
+    ASSERT_EQ(2 * 1440 + 1, count);
+    EXPECT_EQ(0, Propagator::samples(stop, start, step));
+    EXPECT_EQ(1, Propagator::samples(start, start, step));
+
+    std::vector<double> x(count), y(count), z(count);
+    std::vector<double> vx(count), vy(count), vz(count);
+    EXPECT_EQ(count, propagator.ephemeris(start, stop, step,
+                                          &x[0], &y[0], &z[0],
+                                          &vx[0], &vy[0], &vz[0]));
+
+    for (std::size_t k = 0; k < count; ++k)
+    {
+        double r[3], v[3];
+        propagator.state(start + k * step, r, v);
+        EXPECT_NEAR(r[0], x[k], 1e-3);
+        EXPECT_NEAR(r[1], y[k], 1e-3);
+        EXPECT_NEAR(r[2], z[k], 1e-3);
+        EXPECT_NEAR(v[0], vx[k], 1e-6);
+        EXPECT_NEAR(v[1], vy[k], 1e-6);
+        EXPECT_NEAR(v[2], vz[k], 1e-6);
+    }
+}
+//------------------------------------------------------------------------------
+
+TEST(PropagatorTest, dataSetEphemeris)
+{
+    Node node1 = mirNode();
+    Node node2(node1);
+    node2.setPreciseEpoch(node1.preciseEpoch() + 86400);
+    node2.set_M(90);
+
+    DataSet dataSet;
+    dataSet.append(node1);
+    dataSet.append(node2);
+
+    double start = node1.preciseEpoch();
+    double step = 600;
+    std::size_t count = Propagator::samples(start, start + 2 * 86400, step);
+    std::vector<double> x(count), y(count), z(count);
+    EXPECT_EQ(count, ephemeris(dataSet, start, start + 2 * 86400, step,
+                               &x[0], &y[0], &z[0]));
+
+    Propagator propagator1(node1);
+    Propagator propagator2(node2);
+    for (std::size_t k = 0; k < count; ++k)
+    {
+        double t = start + k * step;
+        double r[3];
+        if (t - node1.preciseEpoch() < node2.preciseEpoch() - t)
+            propagator1.state(t, r);
+        else
+            propagator2.state(t, r);
+        EXPECT_NEAR(r[0], x[k], 1e-3);
+        EXPECT_NEAR(r[1], y[k], 1e-3);
+        EXPECT_NEAR(r[2], z[k], 1e-3);
+    }
+
+    EXPECT_EQ(0, ephemeris(DataSet(), start, start + 86400, step,
+                           &x[0], &y[0], &z[0]));
+
+    // Fractional times around the switch of the nodes and the blending
+    // give the same states as DataSet::stateAt()
+    start = (node1.preciseEpoch() + node2.preciseEpoch()) / 2 - 2;
+    step = 0.25;
+    for (int mode = 0; mode < 2; ++mode)
+    {
+        dataSet.setInterpolation(DataSet::Interpolation(mode));
+        std::vector<double> vx(count), vy(count), vz(count);
+        ASSERT_EQ(17u, ephemeris(dataSet, start, start + 4, step, &x[0],
+                                 &y[0], &z[0], &vx[0], &vy[0], &vz[0]));
+        for (std::size_t k = 0; k < 17; ++k)
+        {
+            double r[3], v[3];
+            dataSet.stateAt(start + k * step, r, v);
+            EXPECT_EQ(r[0], x[k]);
+            EXPECT_EQ(r[1], y[k]);
+            EXPECT_EQ(r[2], z[k]);
+            EXPECT_EQ(v[0], vx[k]);
+            EXPECT_EQ(v[1], vy[k]);
+            EXPECT_EQ(v[2], vz[k]);
+        }
+    }
+}
+//------------------------------------------------------------------------------
+
+TEST(PropagatorTest, singlePrecision)
+{
+    Node node = mirNode();
+
+    // Low, highly elliptical and geostationary orbits
+    std::vector<Node> nodes(3, node);
+    setMolniya(nodes[1]);
+    setGeostationary(nodes[2]);
+
+    const double t0 = node.preciseEpoch();
+    const std::size_t count = 2000;
+    const double step = 60;
+    for (std::size_t k = 0; k < nodes.size(); ++k)
+    {
+        Propagator propagator(nodes[k]);
+        FloatPropagator floatPropagator(nodes[k]);
+
+        std::vector<double> x(count), y(count), z(count);
+        std::vector<double> vx(count), vy(count), vz(count);
+        std::vector<float> xf(count), yf(count), zf(count);
+        std::vector<float> vxf(count), vyf(count), vzf(count);
+        propagator.propagate(t0, step, count, &x[0], &y[0], &z[0],
+                             &vx[0], &vy[0], &vz[0]);
+        floatPropagator.propagate(t0, step, count, &xf[0], &yf[0], &zf[0],
+                                  &vxf[0], &vyf[0], &vzf[0]);
+
+        double apogee = 0, maxSpeed = 0;
+        for (std::size_t j = 0; j < count; ++j)
+        {
+            apogee = std::max(apogee, sqrt(x[j] * x[j] + y[j] * y[j]
+                                           + z[j] * z[j]));
+            maxSpeed = std::max(maxSpeed, sqrt(vx[j] * vx[j] + vy[j] * vy[j]
+                                               + vz[j] * vz[j]));
+        }
+
+        // Documented bounds: 1e-6 of the apogee radius and 3e-6 of the
+        // maximal speed
+        const double bound = 1e-6 * apogee;
+        const double velocityBound = 3e-6 * maxSpeed;
+        for (std::size_t j = 0; j < count; ++j)
+        {
+            double dr = sqrt((xf[j] - x[j]) * (xf[j] - x[j])
+                             + (yf[j] - y[j]) * (yf[j] - y[j])
+                             + (zf[j] - z[j]) * (zf[j] - z[j]));
+            double dv = sqrt((vxf[j] - vx[j]) * (vxf[j] - vx[j])
+                             + (vyf[j] - vy[j]) * (vyf[j] - vy[j])
+                             + (vzf[j] - vz[j]) * (vzf[j] - vz[j]));
+            EXPECT_LT(dr, bound);
+            EXPECT_LT(dv, velocityBound);
+
+            float position[3];
+            floatPropagator.state(t0 + j * step, position);
+            EXPECT_NEAR(x[j], position[0], bound);
+            EXPECT_NEAR(z[j], position[2], bound);
+        }
+    }
+}
+//------------------------------------------------------------------------------
+
+TEST(PropagatorTest, j2SecularRates)
+{
+    Node node = mirNode();
+
+    Propagator twoBody(node);
+    EXPECT_EQ(TwoBody, twoBody.orbitModel());
+    EXPECT_EQ(0., twoBody.OmegaRate());
+    EXPECT_EQ(0., twoBody.omegaRate());
+    EXPECT_DOUBLE_EQ(node.n(), twoBody.meanAnomalyRate());
+
+    // Sun-synchronous orbit at 700 km: the node follows the mean Sun
+    double a = 7078e3;
+    node.set_n(sqrt(GM / (a * a * a)));
+    node.set_e(0.001);
+    node.set_i(98.19);
+    Propagator secular(node, AccurateMath, J2Secular);
+    const double sunRate = 2 * M_PI / (365.2422 * 86400);
+    EXPECT_NEAR(sunRate, secular.OmegaRate(), 0.01 * sunRate);
+    EXPECT_LT(secular.omegaRate(), 0);
+
+    // Critical inclination: the perigee does not rotate
+    node.set_i(63.4349);
+    secular.assign(node);
+    EXPECT_NEAR(0., secular.omegaRate(), 1e-4 * fabs(secular.OmegaRate()));
+    EXPECT_LT(secular.OmegaRate(), 0);
+
+    // Switching the model back restores the two-body orbit
+    secular.setOrbitModel(TwoBody);
+    twoBody.assign(node);
+    double r0[3], r1[3];
+    double t = node.preciseEpoch() + 86400;
+    secular.state(t, r0);
+    twoBody.state(t, r1);
+    for (int k = 0; k < 3; ++k)
+        EXPECT_EQ(r1[k], r0[k]);
+}
+//------------------------------------------------------------------------------
+
+TEST(PropagatorTest, j2SecularState)
+{
+    Node node = mirNode();
+
+    std::vector<Node> nodes(3, node);
+    setMolniya(nodes[1]);
+    setGeostationary(nodes[2]);
+
+    const double t0 = node.preciseEpoch();
+    for (std::size_t j = 0; j < nodes.size(); ++j)
+    {
+        Propagator propagator(nodes[j], AccurateMath, J2Secular);
+        Propagator twoBody(nodes[j]);
+
+        // The epoch state is the one of the two-body orbit
+        double r[3], v[3], r1[3], v1[3];
+        propagator.state(t0, r, v);
+        twoBody.state(t0, r1);
+        for (int k = 0; k < 3; ++k)
+            EXPECT_NEAR(r1[k], r[k], 1e-6);
+
+        // After the drift the position is the one of the two-body orbit
+        // with the drifted elements at the epoch
+        double dt = 10 * 86400;
+        Node drifted = nodes[j];
+        drifted.setPreciseEpoch(t0 + dt);
+        drifted.set_Omega(rad2deg(nodes[j].Omega()
+                                  + propagator.OmegaRate() * dt));
+        drifted.set_omega(rad2deg(nodes[j].omega()
+                                  + propagator.omegaRate() * dt));
+        drifted.set_M(rad2deg(propagator.meanAnomaly(t0 + dt)));
+        propagator.state(t0 + dt, r, v);
+        Propagator(drifted).state(t0 + dt, r1);
+        for (int k = 0; k < 3; ++k)
+            EXPECT_NEAR(r1[k], r[k], 1e-3);
+
+        // The velocity is the derivative of the position
+        const double step = 0.5;
+        propagator.state(t0 + dt - step, r, 0);
+        propagator.state(t0 + dt + step, r1, 0);
+        propagator.state(t0 + dt, v1, v);
+        for (int k = 0; k < 3; ++k)
+            EXPECT_NEAR((r1[k] - r[k]) / (2 * step), v[k], 2e-3);
+
+        // The grid matches the single states
+        const std::size_t count = 500;
+        const double gridStep = 97;
+        std::vector<double> x(count), y(count), z(count);
+        std::vector<double> vx(count), vy(count), vz(count);
+        propagator.propagate(t0, gridStep, count, &x[0], &y[0], &z[0],
+                             &vx[0], &vy[0], &vz[0]);
+        for (std::size_t k = 0; k < count; ++k)
+        {
+            propagator.state(t0 + k * gridStep, r, v);
+            EXPECT_NEAR(r[0], x[k], 1e-3);
+            EXPECT_NEAR(r[1], y[k], 1e-3);
+            EXPECT_NEAR(r[2], z[k], 1e-3);
+            EXPECT_NEAR(v[0], vx[k], 1e-6);
+            EXPECT_NEAR(v[2], vz[k], 1e-6);
+        }
+
+        // Fast math and single precision use the same model
+        FloatPropagator floatPropagator(nodes[j], FastMath, J2Secular);
+        float rf[3];
+        floatPropagator.state(t0 + dt, rf);
+        propagator.state(t0 + dt, r);
+        double radius = sqrt(r[0] * r[0] + r[1] * r[1] + r[2] * r[2]);
+        for (int k = 0; k < 3; ++k)
+            EXPECT_NEAR(r[k], rf[k], 1e-6 * radius * 2);
+    }
+}
+//------------------------------------------------------------------------------
@@ -0,0 +1,154 @@
+/*-----------------------------------------------------------------------------+
+ | QuickTle                                                                    |
+ | Copyright 2011-2015 Sergei Fundaev                                          |
+ +-----------------------------------------------------------------------------+
+ | This file is part of QuickTle library.                                      |
+ |                                                                             |
+ | QuickTle is free software: you can redistribute it and/or modify            |
+ | it under the terms of the GNU Lesser General Public License as published by |
+ | the Free Software Foundation, either version 3 of the License, or           |
+ | (at your option) any later version.                                         |
+ |                                                                             |
+ | QuickTle is distributed in the hope that it will be useful,                 |
+ | but WITHOUT ANY WARRANTY; without even the implied warranty of              |
+ | MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               |
+ | GNU Lesser General Public License for more details.                         |
+ |                                                                             |
+ | You should have received a copy of the GNU Lesser General Public License    |
+ | along with QuickTle. If not, see <http://www.gnu.org/licenses/>.            |
+ +----------------------------------------------------------------------------*/
+
+#include <cmath>
+#include <algorithm>
+#include <vector>
+#include <gtest/gtest.h>
+#include <quicktle/node.h>
+#include <quicktle/regimeindex.h>
+#include "test_catalogs.h"
+
+#define EARTH_RADIUS 6378137.
+
+using namespace quicktle;
+
+//
+//---- TESTS -------------------------------------------------------------------
+
+//! Compare the queries of the index with the scan of the catalog
+static void checkRegimeQueries(const RegimeIndex &index,
+                               const std::vector<Node> &catalog)
+{
+    ASSERT_EQ(catalog.size(), index.size());
+    for (std::size_t k = 0; k < catalog.size(); ++k)
+    {
+        double a = catalog[k].a();
+        EXPECT_NEAR(a * (1 - catalog[k].e()) - EARTH_RADIUS,
+                    index.perigee(k), 1e-6);
+        EXPECT_NEAR(a * (1 + catalog[k].e()) - EARTH_RADIUS,
+                    index.apogee(k), 1e-6);
+        EXPECT_DOUBLE_EQ(catalog[k].i(), index.inclination(k));
+    }
+
+    const double bands[][2] = {
+        {300e3, 500e3}, {550e3, 550e3}, {1000e3, 1200e3}, {20000e3, 20000e3},
+        {35786e3, 36000e3}, {-1e9, 1e9}, {1e9, 2e9}
+    };
+    std::vector<std::size_t> result;
+    for (const double *band : bands)
+    {
+        for (int inclined = 0; inclined < 2; ++inclined)
+        {
+            double minInclination = inclined ? 50 * M_PI / 180 : 0;
+            double maxInclination = inclined ? 100 * M_PI / 180 : M_PI;
+            std::vector<std::size_t> expected;
+            for (std::size_t k = 0; k < catalog.size(); ++k)
+            {
+                if (index.perigee(k) <= band[1]
+                    && index.apogee(k) >= band[0]
+                    && catalog[k].i() >= minInclination
+                    && catalog[k].i() <= maxInclination)
+                {
+                    expected.push_back(k);
+                }
+            }
+
+            if (inclined)
+            {
+                index.overlapping(band[0], band[1], minInclination,
+                                  maxInclination, result);
+            }
+            else
+            {
+                index.overlapping(band[0], band[1], result);
+            }
+            std::sort(result.begin(), result.end());
+            EXPECT_EQ(expected, result);
+
+            if (band[0] == band[1])
+            {
+                if (inclined)
+                {
+                    index.containing(band[0], minInclination, maxInclination,
+                                     result);
+                }
+                else
+                {
+                    index.containing(band[0], result);
+                }
+                std::sort(result.begin(), result.end());
+                EXPECT_EQ(expected, result);
+            }
+        }
+    }
+}
+//------------------------------------------------------------------------------
+
+TEST(RegimeIndexTest, queries)
+{
+    Node node = mirNode();
+
+    // Low, medium, highly elliptical and geostationary orbits
+    std::vector<Node> catalog(1000, node);
+    for (std::size_t k = 0; k < catalog.size(); ++k)
+    {
+        catalog[k].set_i((k * 37) % 180);
+        switch (k % 4)
+        {
+        case 0:
+            catalog[k].set_n(2 * M_PI / (5400. + 3 * k));
+            catalog[k].set_e(0.0001 * (k % 50));
+            break;
+        case 1:
+            catalog[k].set_n(2 * M_PI / 43082.);
+            catalog[k].set_e(0.01);
+            break;
+        case 2:
+            catalog[k].set_n(2 * M_PI / 43082.);
+            catalog[k].set_e(0.5 + 0.0002 * k);
+            break;
+        default:
+            catalog[k].set_n(2 * M_PI / 86164.);
+            catalog[k].set_e(0.0002);
+        }
+    }
+
+    RegimeIndex index(catalog);
+    checkRegimeQueries(index, catalog);
+
+    // Updates, which keep the order of the perigees and which move them
+    for (std::size_t k = 0; k < catalog.size(); k += 7)
+    {
+        if (k % 2)
+            catalog[k].set_e(catalog[k].e() * 1.0000001);
+        else
+            catalog[k].set_n(2 * M_PI / (5500. + k));
+        catalog[k].set_i(fmod(catalog[k].i() * 180 / M_PI + 13, 180));
+        index.update(k, catalog[k]);
+    }
+    checkRegimeQueries(index, catalog);
+
+    RegimeIndex empty;
+    std::vector<std::size_t> result(1, 0);
+    empty.overlapping(0, 1e9, result);
+    EXPECT_TRUE(result.empty());
+}
+//------------------------------------------------------------------------------
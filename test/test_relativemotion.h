@@ -0,0 +1,98 @@
+/*-----------------------------------------------------------------------------+
+ | QuickTle                                                                    |
+ | Copyright 2011-2015 Sergei Fundaev                                          |
+ +-----------------------------------------------------------------------------+
+ | This file is part of QuickTle library.                                      |
+ |                                                                             |
+ | QuickTle is free software: you can redistribute it and/or modify            |
+ | it under the terms of the GNU Lesser General Public License as published by |
+ | the Free Software Foundation, either version 3 of the License, or           |
+ | (at your option) any later version.                                         |
+ |                                                                             |
+ | QuickTle is distributed in the hope that it will be useful,                 |
+ | but WITHOUT ANY WARRANTY; without even the implied warranty of              |
+ | MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               |
+ | GNU Lesser General Public License for more details.                         |
+ |                                                                             |
+ | You should have received a copy of the GNU Lesser General Public License    |
+ | along with QuickTle. If not, see <http://www.gnu.org/licenses/>.            |
+ +----------------------------------------------------------------------------*/
+
+#include <cmath>
+#include <vector>
+#include <gtest/gtest.h>
+#include <quicktle/node.h>
+#include <quicktle/propagator.h>
+#include <quicktle/relativemotion.h>
+#include "test_catalogs.h"
+
+using namespace quicktle;
+
+//
+//---- TESTS -------------------------------------------------------------------
+
+TEST(RelativeMotionTest, ric)
+{
+    Node primary = mirNode();
+
+    // Leading, radially offset and out-of-plane neighbours
+    std::vector<Node> secondaries(4, primary);
+    secondaries[0].set_M(196.0076 + 0.1);
+    secondaries[1].set_e(0.0022107);
+    secondaries[2].set_i(51.7129);
+    setMolniya(secondaries[3]);
+
+    const double start = primary.preciseEpoch();
+    const double step = 10;
+    const std::size_t count = 700;
+    std::vector<double> positions(3 * secondaries.size() * count);
+    std::vector<double> velocities(positions.size());
+    relativeMotion(primary, secondaries, start, step, count,
+                   &positions[0], &velocities[0]);
+
+    // In-track offset of the leading neighbour
+    const double a = primary.a();
+    EXPECT_NEAR(0, positions[0], 1e-3 * a);
+    EXPECT_NEAR(0, positions[2], 1e-6 * a);
+    EXPECT_GT(positions[1], 0);
+
+    const Propagator propagator(primary);
+    for (std::size_t k = 0; k < secondaries.size(); ++k)
+    {
+        const Propagator other(secondaries[k]);
+        for (std::size_t j = 0; j < count; j += 7)
+        {
+            double t = start + j * step;
+            double rp[3], vp[3], rs[3];
+            propagator.state(t, rp, vp);
+            other.state(t, rs);
+
+            // Distance is preserved by the rotation
+            const double *rho = &positions[3 * (k * count + j)];
+            double d = sqrt(pow(rs[0] - rp[0], 2) + pow(rs[1] - rp[1], 2) +
+                            pow(rs[2] - rp[2], 2));
+            EXPECT_NEAR(d, sqrt(rho[0] * rho[0] + rho[1] * rho[1] +
+                                rho[2] * rho[2]), 1e-6 * d + 1e-6);
+
+            // Radial component is the projection on the primary position
+            double r = sqrt(rp[0] * rp[0] + rp[1] * rp[1] + rp[2] * rp[2]);
+            double radial = ((rs[0] - rp[0]) * rp[0] + (rs[1] - rp[1]) * rp[1] +
+                             (rs[2] - rp[2]) * rp[2]) / r;
+            EXPECT_NEAR(radial, rho[0], 1e-6 * d + 1e-6);
+
+            // Velocity in the rotating frame is the derivative of position
+            if (j == 0 || j + 1 == count)
+                continue;
+            const double *before = &positions[3 * (k * count + j - 1)];
+            const double *after = &positions[3 * (k * count + j + 1)];
+            const double *v = &velocities[3 * (k * count + j)];
+            double scale = sqrt(v[0] * v[0] + v[1] * v[1] + v[2] * v[2]);
+            for (int i = 0; i < 3; ++i)
+            {
+                EXPECT_NEAR((after[i] - before[i]) / (2 * step), v[i],
+                            1e-3 * scale + 1e-3);
+            }
+        }
+    }
+}
+//------------------------------------------------------------------------------
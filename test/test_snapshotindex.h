@@ -0,0 +1,128 @@
+/*-----------------------------------------------------------------------------+
+ | QuickTle                                                                    |
+ | Copyright 2011-2015 Sergei Fundaev                                          |
+ +-----------------------------------------------------------------------------+
+ | This file is part of QuickTle library.                                      |
+ |                                                                             |
+ | QuickTle is free software: you can redistribute it and/or modify            |
+ | it under the terms of the GNU Lesser General Public License as published by |
+ | the Free Software Foundation, either version 3 of the License, or           |
+ | (at your option) any later version.                                         |
+ |                                                                             |
+ | QuickTle is distributed in the hope that it will be useful,                 |
+ | but WITHOUT ANY WARRANTY; without even the implied warranty of              |
+ | MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               |
+ | GNU Lesser General Public License for more details.                         |
+ |                                                                             |
+ | You should have received a copy of the GNU Lesser General Public License    |
+ | along with QuickTle. If not, see <http://www.gnu.org/licenses/>.            |
+ +----------------------------------------------------------------------------*/
+
+#include <cmath>
+#include <algorithm>
+#include <vector>
+#include <gtest/gtest.h>
+#include <quicktle/node.h>
+#include <quicktle/snapshotindex.h>
+#include "test_catalogs.h"
+
+using namespace quicktle;
+
+//
+//---- TESTS -------------------------------------------------------------------
+
+TEST(SnapshotIndexTest, queries)
+{
+    Node node = mirNode();
+
+    std::vector<Node> catalog(3000, node);
+    for (std::size_t k = 0; k < catalog.size(); ++k)
+    {
+        catalog[k].set_M(k * 7.3);
+        catalog[k].set_Omega(k * 13.1);
+        catalog[k].set_i(k % 170 + 5);
+        catalog[k].set_n(2 * M_PI / (5400 + k % 37 * 600));
+    }
+
+    SnapshotIndex index(catalog);
+    EXPECT_EQ(catalog.size(), index.size());
+    index.setThreads(2);
+
+    double center[3] = {0, 6e6, 3e6};
+    double axis[3] = {1, 1, 0};
+    double lower[3] = {-2e6, 1e6, -4e6};
+    double upper[3] = {3e6, 7e6, 2e6};
+
+    // Brute force check of all kinds of queries
+    auto check = [&]()
+    {
+        std::vector<std::size_t> result, expected;
+        index.radius(center, 3e6, result);
+        for (std::size_t k = 0; k < catalog.size(); ++k)
+        {
+            const double *p = index.position(k);
+            if (pow(p[0] - center[0], 2) + pow(p[1] - center[1], 2) +
+                pow(p[2] - center[2], 2) <= 9e12)
+            {
+                expected.push_back(k);
+            }
+        }
+        std::sort(result.begin(), result.end());
+        EXPECT_FALSE(expected.empty());
+        EXPECT_EQ(expected, result);
+
+        expected.clear();
+        index.cone(center, axis, 0.4, 6e6, result);
+        for (std::size_t k = 0; k < catalog.size(); ++k)
+        {
+            const double *p = index.position(k);
+            double d[3] = {p[0] - center[0], p[1] - center[1],
+                           p[2] - center[2]};
+            double distance = sqrt(d[0] * d[0] + d[1] * d[1] + d[2] * d[2]);
+            double angle = acos((d[0] + d[1]) / sqrt(2.) / distance);
+            if (distance <= 6e6 && angle <= 0.4)
+                expected.push_back(k);
+        }
+        std::sort(result.begin(), result.end());
+        EXPECT_FALSE(expected.empty());
+        EXPECT_EQ(expected, result);
+
+        expected.clear();
+        index.box(lower, upper, result);
+        for (std::size_t k = 0; k < catalog.size(); ++k)
+        {
+            const double *p = index.position(k);
+            bool inside = true;
+            for (int i = 0; i < 3; ++i)
+                inside = inside && p[i] >= lower[i] && p[i] <= upper[i];
+            if (inside)
+                expected.push_back(k);
+        }
+        std::sort(result.begin(), result.end());
+        EXPECT_FALSE(expected.empty());
+        EXPECT_EQ(expected, result);
+    };
+
+    const double t = node.preciseEpoch();
+    index.update(t);
+    EXPECT_EQ(t, index.time());
+    double r[3];
+    Propagator(catalog[17]).state(t, r);
+    for (int i = 0; i < 3; ++i)
+        EXPECT_EQ(r[i], index.position(17)[i]);
+    check();
+
+    // Incremental updates
+    for (int step = 1; step <= 5; ++step)
+    {
+        index.update(t + 60 * step);
+        check();
+    }
+
+    // Fine and coarse grids
+    index.setCellSize(50e3);
+    check();
+    index.setCellSize(1e8);
+    check();
+}
+//------------------------------------------------------------------------------
@@ -0,0 +1,87 @@
+/*-----------------------------------------------------------------------------+
+ | QuickTle                                                                    |
+ | Copyright 2011-2015 Sergei Fundaev                                          |
+ +-----------------------------------------------------------------------------+
+ | This file is part of QuickTle library.                                      |
+ |                                                                             |
+ | QuickTle is free software: you can redistribute it and/or modify            |
+ | it under the terms of the GNU Lesser General Public License as published by |
+ | the Free Software Foundation, either version 3 of the License, or           |
+ | (at your option) any later version.                                         |
+ |                                                                             |
+ | QuickTle is distributed in the hope that it will be useful,                 |
+ | but WITHOUT ANY WARRANTY; without even the implied warranty of              |
+ | MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               |
+ | GNU Lesser General Public License for more details.                         |
+ |                                                                             |
+ | You should have received a copy of the GNU Lesser General Public License    |
+ | along with QuickTle. If not, see <http://www.gnu.org/licenses/>.            |
+ +----------------------------------------------------------------------------*/
+
+#include <cmath>
+#include <gtest/gtest.h>
+#include <quicktle/station.h>
+#include <quicktle/coordinates.h>
+#include <quicktle/func.h>
+
+using namespace quicktle;
+
+//
+//---- TESTS -------------------------------------------------------------------
+
+TEST(StationTest, basis)
+{
+    Station station(deg2rad(55.75), deg2rad(37.62), 150, deg2rad(5));
+    EXPECT_DOUBLE_EQ(deg2rad(55.75), station.latitude());
+    EXPECT_DOUBLE_EQ(deg2rad(37.62), station.longitude());
+    EXPECT_DOUBLE_EQ(150, station.altitude());
+    EXPECT_DOUBLE_EQ(deg2rad(5), station.minElevation());
+
+    double ecef[3];
+    geodetic2ecef(station.latitude(), station.longitude(), 150, ecef);
+    for (int k = 0; k < 3; ++k)
+        EXPECT_DOUBLE_EQ(ecef[k], station.position()[k]);
+
+    const double *e = station.east();
+    const double *n = station.north();
+    const double *u = station.up();
+    EXPECT_NEAR(0, e[0] * n[0] + e[1] * n[1] + e[2] * n[2], 1e-15);
+    EXPECT_NEAR(0, e[0] * u[0] + e[1] * u[1] + e[2] * u[2], 1e-15);
+    EXPECT_NEAR(0, n[0] * u[0] + n[1] * u[1] + n[2] * u[2], 1e-15);
+    // Right-handed basis: east x north = up
+    EXPECT_NEAR(u[0], e[1] * n[2] - e[2] * n[1], 1e-15);
+    EXPECT_NEAR(u[1], e[2] * n[0] - e[0] * n[2], 1e-15);
+    EXPECT_NEAR(u[2], e[0] * n[1] - e[1] * n[0], 1e-15);
+}
+//------------------------------------------------------------------------------
+
+TEST(StationTest, lookAngles)
+{
+    Station station(deg2rad(30), deg2rad(-60));
+    double azimuth, elevation, range;
+
+    // Zenith
+    double point[3];
+    geodetic2ecef(deg2rad(30), deg2rad(-60), 500e3, point);
+    station.lookAngles(point, azimuth, elevation, range);
+    EXPECT_NEAR(M_PI_2, elevation, 1e-9);
+    EXPECT_NEAR(500e3, range, 1e-6);
+    EXPECT_DOUBLE_EQ(elevation, station.elevation(point));
+
+    // North and east at the horizon level
+    const double *p = station.position();
+    const double *n = station.north();
+    const double *e = station.east();
+    for (int k = 0; k < 3; ++k)
+        point[k] = p[k] + 1000 * n[k];
+    station.lookAngles(point, azimuth, elevation, range);
+    EXPECT_NEAR(0, azimuth, 1e-12);
+    EXPECT_NEAR(0, elevation, 1e-12);
+    EXPECT_NEAR(1000, range, 1e-9);
+
+    for (int k = 0; k < 3; ++k)
+        point[k] = p[k] - 1000 * e[k];
+    station.lookAngles(point, azimuth, elevation, range);
+    EXPECT_NEAR(3 * M_PI_2, azimuth, 1e-12);
+}
+//------------------------------------------------------------------------------
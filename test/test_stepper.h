@@ -0,0 +1,154 @@
+/*-----------------------------------------------------------------------------+
+ | QuickTle                                                                    |
+ | Copyright 2011-2015 Sergei Fundaev                                          |
+ +-----------------------------------------------------------------------------+
+ | This file is part of QuickTle library.                                      |
+ |                                                                             |
+ | QuickTle is free software: you can redistribute it and/or modify            |
+ | it under the terms of the GNU Lesser General Public License as published by |
+ | the Free Software Foundation, either version 3 of the License, or           |
+ | (at your option) any later version.                                         |
+ |                                                                             |
+ | QuickTle is distributed in the hope that it will be useful,                 |
+ | but WITHOUT ANY WARRANTY; without even the implied warranty of              |
+ | MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               |
+ | GNU Lesser General Public License for more details.                         |
+ |                                                                             |
+ | You should have received a copy of the GNU Lesser General Public License    |
+ | along with QuickTle. If not, see <http://www.gnu.org/licenses/>.            |
+ +----------------------------------------------------------------------------*/
+
+#include <cmath>
+#include <set>
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+#include <quicktle/node.h>
+#include <quicktle/propagator.h>
+#include <quicktle/stepper.h>
+#include "test_catalogs.h"
+
+using namespace quicktle;
+
+//
+//---- TESTS -------------------------------------------------------------------
+
+TEST(CatalogStepperTest, ticks)
+{
+    std::vector<Node> catalog = mixedCatalog(300);
+    const double start = catalog[0].preciseEpoch() + 1000;
+    const double step = 10;
+    CatalogStepper stepper(catalog, start, step);
+    EXPECT_EQ(catalog.size(), stepper.size());
+    EXPECT_EQ(0u, stepper.tick());
+    EXPECT_EQ(start, stepper.time());
+
+    std::vector<Propagator> propagators(catalog.begin(), catalog.end());
+    for (int tick = 0; tick <= 2000; ++tick)
+    {
+        if (tick)
+            stepper.advance();
+        if (tick % 250)
+            continue;
+
+        CatalogStepper::Snapshot snapshot = stepper.snapshot();
+        EXPECT_EQ(static_cast<std::uint64_t>(tick), snapshot.tick);
+        EXPECT_DOUBLE_EQ(start + tick * step, snapshot.t);
+        for (std::size_t k = 0; k < catalog.size(); ++k)
+        {
+            double r[3];
+            propagators[k].state(snapshot.t, r);
+            EXPECT_NEAR(r[0], snapshot.x[k], 1e-3);
+            EXPECT_NEAR(r[1], snapshot.y[k], 1e-3);
+            EXPECT_NEAR(r[2], snapshot.z[k], 1e-3);
+        }
+        stepper.release(snapshot);
+    }
+
+    // The new step applies from the next tick
+    double t = stepper.time();
+    stepper.setStep(3600);
+    stepper.setThreads(2);
+    stepper.advance();
+    stepper.advance();
+    EXPECT_DOUBLE_EQ(t + 7200, stepper.time());
+    CatalogStepper::Snapshot snapshot = stepper.snapshot();
+    for (std::size_t k = 0; k < catalog.size(); ++k)
+    {
+        double r[3];
+        propagators[k].state(snapshot.t, r);
+        EXPECT_NEAR(r[0], snapshot.x[k], 1e-3);
+        EXPECT_NEAR(r[2], snapshot.z[k], 1e-3);
+    }
+    stepper.release(snapshot);
+
+    CatalogStepper empty;
+    EXPECT_EQ(0u, empty.size());
+    empty.advance();
+    EXPECT_EQ(1u, empty.tick());
+    snapshot = empty.snapshot();
+    EXPECT_EQ(0, snapshot.x);
+    empty.release(snapshot);
+}
+//------------------------------------------------------------------------------
+
+TEST(CatalogStepperTest, heldSnapshot)
+{
+    std::vector<Node> catalog = mixedCatalog(100);
+    CatalogStepper stepper(catalog, catalog[0].preciseEpoch(), 60);
+
+    // The held buffer is not overwritten by the following ticks
+    CatalogStepper::Snapshot held = stepper.snapshot();
+    std::vector<double> x(held.x, held.x + catalog.size());
+    for (int tick = 0; tick < 10; ++tick)
+    {
+        stepper.advance();
+        CatalogStepper::Snapshot snapshot = stepper.snapshot();
+        EXPECT_NE(held.x, snapshot.x);
+        stepper.release(snapshot);
+    }
+    EXPECT_EQ(0u, held.tick);
+    for (std::size_t k = 0; k < catalog.size(); ++k)
+        EXPECT_EQ(x[k], held.x[k]);
+
+    // The released buffers are reused: the ticks alternate between two
+    stepper.release(held);
+    std::set<const double*> buffers;
+    for (int tick = 0; tick < 10; ++tick)
+    {
+        stepper.advance();
+        CatalogStepper::Snapshot snapshot = stepper.snapshot();
+        buffers.insert(snapshot.x);
+        stepper.release(snapshot);
+    }
+    EXPECT_EQ(2u, buffers.size());
+
+    // Reader in other thread: each snapshot is exact, however long it is
+    // held
+    std::vector<Propagator> propagators(catalog.begin(), catalog.end());
+    std::atomic<bool> done(false);
+    std::size_t checked = 0, failed = 0;
+    std::thread reader([&]()
+    {
+        while (!done.load())
+        {
+            CatalogStepper::Snapshot s = stepper.snapshot();
+            for (std::size_t k = s.tick % 7; k < catalog.size(); k += 7)
+            {
+                double r[3];
+                propagators[k].state(s.t, r);
+                ++checked;
+                if (fabs(r[0] - s.x[k]) > 1e-3 || fabs(r[2] - s.z[k]) > 1e-3)
+                    ++failed;
+            }
+            stepper.release(s);
+        }
+    });
+    for (int tick = 0; tick < 2000; ++tick)
+        stepper.advance();
+    done.store(true);
+    reader.join();
+    EXPECT_LT(0u, checked);
+    EXPECT_EQ(0u, failed);
+}
+//------------------------------------------------------------------------------
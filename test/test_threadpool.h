@@ -0,0 +1,155 @@
+/*-----------------------------------------------------------------------------+
+ | QuickTle                                                                    |
+ | Copyright 2011-2015 Sergei Fundaev                                          |
+ +-----------------------------------------------------------------------------+
+ | This file is part of QuickTle library.                                      |
+ |                                                                             |
+ | QuickTle is free software: you can redistribute it and/or modify            |
+ | it under the terms of the GNU Lesser General Public License as published by |
+ | the Free Software Foundation, either version 3 of the License, or           |
+ | (at your option) any later version.                                         |
+ |                                                                             |
+ | QuickTle is distributed in the hope that it will be useful,                 |
+ | but WITHOUT ANY WARRANTY; without even the implied warranty of              |
+ | MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               |
+ | GNU Lesser General Public License for more details.                         |
+ |                                                                             |
+ | You should have received a copy of the GNU Lesser General Public License    |
+ | along with QuickTle. If not, see <http://www.gnu.org/licenses/>.            |
+ +----------------------------------------------------------------------------*/
+
+
+#include <vector>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <gtest/gtest.h>
+#include <quicktle/node.h>
+#include <quicktle/propagator.h>
+#include <quicktle/threadpool.h>
+#include "test_catalogs.h"
+
+using namespace quicktle;
+
+//
+//---- TESTS -------------------------------------------------------------------
+
+TEST(ThreadPoolTest, parallelFor)
+{
+    ThreadPool pool(4);
+    EXPECT_EQ(4u, pool.size());
+
+    // Each index is processed exactly once
+    const std::size_t count = 10007;
+    std::vector<int> hits(count, 0);
+    pool.parallelFor(count, 13, [&](std::size_t first, std::size_t last)
+    {
+        EXPECT_LE(last - first, 13u);
+        for (std::size_t k = first; k < last; ++k)
+            ++hits[k];
+    });
+    for (std::size_t k = 0; k < count; ++k)
+        EXPECT_EQ(1, hits[k]);
+
+    pool.parallelFor(0, 1, [](std::size_t, std::size_t)
+    {
+        FAIL();
+    });
+
+    // Nested call runs in the calling thread
+    std::atomic<std::size_t> total(0);
+    pool.parallelFor(8, 1, [&](std::size_t, std::size_t)
+    {
+        pool.parallelFor(100, 10, [&](std::size_t first, std::size_t last)
+        {
+            total += last - first;
+        });
+    });
+    EXPECT_EQ(800u, total);
+}
+//------------------------------------------------------------------------------
+
+TEST(ThreadPoolTest, workers)
+{
+    ThreadPool pool(4);
+
+    // No more than two threads run the limited task at once
+    const std::size_t count = 1000;
+    std::vector<int> hits(count, 0);
+    std::atomic<int> running(0), peak(0);
+    pool.parallelFor(count, 7, [&](std::size_t first, std::size_t last)
+    {
+        int now = ++running;
+        int seen = peak;
+        while (now > seen && !peak.compare_exchange_weak(seen, now))
+            ;
+        for (std::size_t k = first; k < last; ++k)
+            ++hits[k];
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+        --running;
+    }, 2);
+    EXPECT_LE(peak, 2);
+    for (std::size_t k = 0; k < count; ++k)
+        EXPECT_EQ(1, hits[k]);
+
+    // The single worker is the calling thread
+    std::thread::id caller = std::this_thread::get_id();
+    pool.parallelFor(count, 7, [&](std::size_t, std::size_t)
+    {
+        EXPECT_EQ(caller, std::this_thread::get_id());
+    }, 1);
+}
+//------------------------------------------------------------------------------
+
+TEST(ThreadPoolTest, propagateAll)
+{
+    Node node = mirNode();
+
+    std::vector<Node> catalog;
+    for (int k = 0; k < 50; ++k)
+    {
+        Node satellite(node);
+        satellite.set_M(0.1 * k);
+        satellite.set_e(0.002 * k);
+        catalog.push_back(satellite);
+    }
+
+    std::vector<double> times;
+    for (int j = 0; j < 30; ++j)
+        times.push_back(node.preciseEpoch() + 97. * j);
+
+    std::vector<double> positions, velocities;
+    propagateAll(catalog, times, positions, &velocities, 3);
+    ASSERT_EQ(3 * catalog.size() * times.size(), positions.size());
+    ASSERT_EQ(positions.size(), velocities.size());
+
+    for (std::size_t k = 0; k < catalog.size(); ++k)
+    {
+        Propagator propagator(catalog[k]);
+        for (std::size_t j = 0; j < times.size(); ++j)
+        {
+            double r[3], v[3];
+            propagator.state(times[j], r, v);
+            std::size_t offset = 3 * (k * times.size() + j);
+            for (int c = 0; c < 3; ++c)
+            {
+                EXPECT_EQ(r[c], positions[offset + c]);
+                EXPECT_EQ(v[c], velocities[offset + c]);
+            }
+        }
+    }
+
+    // The same result with the shared pool
+    std::vector<double> shared;
+    propagateAll(catalog, times, shared);
+    EXPECT_TRUE(shared == positions);
+
+    std::vector<double> n(catalog.size(), 0);
+    forEachSatellite(catalog, [&](std::size_t k, const Node &satellite)
+    {
+        n[k] = satellite.n();
+    }, 3);
+    for (std::size_t k = 0; k < catalog.size(); ++k)
+        EXPECT_EQ(catalog[k].n(), n[k]);
+}
+//------------------------------------------------------------------------------